@@ -0,0 +1,169 @@
+#include "BitmapIndex.h"
+
+	// CONSTRUCTORS
+BitmapIndex::BitmapIndex () {}
+
+
+	// MODIFICATION METHODS
+long long BitmapIndex::build (const string& dataFilename, const string& filename, NewPostalCodeBuffer* reader) {
+	ifstream infile (dataFilename.c_str (), ios::binary);
+	PostalCodeHeader header;
+	NewPostalCodeBuffer local;
+	NewPostalCodeBuffer& buffer = reader != NULL ? *reader : local;
+
+	addresses.clear ();
+	states.clear ();
+	counties.clear ();
+
+	if (!infile.is_open () or header.readHeader (infile) == -1)
+		return -1;
+
+	// Validates the header against itself to place the read pointer at the first record
+	if (buffer.readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1)
+		return -1;
+
+	// Records are numbered in file order, so every bitmap is filled in increasing order
+	long long recaddr;
+	while ((recaddr = buffer.read (infile)) != -1) {
+		int zip;
+		string_view city, state, county;
+
+		if (buffer.unpackInt (zip) == -1 or buffer.unpackView (city) == -1 or buffer.unpackView (state) == -1 or buffer.unpackView (county) == -1)
+			return -1;
+		if (state.size () > 255 or county.size () > 255)
+			return -1;
+
+		states[string (state)].add (addresses.size ());
+		counties[string (county)].add (addresses.size ());
+		addresses.push_back (recaddr);
+	}
+	infile.close ();
+
+	// Writes the index with a single write
+	string out = "PCBITMP1";
+	unsigned long long count = addresses.size ();
+	out.append ((const char*)&count, 8);
+	out.append ((const char*)addresses.data (), addresses.size () * 8);
+	writeBitmaps (states, out);
+	writeBitmaps (counties, out);
+
+	ofstream outfile (filename.c_str (), ios::binary | ios::trunc);
+	outfile.write (out.data (), out.size ());
+
+	if (outfile.good () == false)
+		return -1;
+
+	return addresses.size ();
+}
+
+bool BitmapIndex::open (const string& filename) {
+	ifstream infile (filename.c_str (), ios::binary);
+	string contents;
+
+	addresses.clear ();
+	states.clear ();
+	counties.clear ();
+
+	if (!infile.is_open ())
+		return false;
+
+	contents.assign (istreambuf_iterator<char> (infile), istreambuf_iterator<char> ());
+
+	const char* data = contents.data ();
+	const char* end = data + contents.size ();
+	unsigned long long count;
+
+	if (contents.size () < 16 or memcmp (data, "PCBITMP1", 8) != 0)
+		return false;
+	memcpy (&count, data + 8, 8);
+	data += 16;
+
+	if (count > (unsigned long long)(end - data) / 8)
+		return false;
+	addresses.resize (count);
+	memcpy (addresses.data (), data, count * 8);
+	data += count * 8;
+
+	if (readBitmaps (states, data, end) == false or readBitmaps (counties, data, end) == false or data != end) {
+		addresses.clear ();
+		states.clear ();
+		counties.clear ();
+		return false;
+	}
+
+	return true;
+}
+
+
+	// CONSTANT METHODS
+RoaringBitmap BitmapIndex::findStates (const vector<string>& values) const {
+	return findAny (states, values);
+}
+
+RoaringBitmap BitmapIndex::findCounties (const vector<string>& values) const {
+	return findAny (counties, values);
+}
+
+long long BitmapIndex::getRecordAddress (unsigned int record) const {
+	if (record >= addresses.size ())
+		return -1;
+
+	return addresses[record];
+}
+
+long long BitmapIndex::size () const {
+	return addresses.size ();
+}
+
+
+	// HELPER FUNCTIONS
+RoaringBitmap BitmapIndex::findAny (const map<string, RoaringBitmap>& bitmaps, const vector<string>& values) {
+	RoaringBitmap result;
+
+	for (size_t i = 0; i < values.size (); ++i) {
+		auto it = bitmaps.find (values[i]);
+
+		if (it != bitmaps.end ())
+			result = result.unionWith (it->second);
+	}
+
+	return result;
+}
+
+void BitmapIndex::writeBitmaps (const map<string, RoaringBitmap>& bitmaps, string& out) {
+	unsigned int count = bitmaps.size ();
+
+	out.append ((const char*)&count, 4);
+
+	for (auto it = bitmaps.begin (); it != bitmaps.end (); ++it) {
+		out += (char)it->first.size ();
+		out += it->first;
+		it->second.write (out);
+	}
+}
+
+bool BitmapIndex::readBitmaps (map<string, RoaringBitmap>& bitmaps, const char*& data, const char* end) {
+	unsigned int count;
+
+	if (end - data < 4)
+		return false;
+	memcpy (&count, data, 4);
+	data += 4;
+
+	for (unsigned int i = 0; i < count; ++i) {
+		if (end - data < 1)
+			return false;
+
+		size_t length = (unsigned char)*data;
+		if ((size_t)(end - data) < 1 + length)
+			return false;
+
+		string value (data + 1, length);
+		data += 1 + length;
+
+		if (bitmaps[value].read (data, end) == false)
+			return false;
+	}
+
+	return true;
+}
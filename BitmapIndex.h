@@ -0,0 +1,100 @@
+#ifndef BitmapIndex_
+#define BitmapIndex_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include "RoaringBitmap.h"
+#include "PostalCodeHeader.h"
+#include "NewPostalCodeBuffer.h"
+#include "PostalCode.h"
+
+using namespace std;
+
+/* Secondary indexes on the state and county of a DAT file
+Each record is numbered in file order, and each state and each county name has a RoaringBitmap of the numbers of its records
+A query ORs the bitmaps of the values it lists and ANDs the states with the counties, so only the matching records are read
+County names are indexed without their state, since the same county name is used in many states. ANDing with a state tells them apart
+The index file is laid out as:
+	"PCBITMP1" - 8 bytes
+	record count - 8 bytes
+	the offset of each record in the DAT file - 8 bytes each
+	the states and then the counties, each as a count (4 bytes) followed by each value's name length (1 byte), name and bitmap
+Numbers are stored in the machine's byte order, like the sizes in the DAT header
+*/
+
+/** Used to find the records of a DAT file by state and county
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class BitmapIndex {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an empty index */
+		BitmapIndex ();
+
+			// MODIFICATION METHODS
+		/** Scans a DAT file and writes the state and county indexes for it
+		 * @param dataFilename: the DAT file to index
+		 * @param filename: the index file to create
+		 * @param reader: the buffer used to read the DAT file. If NULL, a NewPostalCodeBuffer is used
+		 * @post: writes the index file and the index holds it
+		 * @return: returns the number of records indexed or -1 if an error occured */
+		long long build (const string& dataFilename, const string& filename, NewPostalCodeBuffer* reader = NULL);
+
+		/** Reads an index file
+		 * @param filename: the index file to read
+		 * @post: the index can be searched
+		 * @return: returns true if the file holds an index, otherwise false */
+		bool open (const string& filename);
+
+			// CONSTANT METHODS
+		/** Finds the records in any of a list of states
+		 * @param states: the states to find
+		 * @return: returns the numbers of the records */
+		RoaringBitmap findStates (const vector<string>& states) const;
+
+		/** Finds the records in any of a list of counties
+		 * @param counties: the county names to find
+		 * @return: returns the numbers of the records */
+		RoaringBitmap findCounties (const vector<string>& counties) const;
+
+		/** Gets the offset of a record
+		 * @param record: the record's number
+		 * @return: returns the offset of the record in the DAT file or -1 if there's no such record */
+		long long getRecordAddress (unsigned int record) const;
+
+		/** Gets the number of indexed records
+		 * @return: returns the number of records */
+		long long size () const;
+
+	private:
+		/** ORs the bitmaps of a list of values
+		 * @param bitmaps: the bitmap of each value
+		 * @param values: the values to find
+		 * @return: returns the union of the values' bitmaps */
+		static RoaringBitmap findAny (const map<string, RoaringBitmap>& bitmaps, const vector<string>& values);
+
+		/** Writes the bitmap of each value
+		 * @param bitmaps: the bitmap of each value
+		 * @param out: the string the bitmaps will be appended to */
+		static void writeBitmaps (const map<string, RoaringBitmap>& bitmaps, string& out);
+
+		/** Reads the bitmaps written by writeBitmaps
+		 * @param bitmaps: the map that will receive the bitmap of each value
+		 * @param data: the first byte to read. It's moved past the bitmaps
+		 * @param end: the byte after the last byte that can be read
+		 * @return: returns true if the bitmaps were read, otherwise false */
+		static bool readBitmaps (map<string, RoaringBitmap>& bitmaps, const char*& data, const char* end);
+
+		vector<long long> addresses; //!< The offset of each record
+		map<string, RoaringBitmap> states; //!< The records of each state
+		map<string, RoaringBitmap> counties; //!< The records of each county name
+};
+
+#include "BitmapIndex.cpp"
+#endif
@@ -0,0 +1,135 @@
+#include "BlockCodec.h"
+
+size_t BlockCodec::compress (const char* data, size_t size, string& out) {
+	const unsigned char* src = (const unsigned char*)data;
+	size_t start = out.size ();
+	vector<int> table (1 << hashBits, -1); // The last position of each hashed 4-byte string
+	size_t anchor = 0; // The first literal that hasn't been written
+	size_t pos = 0;
+
+	while (size >= minMatch and pos + minMatch <= size) {
+		uint32_t word;
+		memcpy (&word, src + pos, 4);
+		uint32_t hash = (word * 2654435761u) >> (32 - hashBits);
+		int candidate = table[hash];
+		table[hash] = pos;
+
+		bool found = false;
+		if (candidate >= 0 and pos - candidate <= maxOffset) {
+			uint32_t previous;
+			memcpy (&previous, src + candidate, 4);
+			found = previous == word;
+		}
+
+		if (found == false) {
+			// Skips ahead faster through data that isn't matching
+			pos += 1 + ((pos - anchor) >> 6);
+			continue;
+		}
+
+		size_t length = minMatch;
+		while (pos + length < size and src[candidate + length] == src[pos + length])
+			length += 1;
+
+		// Writes the literals before the match and then the match
+		size_t literals = pos - anchor;
+		size_t extra = length - minMatch;
+		out += (char)((min (literals, (size_t)15) << 4) | min (extra, (size_t)15));
+		if (literals >= 15)
+			writeLength (literals - 15, out);
+		out.append (data + anchor, literals);
+
+		size_t offset = pos - candidate;
+		out += (char)offset;
+		out += (char)(offset >> 8);
+		if (extra >= 15)
+			writeLength (extra - 15, out);
+
+		pos += length;
+		anchor = pos;
+	}
+
+	// The rest of the block is written as literals
+	size_t literals = size - anchor;
+	out += (char)(min (literals, (size_t)15) << 4);
+	if (literals >= 15)
+		writeLength (literals - 15, out);
+	out.append (data + anchor, literals);
+
+	return out.size () - start;
+}
+
+bool BlockCodec::decompress (const char* data, size_t size, char* out, size_t rawSize) {
+	const unsigned char* in = (const unsigned char*)data;
+	const unsigned char* end = in + size;
+	size_t written = 0;
+
+	while (in < end) {
+		unsigned char token = *in++;
+
+		// Literals
+		size_t literals = token >> 4;
+		if (literals == 15 and readLength (in, end, literals) == false)
+			return false;
+		if (literals > (size_t)(end - in) or literals > rawSize - written)
+			return false;
+
+		memcpy (out + written, in, literals);
+		in += literals;
+		written += literals;
+
+		// The last sequence has no match
+		if (in == end)
+			break;
+
+		// Match
+		if (end - in < 2)
+			return false;
+		size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+
+		size_t length = token & 15;
+		if (length == 15 and readLength (in, end, length) == false)
+			return false;
+		length += minMatch;
+
+		if (offset == 0 or offset > written or length > rawSize - written)
+			return false;
+
+		// Copied a byte at a time, since the match can overlap the bytes it's writing
+		const char* from = out + written - offset;
+		if (offset >= length)
+			memcpy (out + written, from, length);
+		else {
+			for (size_t i = 0; i < length; ++i)
+				out[written + i] = from[i];
+		}
+		written += length;
+	}
+
+	return written == rawSize;
+}
+
+
+	// HELPER FUNCTIONS
+void BlockCodec::writeLength (size_t length, string& out) {
+	while (length >= 255) {
+		out += (char)255;
+		length -= 255;
+	}
+	out += (char)length;
+}
+
+bool BlockCodec::readLength (const unsigned char*& data, const unsigned char* end, size_t& length) {
+	unsigned char byte;
+
+	do {
+		if (data == end)
+			return false;
+
+		byte = *data++;
+		length += byte;
+	} while (byte == 255);
+
+	return true;
+}
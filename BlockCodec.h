@@ -0,0 +1,59 @@
+#ifndef BlockCodec_
+#define BlockCodec_
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A small LZ77 codec for the blocks of compressed DAT files
+// The compressed data is a list of sequences. Each sequence starts with a token byte: the top 4 bits are the number of literal bytes
+// and the bottom 4 bits are the match length minus 4. A value of 15 means more length bytes follow, each added to it until one is less than 255
+// The literals come next, then a 2-byte offset back into the output (least significant byte first) and any extra match length bytes
+// The last sequence only has literals, so the data ends right after them
+// Matches are found with a hash table of the last position each 4-byte string was seen at, so compression is a single pass
+
+/** Used to compress and decompress blocks of records
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class BlockCodec {
+	public:
+		/** Compresses a block
+		 * @param data: the bytes to compress
+		 * @param size: the number of bytes
+		 * @param out: the string the compressed bytes will be appended to
+		 * @return: returns the number of bytes appended */
+		static size_t compress (const char* data, size_t size, string& out);
+
+		/** Decompresses a block
+		 * @param data: the compressed bytes
+		 * @param size: the number of compressed bytes
+		 * @param out: the array that will receive the decompressed bytes
+		 * @param rawSize: the size of the decompressed block
+		 * @return: returns true if the block decompressed to exactly rawSize bytes, otherwise false */
+		static bool decompress (const char* data, size_t size, char* out, size_t rawSize);
+
+	private:
+		/** Appends the extra bytes of a length that didn't fit in its 4 bits
+		 * @param length: the length minus 15
+		 * @param out: the string the bytes are appended to */
+		static void writeLength (size_t length, string& out);
+
+		/** Reads the extra bytes of a length
+		 * @param data: the next compressed byte. It's moved past the length
+		 * @param end: the byte after the last compressed byte
+		 * @param length: the length, which the bytes are added to
+		 * @return: returns true if the length was read, otherwise false */
+		static bool readLength (const unsigned char*& data, const unsigned char* end, size_t& length);
+
+		static const int minMatch = 4; //!< The shortest match that's worth encoding
+		static const int hashBits = 14; //!< The size of the hash table
+		static const size_t maxOffset = 0xFFFF; //!< The farthest back a match can start
+};
+
+#include "BlockCodec.cpp"
+#endif
@@ -0,0 +1,504 @@
+#include "BlockPostalCodeBuffer.h"
+
+	// CONSTRUCTORS
+BlockPostalCodeBuffer::BlockPostalCodeBuffer (int mb) : NewPostalCodeBuffer (mb, true), footerStart (-1), cachedBlock (-1), nextBlock (0), nextSlot (0) {
+	// Blocks have no 16-bit limits, so compressed files are always version 2
+	setVersion (2);
+
+	blockHeader.setStructure ("BLOCK/BINARY");
+	blockHeader.setVersion (2);
+	blockHeader.setRecordSize (0);
+	blockHeader.setSizeFormat (1);
+	blockHeader.setFieldCount (fieldCount);
+	blockHeader.setFieldInfo ({
+		"zipCode/DELTA/VARINT",
+		"city/LENGTH/1",
+		"state/DICT/VARINT",
+		"county/DICT/VARINT",
+		"lat/DELTA/VARINT",
+		"lng/DELTA/VARINT"
+	});
+	blockHeader.setPrimaryKey ("zipCode");
+}
+
+
+	// MODIFICATION METHODS
+int BlockPostalCodeBuffer::readHeader (istream& file, const string& indexFilename, const string& indexSchema) {
+	PostalCodeHeader fileHeader;
+
+	blocks.clear ();
+	states.clear ();
+	counties.clear ();
+	footerStart = -1;
+	cachedBlock = -1;
+	nextBlock = 0;
+	nextSlot = 0;
+	checksums.clear ();
+	resyncs = 0;
+	clear ();
+
+	supported = fileHeader.readHeader (file) != -1 and fileHeader.isSupported () and fileHeader.getStructure () == "BLOCK/BINARY";
+	if (supported == false)
+		return -1;
+
+	// The block directory is in the footer, so it's read before any blocks
+	long long dataStart = file.tellg ();
+	file.seekg (0, ios::end);
+	long long fileSize = file.tellg ();
+	bool found = readFooter (file, dataStart, fileSize);
+
+	// Prepares the header manager for validating the header
+	blockHeader.setIndexFilename (indexFilename);
+	blockHeader.setIndexSchema (indexSchema);
+
+	file.clear ();
+	int result = blockHeader.validateHeader (file);
+
+	if (found == false) {
+		blocks.clear ();
+		states.clear ();
+		counties.clear ();
+		return -1;
+	}
+
+	// Lists the blocks' checksums the same way as an uncompressed file's, so they're verified the same way
+	for (size_t i = 0; i < blocks.size (); ++i)
+		checksums.add (blocks[i].offset, blocks[i].records, blocks[i].checksum);
+	checksums.setDataEnd (footerStart);
+
+	return result;
+}
+
+int BlockPostalCodeBuffer::writeHeader (ostream& file, unsigned long long recordCount, const string& indexFilename, const string& indexSchema) {
+	blockHeader.setRecordCount (recordCount);
+	blockHeader.setIndexFilename (indexFilename);
+	blockHeader.setIndexSchema (indexSchema);
+
+	return blockHeader.writeHeader (file);
+}
+
+long long BlockPostalCodeBuffer::read (istream& file) {
+	// Moves to the next block that has records, decompressing it
+	while (true) {
+		if (nextBlock >= (int)blocks.size ()) {
+			clear ();
+			return -1;
+		}
+
+		// A damaged block is skipped, so it only costs its own records
+		if (cachedBlock != nextBlock and loadBlock (file, nextBlock) == false) {
+			resyncs += 1;
+			nextBlock += 1;
+			nextSlot = 0;
+			continue;
+		}
+
+		if (nextSlot < cache.size ())
+			break;
+
+		nextBlock += 1;
+		nextSlot = 0;
+	}
+
+	select (cache, nextSlot);
+	nextSlot += 1;
+
+	return cache.getAddress (nextSlot - 1);
+}
+
+int BlockPostalCodeBuffer::readBatch (istream& file, PostalCodeBatch& batch, int n) {
+	batch.clear ();
+
+	// Copies whole runs of decoded records, reading one record at a time only to move to the next block
+	while (batch.size () < n and read (file) != -1) {
+		int first = nextSlot - 1;
+		int last = min (cache.size (), first + n - batch.size ());
+
+		for (int i = first; i < last; ++i) {
+			string_view rec = cache.getRecord (i);
+			batch.add (rec.data (), rec.size (), cache.getAddress (i));
+		}
+		nextSlot = last;
+	}
+
+	return batch.size ();
+}
+
+long long BlockPostalCodeBuffer::dRead (istream& file, long long fileIndex) {
+	int block = fileIndex >> 16;
+	int slot = fileIndex & 0xFFFF;
+
+	if (fileIndex < 0 or block >= (int)blocks.size () or slot >= (int)blocks[block].records)
+		return -1;
+
+	// read would move on to the next block if this one is damaged
+	if (cachedBlock != block and loadBlock (file, block) == false)
+		return -1;
+
+	nextBlock = block;
+	nextSlot = slot;
+
+	return read (file);
+}
+
+bool BlockPostalCodeBuffer::seekBlock (int block) {
+	if (block < 0 or block > (int)blocks.size ())
+		return false;
+
+	nextBlock = block;
+	nextSlot = 0;
+
+	return true;
+}
+
+int BlockPostalCodeBuffer::getBlockCount () const {
+	return blocks.size ();
+}
+
+
+	// WRITING
+bool BlockPostalCodeBuffer::canEncode (const PostalCode& pc) {
+	return pc.getCity ().size () <= (size_t)maxStringSize and pc.getState ().size () <= (size_t)maxStringSize
+		and pc.getCounty ().size () <= (size_t)maxStringSize and pc.getLat () >= -180 and pc.getLat () <= 180
+		and pc.getLong () >= -180 and pc.getLong () <= 180;
+}
+
+int BlockPostalCodeBuffer::decodedSize (const PostalCode& pc) {
+	return 3 * intSize + 3 + pc.getCity ().size () + pc.getState ().size () + pc.getCounty ().size ();
+}
+
+void BlockPostalCodeBuffer::addToDictionaries (const PostalCode& pc, unsigned int& stateId, unsigned int& countyId) {
+	auto state = stateIds.emplace (pc.getState (), states.size ());
+	if (state.second)
+		states.push_back (string (pc.getState ()));
+	stateId = state.first->second;
+
+	auto county = countyIds.emplace (pc.getCounty (), counties.size ());
+	if (county.second)
+		counties.push_back (string (pc.getCounty ()));
+	countyId = county.first->second;
+}
+
+size_t BlockPostalCodeBuffer::encodeBlock (const vector<PostalCode>& pcs, size_t begin, size_t end, const vector<unsigned int>& stateIds, const vector<unsigned int>& countyIds, string& out) {
+	string columns;
+	size_t start = out.size ();
+
+	writeVarint (end - begin, columns);
+
+	// Sorted zip codes and nearby coordinates have small differences, which take one or two bytes as zigzag varints
+	uint32_t previous = 0;
+	for (size_t i = begin; i < end; ++i) {
+		int32_t delta = (uint32_t)pcs[i].getZipCode () - previous;
+		writeVarint (((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31), columns);
+		previous = pcs[i].getZipCode ();
+	}
+
+	for (size_t i = begin; i < end; ++i)
+		writeVarint (stateIds[i], columns);
+	for (size_t i = begin; i < end; ++i)
+		writeVarint (countyIds[i], columns);
+
+	for (int coordinate = 0; coordinate < 2; ++coordinate) {
+		previous = 0;
+		for (size_t i = begin; i < end; ++i) {
+			uint32_t micro = (int32_t)llround ((coordinate == 0 ? pcs[i].getLat () : pcs[i].getLong ()) * 1000000);
+			int32_t delta = micro - previous;
+			writeVarint (((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31), columns);
+			previous = micro;
+		}
+	}
+
+	for (size_t i = begin; i < end; ++i) {
+		string_view city = pcs[i].getCity ();
+		columns += (char)city.size ();
+		columns.append (city.data (), city.size ());
+	}
+
+	// Blocks that don't get smaller are stored as they are
+	string packed;
+	BlockCodec::compress (columns.data (), columns.size (), packed);
+	char codec = packed.size () < columns.size () ? 1 : 0;
+	const string& payload = codec == 1 ? packed : columns;
+
+	uint32_t storedSize = payload.size ();
+	uint32_t rawSize = columns.size ();
+	out.append ((const char*)&storedSize, 4);
+	out.append ((const char*)&rawSize, 4);
+	out += codec;
+	out += payload;
+
+	return out.size () - start;
+}
+
+long long BlockPostalCodeBuffer::writeBlock (ostream& file, const string& block, unsigned int records, int firstZip) {
+	long long offset = file.tellp ();
+
+	file.write (block.data (), block.size ());
+	if (file.good () == false)
+		return -1;
+
+	blocks.push_back ({offset, records, firstZip, crc32c (block.data (), block.size ())});
+
+	return offset;
+}
+
+int BlockPostalCodeBuffer::writeFooter (ostream& file) {
+	long long start = file.tellp ();
+	string footer = "PCBLKDIR";
+	uint32_t count = blocks.size ();
+
+	footer.append ((const char*)&count, 4);
+	for (size_t i = 0; i < blocks.size (); ++i) {
+		footer.append ((const char*)&blocks[i].offset, 8);
+		footer.append ((const char*)&blocks[i].records, 4);
+		footer.append ((const char*)&blocks[i].firstZip, 4);
+		footer.append ((const char*)&blocks[i].checksum, 4);
+	}
+
+	const vector<string>* dictionaries[] = {&states, &counties};
+	for (int d = 0; d < 2; ++d) {
+		count = dictionaries[d]->size ();
+		footer.append ((const char*)&count, 4);
+
+		for (size_t i = 0; i < dictionaries[d]->size (); ++i) {
+			footer += (char)(*dictionaries[d])[i].size ();
+			footer += (*dictionaries[d])[i];
+		}
+	}
+
+	uint32_t checksum = crc32c (footer.data (), footer.size ());
+	footer.append ((const char*)&checksum, 4);
+	footer.append ((const char*)&start, 8);
+	footer += "PCBLKEND";
+
+	file.write (footer.data (), footer.size ());
+	footerStart = start;
+
+	return file.good () ? (int)footer.size () : -1;
+}
+
+
+	// HELPER FUNCTIONS
+bool BlockPostalCodeBuffer::loadBlock (istream& file, int block) {
+	long long end = block + 1 < (int)blocks.size () ? blocks[block + 1].offset : footerStart;
+	long long available = end - blocks[block].offset;
+	char header[blockHeaderSize];
+
+	cachedBlock = -1;
+	cache.clear ();
+
+	if (available < blockHeaderSize)
+		return false;
+
+	file.clear ();
+	file.seekg (blocks[block].offset, ios::beg);
+	file.read (header, blockHeaderSize);
+	uint32_t checksum = crc32c (header, blockHeaderSize);
+
+	uint32_t storedSize, rawSize;
+	memcpy (&storedSize, header, 4);
+	memcpy (&rawSize, header + 4, 4);
+	char codec = header[8];
+
+	// The block has to fill the space up to the next block exactly
+	if (file.good () == false or storedSize != available - blockHeaderSize or rawSize > maxRawSize)
+		return false;
+
+	compressed.resize (storedSize);
+	file.read (&compressed[0], storedSize);
+	if ((uint32_t)file.gcount () != storedSize or crc32c (compressed.data (), storedSize, checksum) != blocks[block].checksum)
+		return false;
+	STATS_COUNT (statsBytesRead, blockHeaderSize + storedSize);
+
+	if (codec == 0) {
+		if (rawSize != storedSize)
+			return false;
+		raw.swap (compressed);
+	}
+	else if (codec == 1) {
+		raw.resize (rawSize);
+		if (BlockCodec::decompress (compressed.data (), compressed.size (), &raw[0], rawSize) == false)
+			return false;
+	}
+	else
+		return false;
+
+	if (decodeBlock (raw.data (), rawSize, block) == false) {
+		cache.clear ();
+		return false;
+	}
+
+	cachedBlock = block;
+
+	return true;
+}
+
+bool BlockPostalCodeBuffer::decodeBlock (const char* data, size_t size, int block) {
+	const char* end = data + size;
+	unsigned int count;
+
+	if (readVarint (data, end, count) == false or count != blocks[block].records or count > (unsigned int)maxBlockRecords)
+		return false;
+
+	vector<int32_t> zips (count), lats (count), lngs (count);
+	vector<unsigned int> stateIndex (count), countyIndex (count);
+	vector<string_view> cities (count);
+	unsigned int value;
+
+	uint32_t previous = 0;
+	for (unsigned int i = 0; i < count; ++i) {
+		if (readVarint (data, end, value) == false)
+			return false;
+		previous += (value >> 1) ^ -(value & 1);
+		zips[i] = previous;
+	}
+
+	for (unsigned int i = 0; i < count; ++i) {
+		if (readVarint (data, end, stateIndex[i]) == false or stateIndex[i] >= states.size ())
+			return false;
+	}
+	for (unsigned int i = 0; i < count; ++i) {
+		if (readVarint (data, end, countyIndex[i]) == false or countyIndex[i] >= counties.size ())
+			return false;
+	}
+
+	vector<int32_t>* coordinates[] = {&lats, &lngs};
+	for (int c = 0; c < 2; ++c) {
+		previous = 0;
+		for (unsigned int i = 0; i < count; ++i) {
+			if (readVarint (data, end, value) == false)
+				return false;
+			previous += (value >> 1) ^ -(value & 1);
+			(*coordinates[c])[i] = previous;
+		}
+	}
+
+	for (unsigned int i = 0; i < count; ++i) {
+		if (data == end or (size_t)(end - data) < 1 + (size_t)(unsigned char)*data)
+			return false;
+		cities[i] = string_view (data + 1, (unsigned char)*data);
+		data += 1 + cities[i].size ();
+	}
+
+	if (data != end)
+		return false;
+
+	// Writes each record the way a LENGTH/BINARY file stores it
+	for (unsigned int i = 0; i < count; ++i) {
+		const string& state = states[stateIndex[i]];
+		const string& county = counties[countyIndex[i]];
+		size_t recordSize = 3 * intSize + 3 + cities[i].size () + state.size () + county.size ();
+		size_t offset = cache.arenaSize ();
+		char* out = cache.extend (recordSize);
+
+		memcpy (out, &zips[i], intSize);
+		out += intSize;
+		*out++ = (char)cities[i].size ();
+		memcpy (out, cities[i].data (), cities[i].size ());
+		out += cities[i].size ();
+		*out++ = (char)state.size ();
+		memcpy (out, state.data (), state.size ());
+		out += state.size ();
+		*out++ = (char)county.size ();
+		memcpy (out, county.data (), county.size ());
+		out += county.size ();
+		memcpy (out, &lats[i], intSize);
+		memcpy (out + intSize, &lngs[i], intSize);
+
+		cache.addStored (offset, recordSize, ((long long)block << 16) | i);
+	}
+
+	return true;
+}
+
+void BlockPostalCodeBuffer::writeVarint (unsigned int value, string& out) {
+	char bytes[maxLengthSize];
+
+	out.append (bytes, encodeLength (value, bytes, 2));
+}
+
+bool BlockPostalCodeBuffer::readVarint (const char*& data, const char* end, unsigned int& value) {
+	int size = decodeLength (data, end - data, value, 2);
+
+	if (size == -1)
+		return false;
+
+	data += size;
+
+	return true;
+}
+
+bool BlockPostalCodeBuffer::readFooter (istream& file, long long dataStart, long long fileSize) {
+	char trailer[trailerSize];
+	long long start;
+
+	if (dataStart < 0 or fileSize < dataStart + trailerSize)
+		return false;
+
+	file.clear ();
+	file.seekg (fileSize - trailerSize, ios::beg);
+	file.read (trailer, trailerSize);
+	memcpy (&start, trailer, 8);
+
+	if (file.good () == false or memcmp (trailer + 8, "PCBLKEND", 8) != 0 or start < dataStart or start > fileSize - trailerSize)
+		return false;
+
+	// Reads the whole footer with one read
+	string footer (fileSize - trailerSize - start, 0);
+	file.seekg (start, ios::beg);
+	file.read (&footer[0], footer.size ());
+	if ((size_t)file.gcount () != footer.size ())
+		return false;
+
+	const char* data = footer.data ();
+	const char* end = data + footer.size () - 4;
+	uint32_t count, checksum;
+
+	// The footer ends with its own checksum
+	if (footer.size () < 16 or memcmp (data, "PCBLKDIR", 8) != 0)
+		return false;
+	memcpy (&checksum, end, 4);
+	if (crc32c (data, end - data) != checksum)
+		return false;
+	memcpy (&count, data + 8, 4);
+	data += 12;
+
+	// Blocks are listed in file order, between the header and the footer
+	if (count > (size_t)(end - data) / entrySize)
+		return false;
+	for (uint32_t i = 0; i < count; ++i) {
+		BlockEntry entry;
+		memcpy (&entry.offset, data, 8);
+		memcpy (&entry.records, data + 8, 4);
+		memcpy (&entry.firstZip, data + 12, 4);
+		memcpy (&entry.checksum, data + 16, 4);
+		data += entrySize;
+
+		long long previous = blocks.empty () ? dataStart - 1 : blocks.back ().offset;
+		if (entry.offset <= previous or entry.offset >= start or entry.records > (unsigned int)maxBlockRecords)
+			return false;
+		blocks.push_back (entry);
+	}
+
+	vector<string>* dictionaries[] = {&states, &counties};
+	for (int d = 0; d < 2; ++d) {
+		if (end - data < 4)
+			return false;
+		memcpy (&count, data, 4);
+		data += 4;
+
+		for (uint32_t i = 0; i < count; ++i) {
+			if (data == end or (size_t)(end - data) < 1 + (size_t)(unsigned char)*data)
+				return false;
+			dictionaries[d]->push_back (string (data + 1, (unsigned char)*data));
+			data += 1 + (unsigned char)*data;
+		}
+	}
+
+	if (data != end)
+		return false;
+
+	footerStart = start;
+
+	return true;
+}
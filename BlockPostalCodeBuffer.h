@@ -0,0 +1,203 @@
+#ifndef BlockPostalCodeBuffer_
+#define BlockPostalCodeBuffer_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cmath>
+#include "NewPostalCodeBuffer.h"
+#include "PostalCodeHeader.h"
+#include "PostalCodeBatch.h"
+#include "BlockCodec.h"
+#include "Crc32c.h"
+#include "PostalCode.h"
+
+using namespace std;
+
+// Used as a file buffer for compressed DAT files (structure BLOCK/BINARY, always version 2)
+// The records are grouped into blocks of about 64 KiB before compression. Within a block each field is stored as a column:
+//	zip codes, latitudes and longitudes - the difference from the previous record as a zigzag varint, in millionths of a degree for coordinates
+//	states and counties - a varint number in a dictionary of every state or county name in the file
+//	cities - a 1-byte length and the name
+// The columns are then compressed with BlockCodec. Each block starts with its compressed size (4 bytes), its decompressed size (4 bytes)
+// and its codec (1 byte: 0 = stored, 1 = BlockCodec)
+// A footer after the last block lists where each block starts, its record count, its first zip code and its CRC-32C checksum, followed by
+// the state and county dictionaries and the checksum of the footer. The file ends with the position of the footer (8 bytes) and "PCBLKEND",
+// so readers find the footer without reading the blocks
+// A block whose checksum doesn't match is skipped, so damage only costs the records of the blocks it touches
+// A block is decoded into ordinary LENGTH/BINARY records, so the fields are unpacked the same way as a binary file
+// A record's address is its block number times 65536 plus its position in the block, and dRead only decompresses the block it's in
+
+/** Used to read and write compressed DAT postal code files
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class BlockPostalCodeBuffer : public NewPostalCodeBuffer {
+	public:
+			// CONSTRUCTORS
+		/** Constructor with default parameters
+		 * @param mb: the maximum number of bytes the buffer will be able to hold
+		 * @post: creates a buffer with no blocks */
+		BlockPostalCodeBuffer (int mb = 1000);
+
+		/** Reads the file header and the block directory in the footer
+		 * @param file: the file to read data from
+		 * @param indexFilename: The name of the index file, which should match the one listed in the header
+		 * @param indexSchema: The file storage scheme used by the index, which should match the one listed in the header
+		 * @post: the next read returns the first record of the first block, even if the header didn't match
+		 * @return: returns the size of the header or -1 if an error occured */
+		int readHeader (istream& file, const string& indexFilename, const string& indexSchema);
+
+		/** Writes the file header
+		 * @param file: the file to write data to
+		 * @param recordCount: the number of records that will be written to the file
+		 * @param indexFilename: The name of the associated index file
+		 * @param indexSchema: The file storage scheme that will be used by the associated index
+		 * @post: sets the put pointer to the character after the header
+		 * @return: returns the size of the header or -1 if an error occured */
+		int writeHeader (ostream& file, unsigned long long recordCount, const string& indexFilename, const string& indexSchema);
+
+		/** Reads the next record, decompressing the next block when the current one runs out
+		 * @param file: the file to read data from
+		 * @post: packs the buffer with the record. Blocks that are damaged are skipped
+		 * @return: returns the address of the record or -1 if there are no more records */
+		long long read (istream& file);
+
+		/** Reads several records into a batch
+		 * @param file: the file to read data from
+		 * @param batch: the batch the records will be stored in
+		 * @param n: the largest number of records to read
+		 * @post: the batch holds the records and the next read returns the record after them
+		 * @return: returns the number of records read, which is 0 once the last block is finished */
+		int readBatch (istream& file, PostalCodeBatch& batch, int n);
+
+		/** Reads the record at an address, decompressing its block unless it's the block that was read last
+		 * @param file: the file to read data from
+		 * @param fileIndex: the address of the record, as returned by read
+		 * @post: packs the buffer with the record and the next read returns the record after it
+		 * @return: returns the address of the record or -1 if there's no such record or its block is damaged */
+		long long dRead (istream& file, long long fileIndex);
+
+		/** Moves to the start of a block
+		 * @param block: the number of the block
+		 * @post: the next read returns the first record of the block
+		 * @return: returns true if the block exists, otherwise false */
+		bool seekBlock (int block);
+
+		/** Gets the number of blocks
+		 * @return: returns the number of blocks listed in the footer */
+		int getBlockCount () const;
+
+			// WRITING
+		/** Determines if a postal code can be stored in a block
+		 * @param pc: the postal code
+		 * @return: returns true if its strings fit in a 1-byte length and its coordinates are within +-180 degrees */
+		static bool canEncode (const PostalCode& pc);
+
+		/** Gets the size of a postal code once it's decoded, which is used to fill blocks to the block size
+		 * @param pc: the postal code
+		 * @return: returns the size of its binary record */
+		static int decodedSize (const PostalCode& pc);
+
+		/** Finds the dictionary numbers of a postal code's state and county, adding them to the dictionaries if they're new
+		 * @param pc: the postal code
+		 * @param stateId: set to the number of the state
+		 * @param countyId: set to the number of the county
+		 * @post: the dictionaries written by writeFooter include the state and county */
+		void addToDictionaries (const PostalCode& pc, unsigned int& stateId, unsigned int& countyId);
+
+		/** Encodes and compresses a block
+		 * @param pcs: the postal codes
+		 * @param begin: the first postal code of the block
+		 * @param end: the postal code after the last one of the block
+		 * @param stateIds: the dictionary number of each postal code's state, from addToDictionaries
+		 * @param countyIds: the dictionary number of each postal code's county, from addToDictionaries
+		 * @param out: the string the block will be appended to
+		 * @pre: every postal code can be encoded and there are at most maxBlockRecords of them
+		 * @return: returns the size of the block */
+		static size_t encodeBlock (const vector<PostalCode>& pcs, size_t begin, size_t end, const vector<unsigned int>& stateIds, const vector<unsigned int>& countyIds, string& out);
+
+		/** Writes a block made by encodeBlock and adds it to the block directory
+		 * @param file: the file to write data to
+		 * @param block: the encoded block
+		 * @param records: the number of records in the block
+		 * @param firstZip: the zip code of the first record in the block
+		 * @return: returns the position of the block or -1 if an error occured */
+		long long writeBlock (ostream& file, const string& block, unsigned int records, int firstZip);
+
+		/** Writes the block directory and dictionaries after the last block
+		 * @param file: the file to write data to
+		 * @return: returns the size of the footer or -1 if an error occured */
+		int writeFooter (ostream& file);
+
+		static const int maxBlockRecords = 0xFFFF; //!< The most records a block can hold, so its positions fit in 16 bits
+		static const int defaultBlockSize = 1 << 16; //!< The decoded size blocks are filled to
+
+	private:
+		/** Reads and decodes a block into the cache
+		 * @param file: the file to read data from
+		 * @param block: the number of the block
+		 * @return: returns true if the block matched its checksum and was decoded, otherwise false */
+		bool loadBlock (istream& file, int block);
+
+		/** Turns the columns of a decompressed block into binary records
+		 * @param raw: the decompressed block
+		 * @param size: the size of the decompressed block
+		 * @param block: the number of the block, which the addresses of the records are made from
+		 * @return: returns true if the block was valid, otherwise false */
+		bool decodeBlock (const char* raw, size_t size, int block);
+
+		/** Appends a varint
+		 * @param value: the number
+		 * @param out: the string the varint is appended to */
+		static void writeVarint (unsigned int value, string& out);
+
+		/** Reads a varint
+		 * @param data: the first byte of the varint. It's moved past the varint
+		 * @param end: the byte after the last byte that can be read
+		 * @param value: set to the number
+		 * @return: returns true if the varint was read, otherwise false */
+		static bool readVarint (const char*& data, const char* end, unsigned int& value);
+
+		/** Reads the footer at the end of the file
+		 * @param file: the file to read data from
+		 * @param dataStart: the position of the first block
+		 * @param fileSize: the size of the file
+		 * @post: sets the block directory, the dictionaries and footerStart
+		 * @return: returns true if the footer was read, otherwise false */
+		bool readFooter (istream& file, long long dataStart, long long fileSize);
+
+		/** The position and contents of a block */
+		struct BlockEntry {
+			long long offset; //!< The position of the block in the file
+			unsigned int records; //!< The number of records in the block
+			int firstZip; //!< The zip code of the first record
+			uint32_t checksum; //!< The CRC-32C of the whole block, from its compressed size to the end of its payload
+		};
+
+		static const int blockHeaderSize = 9; //!< The compressed size, decompressed size and codec at the start of each block
+		static const int entrySize = 20; //!< The size of each block in the block directory
+		static const int trailerSize = 16; //!< The footer position and "PCBLKEND" at the end of the file
+		static const unsigned int maxRawSize = 1 << 24; //!< The largest decompressed block a reader will accept
+
+		PostalCodeHeader blockHeader; //!< Describes the compressed layout
+		vector<BlockEntry> blocks; //!< The block directory
+		long long footerStart; //!< The position after the last block
+		vector<string> states; //!< The state dictionary
+		vector<string> counties; //!< The county dictionary
+		unordered_map<string_view, unsigned int> stateIds; //!< The dictionary number of each state while writing, keyed by views into the global string pool, which never move
+		unordered_map<string_view, unsigned int> countyIds; //!< The dictionary number of each county while writing, keyed the same way
+		PostalCodeBatch cache; //!< The decoded records of the last block that was read
+		int cachedBlock; //!< The block held in the cache, or -1
+		int nextBlock; //!< The block of the next record read will return
+		int nextSlot; //!< The position of the next record read will return within its block
+		string compressed; //!< The compressed bytes of the block being read
+		string raw; //!< The decompressed bytes of the block being read
+};
+
+#include "BlockPostalCodeBuffer.cpp"
+#endif
@@ -0,0 +1,196 @@
+#include "BufferPool.h"
+
+	// CONSTRUCTORS
+BufferPool::BufferPool (int ps, int fc) : pageSize (ps), memory ((size_t)ps * fc), frames (fc), pageCount (0), reads (0), writes (0) {
+	for (int f = fc - 1; f >= 0; --f)
+		freeFrames.push_back (f);
+}
+
+BufferPool::~BufferPool () {
+	close ();
+}
+
+
+	// MODIFICATION METHODS
+bool BufferPool::open (const string& filename, bool create) {
+	close ();
+
+	ios::openmode mode = ios::in | ios::out | ios::binary;
+	if (create)
+		mode |= ios::trunc;
+
+	file.open (filename.c_str (), mode);
+	if (!file.is_open ())
+		return false;
+
+	file.seekg (0, ios::end);
+	long long size = file.tellg ();
+	if (size < 0 or size % pageSize != 0) {
+		file.close ();
+		return false;
+	}
+
+	pageCount = size / pageSize;
+	reads = writes = 0;
+
+	return true;
+}
+
+bool BufferPool::close () {
+	bool success = flush ();
+
+	if (file.is_open ())
+		file.close ();
+
+	pageTable.clear ();
+	recentlyUsed.clear ();
+	freeFrames.clear ();
+	for (int f = frames.size () - 1; f >= 0; --f)
+		freeFrames.push_back (f);
+	pageCount = 0;
+
+	return success;
+}
+
+char* BufferPool::pin (unsigned int page) {
+	auto it = pageTable.find (page);
+
+	// Pages already in the pool are moved to the front of the recently used list
+	if (it != pageTable.end ()) {
+		Frame& frame = frames[it->second];
+		recentlyUsed.splice (recentlyUsed.begin (), recentlyUsed, frame.used);
+		frame.pins += 1;
+
+		return frameData (it->second);
+	}
+
+	if (page >= pageCount or file.is_open () == false)
+		return NULL;
+
+	int f = takeFrame ();
+	if (f == -1)
+		return NULL;
+
+	file.clear ();
+	file.seekg ((long long)page * pageSize);
+	file.read (frameData (f), pageSize);
+	if (file.gcount () != pageSize) {
+		freeFrames.push_back (f);
+		return NULL;
+	}
+	reads += 1;
+
+	recentlyUsed.push_front (f);
+	frames[f] = {page, 1, false, recentlyUsed.begin ()};
+	pageTable[page] = f;
+
+	return frameData (f);
+}
+
+char* BufferPool::allocate (unsigned int& page) {
+	if (file.is_open () == false)
+		return NULL;
+
+	int f = takeFrame ();
+	if (f == -1)
+		return NULL;
+
+	page = pageCount++;
+	memset (frameData (f), 0, pageSize);
+
+	// Marked as changed so the page reaches the file even if nothing is written to it
+	recentlyUsed.push_front (f);
+	frames[f] = {page, 1, true, recentlyUsed.begin ()};
+	pageTable[page] = f;
+
+	return frameData (f);
+}
+
+void BufferPool::unpin (unsigned int page, bool dirty) {
+	auto it = pageTable.find (page);
+
+	if (it == pageTable.end () or frames[it->second].pins == 0)
+		return;
+
+	frames[it->second].pins -= 1;
+	frames[it->second].dirty = frames[it->second].dirty or dirty;
+}
+
+bool BufferPool::flush () {
+	bool success = true;
+
+	for (auto it = pageTable.begin (); it != pageTable.end (); ++it) {
+		if (frames[it->second].dirty)
+			success = writeFrame (it->second) and success;
+	}
+
+	if (file.is_open ())
+		file.flush ();
+
+	return success;
+}
+
+
+	// CONSTANT METHODS
+int BufferPool::getPageSize () const {
+	return pageSize;
+}
+
+unsigned int BufferPool::getPageCount () const {
+	return pageCount;
+}
+
+long long BufferPool::getReads () const {
+	return reads;
+}
+
+long long BufferPool::getWrites () const {
+	return writes;
+}
+
+
+	// HELPER FUNCTIONS
+int BufferPool::takeFrame () {
+	if (freeFrames.empty () == false) {
+		int f = freeFrames.back ();
+		freeFrames.pop_back ();
+
+		return f;
+	}
+
+	// Evicts the least recently used page that isn't pinned
+	for (auto it = recentlyUsed.rbegin (); it != recentlyUsed.rend (); ++it) {
+		int f = *it;
+
+		if (frames[f].pins > 0)
+			continue;
+
+		if (frames[f].dirty and writeFrame (f) == false)
+			return -1;
+
+		pageTable.erase (frames[f].page);
+		recentlyUsed.erase (frames[f].used);
+
+		return f;
+	}
+
+	return -1;
+}
+
+bool BufferPool::writeFrame (int frame) {
+	file.clear ();
+	file.seekp ((long long)frames[frame].page * pageSize);
+	file.write (frameData (frame), pageSize);
+
+	if (file.good () == false)
+		return false;
+
+	frames[frame].dirty = false;
+	writes += 1;
+
+	return true;
+}
+
+char* BufferPool::frameData (int frame) {
+	return &memory[(size_t)frame * pageSize];
+}
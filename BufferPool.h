@@ -0,0 +1,127 @@
+#ifndef BufferPool_
+#define BufferPool_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+
+using namespace std;
+
+// Caches the fixed-size pages of a file in a fixed number of frames
+// A page is pinned while it's being used and can't be evicted until it's unpinned. When a frame is needed and none are free,
+// the least recently used unpinned page is evicted, and it's written back first if it was changed
+// Only pages that aren't in the pool are read from the file, so the read count is the number of page reads a search really cost
+
+/** Used to read and write the pages of a disk-resident index through a small amount of memory
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class BufferPool {
+	public:
+			// CONSTRUCTORS
+		/** Constructor with default parameters
+		 * @param ps: the size of each page in bytes
+		 * @param fc: the number of frames, which is the most pages that can be held at once
+		 * @post: creates a pool that isn't attached to a file */
+		BufferPool (int ps = 4096, int fc = 64);
+
+		/** Destructor
+		 * @post: writes any changed pages and closes the file */
+		~BufferPool ();
+
+		BufferPool (const BufferPool&) = delete;
+		BufferPool& operator = (const BufferPool&) = delete;
+
+			// MODIFICATION METHODS
+		/** Attaches the pool to a file
+		 * @param filename: the name of the file
+		 * @param create: whether to create an empty file, replacing any file with the same name
+		 * @post: the pages of the file can be pinned
+		 * @return: returns true if the file was opened and holds a whole number of pages, otherwise false */
+		bool open (const string& filename, bool create);
+
+		/** Writes any changed pages and detaches the pool from its file
+		 * @post: the pool is empty
+		 * @return: returns true if every changed page was written, otherwise false */
+		bool close ();
+
+		/** Gets a page, reading it from the file if it isn't in the pool
+		 * @param page: the number of the page
+		 * @post: the page is pinned and can't be evicted until it's unpinned
+		 * @return: returns the page's bytes or NULL if the page couldn't be read or every frame is pinned */
+		char* pin (unsigned int page);
+
+		/** Adds a page to the end of the file
+		 * @param page: the variable that will receive the number of the new page
+		 * @post: the new page is filled with zeros and pinned. It's written to the file when it's evicted or flushed
+		 * @return: returns the page's bytes or NULL if every frame is pinned */
+		char* allocate (unsigned int& page);
+
+		/** Releases a pinned page
+		 * @param page: the number of the page
+		 * @param dirty: whether the page was changed
+		 * @post: the page can be evicted once it's unpinned as many times as it was pinned */
+		void unpin (unsigned int page, bool dirty);
+
+		/** Writes every changed page to the file
+		 * @return: returns true if the pages were written, otherwise false */
+		bool flush ();
+
+			// CONSTANT METHODS
+		/** Gets the size of each page
+		 * @return: returns the page size in bytes */
+		int getPageSize () const;
+
+		/** Gets the number of pages in the file, including pages that haven't been written yet
+		 * @return: returns the number of pages */
+		unsigned int getPageCount () const;
+
+		/** Gets the number of pages read from the file
+		 * @return: returns the number of reads since the file was opened */
+		long long getReads () const;
+
+		/** Gets the number of pages written to the file
+		 * @return: returns the number of writes since the file was opened */
+		long long getWrites () const;
+
+	private:
+		/** Finds a frame for a page, evicting the least recently used unpinned page if no frame is free
+		 * @return: returns the frame or -1 if every frame is pinned or an evicted page couldn't be written */
+		int takeFrame ();
+
+		/** Writes a frame's page to the file
+		 * @param frame: the frame to write
+		 * @return: returns true if the page was written, otherwise false */
+		bool writeFrame (int frame);
+
+		/** Gets a frame's bytes
+		 * @param frame: the frame
+		 * @return: returns the first byte of the frame */
+		char* frameData (int frame);
+
+		/** A frame and the page it holds */
+		struct Frame {
+			unsigned int page; //!< The page held in the frame
+			int pins; //!< The number of times the page is pinned
+			bool dirty; //!< Whether the page was changed since it was read
+			list<int>::iterator used; //!< The frame's place in the recently used list
+		};
+
+		int pageSize; //!< The size of each page
+		fstream file; //!< The file holding the pages
+		vector<char> memory; //!< The bytes of every frame
+		vector<Frame> frames; //!< The frames
+		vector<int> freeFrames; //!< The frames that don't hold a page
+		unordered_map<unsigned int, int> pageTable; //!< The frame holding each page in the pool
+		list<int> recentlyUsed; //!< The frames holding pages, most recently used first
+		unsigned int pageCount; //!< The number of pages in the file
+		long long reads; //!< The number of pages read
+		long long writes; //!< The number of pages written
+};
+
+#include "BufferPool.cpp"
+#endif
@@ -0,0 +1,181 @@
+#include "ChecksumDirectory.h"
+
+	// CONSTRUCTORS
+ChecksumDirectory::ChecksumDirectory () : dataEnd (-1) {}
+
+
+	// MODIFICATION METHODS
+void ChecksumDirectory::clear () {
+	entries.clear ();
+	dataEnd = -1;
+}
+
+void ChecksumDirectory::add (long long offset, unsigned int records, uint32_t checksum) {
+	entries.push_back ({offset, records, checksum});
+}
+
+void ChecksumDirectory::setDataEnd (long long dataEnd) {
+	this->dataEnd = dataEnd;
+}
+
+bool ChecksumDirectory::read (istream& file, long long dataStart) {
+	char trailer[trailerSize];
+	long long start;
+
+	clear ();
+
+	file.clear ();
+	file.seekg (0, ios::end);
+	long long fileSize = file.tellg ();
+	if (dataStart < 0 or fileSize < dataStart + trailerSize)
+		return false;
+
+	file.seekg (fileSize - trailerSize, ios::beg);
+	file.read (trailer, trailerSize);
+	memcpy (&start, trailer, 8);
+
+	if (file.good () == false or memcmp (trailer + 8, "PCCRCEND", 8) != 0 or start < dataStart or start > fileSize - trailerSize)
+		return false;
+
+	// Reads the whole directory with one read
+	string footer (fileSize - start, 0);
+	file.seekg (start, ios::beg);
+	file.read (&footer[0], footer.size ());
+	if ((size_t)file.gcount () != footer.size ())
+		return false;
+
+	return parse (footer.data (), footer.size (), start, dataStart);
+}
+
+bool ChecksumDirectory::read (const char* data, size_t size, long long dataStart) {
+	long long start;
+
+	clear ();
+
+	if (data == NULL or dataStart < 0 or (long long)size < dataStart + trailerSize)
+		return false;
+
+	memcpy (&start, data + size - trailerSize, 8);
+	if (memcmp (data + size - 8, "PCCRCEND", 8) != 0 or start < dataStart or start > (long long)size - trailerSize)
+		return false;
+
+	return parse (data + start, size - start, start, dataStart);
+}
+
+int ChecksumDirectory::write (ostream& file) {
+	long long start = file.tellp ();
+	string footer = "PCCRCDIR";
+	uint32_t count = entries.size ();
+
+	footer.append ((const char*)&count, 4);
+	for (size_t i = 0; i < entries.size (); ++i) {
+		footer.append ((const char*)&entries[i].offset, 8);
+		footer.append ((const char*)&entries[i].records, 4);
+		footer.append ((const char*)&entries[i].checksum, 4);
+	}
+
+	uint32_t checksum = crc32c (footer.data (), footer.size ());
+	footer.append ((const char*)&checksum, 4);
+	footer.append ((const char*)&start, 8);
+	footer += "PCCRCEND";
+
+	file.write (footer.data (), footer.size ());
+	dataEnd = start;
+
+	return file.good () ? (int)footer.size () : -1;
+}
+
+
+	// CONSTANT METHODS
+int ChecksumDirectory::size () const {
+	return entries.size ();
+}
+
+bool ChecksumDirectory::empty () const {
+	return entries.empty ();
+}
+
+const ChecksumDirectory::Entry& ChecksumDirectory::getEntry (int block) const {
+	return entries[block];
+}
+
+long long ChecksumDirectory::getEnd (int block) const {
+	return block + 1 < (int)entries.size () ? entries[block + 1].offset : dataEnd;
+}
+
+long long ChecksumDirectory::getDataEnd () const {
+	return dataEnd;
+}
+
+long long ChecksumDirectory::nextCheckpoint (long long position) const {
+	// The first block that starts after the position
+	size_t next = countStarted (position);
+
+	return next < entries.size () ? entries[next].offset : dataEnd;
+}
+
+int ChecksumDirectory::findBlock (long long position) const {
+	// The last block that starts at or before the position
+	size_t next = countStarted (position);
+
+	return next == 0 or position >= dataEnd ? -1 : next - 1;
+}
+
+bool ChecksumDirectory::verify (const char* data, int block) const {
+	long long offset = entries[block].offset;
+
+	return crc32c (data + offset, getEnd (block) - offset) == entries[block].checksum;
+}
+
+
+	// HELPER FUNCTIONS
+size_t ChecksumDirectory::countStarted (long long position) const {
+	size_t low = 0, high = entries.size ();
+	while (low < high) {
+		size_t middle = (low + high) / 2;
+
+		if (entries[middle].offset <= position)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+bool ChecksumDirectory::parse (const char* footer, size_t footerSize, long long start, long long dataStart) {
+	const char* data = footer;
+	uint32_t count, checksum;
+
+	if (footerSize < 12 + 4 + trailerSize or memcmp (data, "PCCRCDIR", 8) != 0)
+		return false;
+	memcpy (&count, data + 8, 4);
+
+	// The directory is protected by its own checksum, so damage to it isn't mistaken for damage to the records
+	if (12 + (size_t)count * entrySize + 4 + trailerSize != footerSize)
+		return false;
+	memcpy (&checksum, data + 12 + (size_t)count * entrySize, 4);
+	if (crc32c (data, 12 + (size_t)count * entrySize) != checksum)
+		return false;
+	data += 12;
+
+	// Blocks are listed in file order and cover every byte from the first record to the directory
+	for (uint32_t i = 0; i < count; ++i) {
+		Entry entry;
+		memcpy (&entry.offset, data, 8);
+		memcpy (&entry.records, data + 8, 4);
+		memcpy (&entry.checksum, data + 12, 4);
+		data += entrySize;
+
+		long long previous = entries.empty () ? dataStart - 1 : entries.back ().offset;
+		if (entry.offset <= previous or entry.offset >= start or (entries.empty () and entry.offset != dataStart)) {
+			entries.clear ();
+			return false;
+		}
+		entries.push_back (entry);
+	}
+
+	dataEnd = start;
+
+	return true;
+}
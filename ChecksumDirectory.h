@@ -0,0 +1,147 @@
+#ifndef ChecksumDirectory_
+#define ChecksumDirectory_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "Crc32c.h"
+
+using namespace std;
+
+/* The checksums of a DAT file's records
+The records are split into blocks of about 64 KiB that start and end on record boundaries, and each block has a CRC-32C checksum
+The directory is written after the last record, so readers stop there instead of reading it as records:
+	"PCCRCDIR" - 8 bytes
+	block count - 4 bytes
+	each block's offset (8 bytes), record count (4 bytes) and checksum (4 bytes)
+	the checksum of the directory up to here - 4 bytes
+	the offset of "PCCRCDIR" - 8 bytes
+	"PCCRCEND" - 8 bytes
+Since every block starts a record, a reader that finds a damaged record can start again at the next block and only loses that block
+Numbers are stored in the machine's byte order, like the sizes in the DAT header
+*/
+
+/** Used to write, read and check the checksums of a DAT file
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class ChecksumDirectory {
+	public:
+		/** A block of records and its checksum */
+		struct Entry {
+			long long offset; //!< The position of the block's first record
+			unsigned int records; //!< The number of records in the block
+			uint32_t checksum; //!< The CRC-32C of the block
+		};
+
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an empty directory */
+		ChecksumDirectory ();
+
+			// MODIFICATION METHODS
+		/** Removes every block
+		 * @post: the directory is empty and has no end */
+		void clear ();
+
+		/** Adds a block after the last one
+		 * @param offset: the position of the block's first record
+		 * @param records: the number of records in the block
+		 * @param checksum: the CRC-32C of the block
+		 * @pre: the block starts where the last block ends */
+		void add (long long offset, unsigned int records, uint32_t checksum);
+
+		/** Sets the position after the last block
+		 * @param dataEnd: the position after the last record */
+		void setDataEnd (long long dataEnd);
+
+		/** Reads the directory at the end of a file
+		 * @param file: the file to read from
+		 * @param dataStart: the position of the first record
+		 * @post: the read pointer is moved. The directory is cleared if the file doesn't have a valid one
+		 * @return: returns true if the directory was read, otherwise false */
+		bool read (istream& file, long long dataStart);
+
+		/** Reads the directory at the end of a mapped file
+		 * @param data: the first byte of the file
+		 * @param size: the size of the file
+		 * @param dataStart: the position of the first record
+		 * @post: the directory is cleared if the file doesn't have a valid one
+		 * @return: returns true if the directory was read, otherwise false */
+		bool read (const char* data, size_t size, long long dataStart);
+
+		/** Writes the directory
+		 * @param file: the file to write to, positioned after the last record
+		 * @post: the end of the data is set to where the directory starts
+		 * @return: returns the size of the directory or -1 if an error occured */
+		int write (ostream& file);
+
+			// CONSTANT METHODS
+		/** Gets the number of blocks
+		 * @return: returns the number of blocks */
+		int size () const;
+
+		/** Determines if the directory has any blocks
+		 * @return: returns true if there are no blocks, otherwise false */
+		bool empty () const;
+
+		/** Gets a block
+		 * @param block: the number of the block
+		 * @pre: 0 <= block < size ()
+		 * @return: returns the offset, record count and checksum of the block */
+		const Entry& getEntry (int block) const;
+
+		/** Gets the position after a block
+		 * @param block: the number of the block
+		 * @pre: 0 <= block < size ()
+		 * @return: returns the offset of the next block, or the end of the data for the last block */
+		long long getEnd (int block) const;
+
+		/** Gets the position after the last record
+		 * @return: returns the position or -1 if the file has no directory */
+		long long getDataEnd () const;
+
+		/** Finds the first block that starts after a position
+		 * @param position: the position in the file
+		 * @return: returns the offset of the block, or the end of the data if there's no block after the position */
+		long long nextCheckpoint (long long position) const;
+
+		/** Finds the block that holds a position
+		 * @param position: the position in the file
+		 * @return: returns the number of the block, or -1 if the position is before the first block or after the last record */
+		int findBlock (long long position) const;
+
+		/** Checks a block against its checksum
+		 * @param data: the first byte of the file
+		 * @param block: the number of the block
+		 * @pre: the whole block is readable from data
+		 * @return: returns true if the block's checksum matches, otherwise false */
+		bool verify (const char* data, int block) const;
+
+		static const int defaultBlockSize = 1 << 16; //!< The number of bytes of records converters put in each block
+
+	private:
+		/** Reads the directory from its bytes
+		 * @param footer: the directory, from "PCCRCDIR" to the end of the file
+		 * @param footerSize: the size of the directory
+		 * @param start: the position of the directory in the file
+		 * @param dataStart: the position of the first record
+		 * @return: returns true if the directory was valid, otherwise false */
+		bool parse (const char* footer, size_t footerSize, long long start, long long dataStart);
+
+		/** Counts the blocks that start at or before a position
+		 * @param position: the position in the file
+		 * @return: returns the number of the first block that starts after the position, or the number of blocks if there's none */
+		size_t countStarted (long long position) const;
+
+		static const int entrySize = 16; //!< The size of each block in the directory
+		static const int trailerSize = 16; //!< The directory's position and "PCCRCEND" at the end of the file
+
+		vector<Entry> entries; //!< The blocks in file order
+		long long dataEnd; //!< The position after the last record, or -1
+};
+
+#include "ChecksumDirectory.cpp"
+#endif
@@ -0,0 +1,119 @@
+#include "Crc32c.h"
+
+typedef uint32_t (*Crc32cFunction) (const char*, size_t, uint32_t);
+
+static Crc32cFunction crc32cKernel = NULL; //!< The version used by crc32c. NULL until the first call
+static string crc32cKernelName = "table"; //!< The name of the version used by crc32c
+
+// The tables for slicing by 8. tables[0] is the usual byte-at-a-time table and tables[k] advances a byte through k more zero bytes
+struct Crc32cTables {
+	uint32_t tables[8][256];
+
+	Crc32cTables () {
+		const uint32_t polynomial = 0x82F63B78; // Castagnoli, bit-reversed
+
+		for (uint32_t i = 0; i < 256; ++i) {
+			uint32_t crc = i;
+			for (int bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ (crc & 1 ? polynomial : 0);
+			tables[0][i] = crc;
+		}
+
+		for (int k = 1; k < 8; ++k)
+			for (uint32_t i = 0; i < 256; ++i)
+				tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+	}
+};
+
+uint32_t crc32c (const char* data, size_t size, uint32_t crc) {
+	if (crc32cKernel == NULL)
+		selectCrc32cKernel ("auto");
+
+	return crc32cKernel (data, size, crc);
+}
+
+bool selectCrc32cKernel (const string& name) {
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init ();
+
+	if ((name == "sse4.2" or name == "auto") and __builtin_cpu_supports ("sse4.2")) {
+		crc32cKernel = crc32cSse42;
+		crc32cKernelName = "sse4.2";
+		return true;
+	}
+#endif
+
+	if (name == "table" or name == "auto") {
+		crc32cKernel = crc32cTable;
+		crc32cKernelName = "table";
+		return true;
+	}
+
+	return false;
+}
+
+string getCrc32cKernel () {
+	if (crc32cKernel == NULL)
+		selectCrc32cKernel ("auto");
+
+	return crc32cKernelName;
+}
+
+uint32_t crc32cTable (const char* data, size_t size, uint32_t crc) {
+	static const Crc32cTables crcTables; // Built once, by whichever thread gets here first
+	const uint32_t (*t)[256] = crcTables.tables;
+	const unsigned char* bytes = (const unsigned char*)data;
+
+	crc = ~crc;
+
+	// Eight bytes at a time. The first four are folded into the checksum, which is little endian like the rest of the file
+	while (size >= 8) {
+		uint32_t low, high;
+		memcpy (&low, bytes, 4);
+		memcpy (&high, bytes + 4, 4);
+		low ^= crc;
+
+		crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24]
+			^ t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+
+		bytes += 8;
+		size -= 8;
+	}
+
+	while (size-- > 0)
+		crc = (crc >> 8) ^ t[0][(crc ^ *bytes++) & 0xFF];
+
+	return ~crc;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__ ((target ("sse4.2")))
+uint32_t crc32cSse42 (const char* data, size_t size, uint32_t crc) {
+	crc = ~crc;
+
+#if defined(__x86_64__)
+	uint64_t wide = crc;
+	while (size >= 8) {
+		uint64_t value;
+		memcpy (&value, data, 8);
+		wide = _mm_crc32_u64 (wide, value);
+		data += 8;
+		size -= 8;
+	}
+	crc = (uint32_t)wide;
+#endif
+
+	while (size >= 4) {
+		uint32_t value;
+		memcpy (&value, data, 4);
+		crc = _mm_crc32_u32 (crc, value);
+		data += 4;
+		size -= 4;
+	}
+
+	while (size-- > 0)
+		crc = _mm_crc32_u8 (crc, (unsigned char)*data++);
+
+	return ~crc;
+}
+#endif
@@ -0,0 +1,53 @@
+#ifndef Crc32c_
+#define Crc32c_
+
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#endif
+
+using namespace std;
+
+// Computes CRC-32C (Castagnoli) checksums, which protect the blocks of DAT files
+// The checksum of a range can be continued by passing the checksum of the bytes before it, so
+// crc32c (b, m, crc32c (a, n)) is the checksum of a followed by b
+// The fastest version supported by the CPU is chosen the first time a checksum is computed:
+//	"sse4.2" - 8 bytes at a time with the CRC32 instruction (x86 with SSE 4.2)
+//	"table" - 8 bytes at a time with eight 256-entry lookup tables (any CPU)
+
+/** Computes the checksum of a range of bytes
+ * @param data: the first byte
+ * @param size: the number of bytes
+ * @param crc: the checksum of the bytes before the range, or 0 to start a new checksum
+ * @return: returns the checksum, which is the same for every version */
+uint32_t crc32c (const char* data, size_t size, uint32_t crc = 0);
+
+/** Chooses which version crc32c uses
+ * @param name: "sse4.2", "table" or "auto" to use the fastest version the CPU supports
+ * @post: crc32c will use the chosen version
+ * @return: returns false if the CPU doesn't support the version, in which case the version isn't changed */
+bool selectCrc32cKernel (const string& name);
+
+/** Gets the name of the version crc32c uses
+ * @return: returns "sse4.2" or "table" */
+string getCrc32cKernel ();
+
+/** Computes a checksum with lookup tables
+ * @param data: the first byte
+ * @param size: the number of bytes
+ * @param crc: the checksum of the bytes before the range, or 0 to start a new checksum
+ * @return: returns the checksum */
+uint32_t crc32cTable (const char* data, size_t size, uint32_t crc);
+
+#if defined(__x86_64__) || defined(__i386__)
+/** Computes a checksum with the CRC32 instruction
+ * @pre: the CPU supports SSE 4.2 */
+uint32_t crc32cSse42 (const char* data, size_t size, uint32_t crc);
+#endif
+
+#include "Crc32c.cpp"
+#endif
@@ -0,0 +1,338 @@
+#include "CsvPostalCodeBuffer.h"
+
+	// CONSTRUCTORS
+CsvPostalCodeBuffer::CsvPostalCodeBuffer (int mb, int bs) : PostalCodeBuffer (mb), block (bs), blockStart (0), blockEnd (0), blockPos (0), atEnd (false), sliced (true), fieldIndex (0) {}
+
+CsvPostalCodeBuffer::~CsvPostalCodeBuffer () {}
+
+
+int CsvPostalCodeBuffer::readHeader (istream& file, const string&, const string&) {
+	STATS_TIME (statsHeader);
+	const char* expected[] = {"Zip\nCode", "Place\nName", "State", "County", "Lat", "Long"};
+
+	// Starts a new block at the header
+	blockPos = file.tellg ();
+	blockStart = 0;
+	blockEnd = 0;
+	atEnd = false;
+
+	if (blockPos < 0 or read (file) == -1)
+		return -1;
+
+	// Compares the header fields with the ones used by all postal code CSV files
+	// Some files end every line with a delimiter, which leaves an empty last field
+	bool valid = fieldEnds.size () == 6 or (fieldEnds.size () == 7 and fieldEnds[6] == fieldEnds[5]);
+	for (int i = 0; i < 6 and valid; ++i) {
+		int start = fieldStarts[i];
+		valid = fieldEnds[i] - start == (int)strlen (expected[i]) and memcmp (&buffer[start], expected[i], fieldEnds[i] - start) == 0;
+	}
+
+	return valid ? blockPos + blockStart : -1;
+}
+
+long long CsvPostalCodeBuffer::read (istream& file) {
+	long long result = -1;
+	int consumed = -1;
+
+	clear ();
+
+	// Parses the next record, reading more of the file whenever the record runs past the block
+	while (consumed == -1) {
+		consumed = parse (block.data () + blockStart, blockEnd - blockStart, atEnd);
+
+		if (consumed == -1 and refill (file) == 0 and atEnd == false) {
+			file.clear ();
+			return -1;
+		}
+	}
+
+	if (consumed > 0) {
+		result = blockPos + blockStart;
+		blockStart += consumed;
+	}
+
+	return result;
+}
+
+int CsvPostalCodeBuffer::readBatch (istream& file, PostalCodeBatch& batch, int n) {
+	long long recaddr;
+
+	batch.clear ();
+
+	// The record's text is still in the block after it's parsed, from its address up to the new block start
+	// Where its fields are is kept too, so select doesn't parse the record again
+	while (batch.size () < n and (recaddr = read (file)) != -1) {
+		int textStart = recaddr - blockPos;
+		batch.add (block.data () + textStart, blockStart - textStart, recaddr);
+
+		if (sliced)
+			batch.setFields (textBounds.data (), fieldEnds.size ());
+	}
+
+	return batch.size ();
+}
+
+void CsvPostalCodeBuffer::select (const PostalCodeBatch& batch, int i) {
+	string_view text = batch.getRecord (i);
+	int count;
+	const int* bounds = batch.getFields (i, count);
+
+	// Fields with escaped quotes have to be copied into the buffer without them, so only those records are parsed again
+	if (bounds == NULL) {
+		parse (text.data (), text.size (), true);
+		return;
+	}
+
+	clear ();
+	record = text.data ();
+	length = text.size ();
+	for (int f = 0; f < count; ++f) {
+		fieldStarts.push_back (bounds[2 * f]);
+		fieldEnds.push_back (bounds[2 * f + 1]);
+	}
+}
+
+long long CsvPostalCodeBuffer::write (ostream& file) const {
+	long long result = file.tellp ();
+	string line;
+
+	// Rebuilds the CSV line, quoting the fields that contain special characters
+	for (size_t i = 0; i < fieldEnds.size (); ++i) {
+		const char* field = &record[fieldStarts[i]];
+		int size = fieldEnds[i] - fieldStarts[i];
+		bool quoted = false;
+
+		for (int j = 0; j < size and quoted == false; ++j)
+			quoted = field[j] == fieldDelim or field[j] == quote or field[j] == recordDelim or field[j] == '\r';
+
+		if (i > 0)
+			line += fieldDelim;
+
+		if (quoted) {
+			line += quote;
+			for (int j = 0; j < size; ++j) {
+				if (field[j] == quote)
+					line += quote;
+				line += field[j];
+			}
+			line += quote;
+		}
+		else
+			line.append (field, size);
+	}
+	line += recordDelim;
+
+	file.write (line.data (), line.size ());
+
+	if (!file.good ())
+		result = -1;
+
+	return result;
+}
+
+long long CsvPostalCodeBuffer::dRead (istream& file, long long fileIndex) {
+	file.clear ();
+	file.seekg (fileIndex, ios::beg);
+
+	if (file.tellg () != fileIndex)
+		return -1;
+
+	// The old block doesn't start at the new position
+	blockPos = fileIndex;
+	blockStart = 0;
+	blockEnd = 0;
+	atEnd = false;
+
+	return read (file);
+}
+
+int CsvPostalCodeBuffer::pack (const char* field, int size) {
+	int len = size >= 0 ? size : strlen (field);
+
+	reserve (length + len);
+	fieldStarts.push_back (length);
+	memcpy (&buffer[length], field, len);
+	length += len;
+	nextByte = length;
+	fieldEnds.push_back (length);
+
+	return len;
+}
+
+int CsvPostalCodeBuffer::unpack (char* field, int strLen) {
+	if (fieldIndex >= (int)fieldEnds.size ())
+		return -1;
+
+	int start = fieldStarts[fieldIndex];
+	int fieldLen = fieldEnds[fieldIndex] - start;
+
+	if (fieldLen >= strLen and strLen != -1)
+		return -1;
+
+	memcpy (field, &record[start], fieldLen);
+	field[fieldLen] = 0;
+	fieldIndex += 1;
+	nextByte = fieldEnds[fieldIndex - 1];
+
+	return fieldLen;
+}
+
+int CsvPostalCodeBuffer::unpackView (string_view& field) {
+	if (fieldIndex >= (int)fieldEnds.size ())
+		return -1;
+
+	int start = fieldStarts[fieldIndex];
+	field = string_view (&record[start], fieldEnds[fieldIndex] - start);
+	fieldIndex += 1;
+	nextByte = fieldEnds[fieldIndex - 1];
+
+	return field.size ();
+}
+
+void CsvPostalCodeBuffer::clear () {
+	PostalCodeBuffer::clear ();
+	fieldStarts.clear ();
+	fieldEnds.clear ();
+	textBounds.clear ();
+	sliced = true;
+	fieldIndex = 0;
+}
+
+int CsvPostalCodeBuffer::parse (const char* data, int available, bool final) {
+	int i = 0;
+
+	clear ();
+
+	if (available <= 0)
+		return final ? 0 : -1;
+
+	// Each pass through the loop parses one field
+	while (true) {
+		int fieldStart = length; // The start of the field within the buffer
+		int textStart = i; // The start of the field's characters within data
+		bool quoted = i < available and data[i] == quote;
+
+		if (quoted) {
+			// Quoted field: copies everything up to the closing quote, turning "" into "
+			i += 1;
+			textStart = i;
+
+			while (true) {
+				const char* found = (const char*)memchr (&data[i], quote, available - i);
+
+				if (found == NULL and final == false)
+					return -1;
+
+				// A quote that is never closed runs to the end of the file
+				int size = found == NULL ? available - i : found - &data[i];
+				reserve (length + size + 1);
+				memcpy (&buffer[length], &data[i], size);
+				length += size;
+				i += size + 1;
+
+				// A second quote is an escaped quote
+				if (found == NULL) {
+					i = available;
+					break;
+				}
+				else if (i < available and data[i] == quote) {
+					sliced = false;
+					buffer[length] = quote;
+					length += 1;
+					i += 1;
+				}
+				else if (i >= available and final == false)
+					return -1;
+				else
+					break;
+			}
+		}
+
+		// Unquoted field, or anything after a closing quote
+		int start = i;
+		while (i < available and data[i] != fieldDelim and data[i] != recordDelim)
+			i += 1;
+
+		if (i >= available and final == false)
+			return -1;
+
+		int size = i - start;
+
+		// Removes the carriage return of a "\r\n" line break
+		if ((i >= available or data[i] == recordDelim) and size > 0 and data[i - 1] == '\r')
+			size -= 1;
+
+		reserve (length + size);
+		memcpy (&buffer[length], &data[start], size);
+		length += size;
+		fieldStarts.push_back (fieldStart);
+		fieldEnds.push_back (length);
+
+		// Characters after a closing quote leave the field in two pieces of data
+		if (quoted and size > 0)
+			sliced = false;
+		textBounds.push_back (textStart);
+		textBounds.push_back (textStart + length - fieldStart);
+
+		// The end of a field
+		if (i < available and data[i] == fieldDelim)
+			i += 1;
+		// The end of a record
+		else
+			return i < available ? i + 1 : i;
+	}
+}
+
+
+	// CONSTANT METHODS
+int CsvPostalCodeBuffer::getFieldCount () const {
+	return fieldEnds.size ();
+}
+
+
+	// HELPER FUNCTIONS
+void CsvPostalCodeBuffer::reserve (int size) {
+	if (size <= maxBytes)
+		return;
+
+	// Doubles the buffer so long records only cause a few copies
+	int newMax = maxBytes * 2 > size ? maxBytes * 2 : size;
+	char* newBuffer = new char[newMax];
+
+	memcpy (newBuffer, buffer, length);
+	delete[] buffer;
+	buffer = newBuffer;
+	record = buffer;
+	maxBytes = newMax;
+}
+
+int CsvPostalCodeBuffer::refill (istream& file) {
+	int remaining = blockEnd - blockStart;
+
+	if (atEnd)
+		return 0;
+
+	// Keeps the unparsed part of the block, growing the block if a single record fills it
+	if (remaining > 0 and blockStart > 0)
+		memmove (&block[0], &block[blockStart], remaining);
+	blockPos += blockStart;
+	blockStart = 0;
+	blockEnd = remaining;
+
+	if (blockEnd == (int)block.size ())
+		block.resize (block.size () * 2);
+
+	file.read (block.data () + blockEnd, block.size () - blockEnd);
+	int count = file.gcount ();
+	blockEnd += count;
+	STATS_COUNT (statsBytesRead, count);
+
+	if (file.eof ()) {
+		atEnd = true;
+		file.clear ();
+	}
+	else if (!file.good ())
+		atEnd = true;
+
+	return count;
+}
@@ -0,0 +1,149 @@
+#ifndef CsvPostalCodeBuffer_
+#define CsvPostalCodeBuffer_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "PostalCodeBuffer.h"
+
+using namespace std;
+
+// Used as a file buffer for zip code objects in old CSV files
+// Follows RFC 4180: fields may be quoted, quoted fields may contain ',', '"' (written as "") and line breaks,
+// and records may end with either "\n" or "\r\n"
+// The file is read in large blocks and records are found in memory instead of reading one character at a time
+// Fields are stored in the buffer without quotes or delimiters. Their boundaries are kept in a separate list
+// A batch keeps where each field is within the CSV text, so the records of a batch are only parsed once
+// The buffer grows when a record doesn't fit instead of failing
+
+/** Used to quickly read and write old CSV postal code files
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class CsvPostalCodeBuffer : public PostalCodeBuffer {
+	public:
+			// CONSTRUCTORS
+		/** Constructor with default parameters
+		 * @param mb: the starting number of bytes the record buffer will be able to hold
+		 * @param bs: the number of bytes read from the file at a time
+		 * @post: creates a CSV buffer with an empty block */
+		CsvPostalCodeBuffer (int mb = 1000, int bs = 1 << 20);
+
+		/** Destructor
+		 * @post: destroys the record buffer and the block */
+		virtual ~CsvPostalCodeBuffer ();
+
+		/** Reads the header record and checks that it has the expected fields
+		 * @param file: the file to read data from
+		 * @param indexFilename: Currently unused. Added for compatibility reasons
+		 * @param indexSchema: Currently unused. Added for compatibility reasons
+		 * @pre: the read pointer is at the start of the header
+		 * @post: the next read will return the first record, even if the header didn't match
+		 * @return: returns the size of the header or -1 if an error occured */
+		int readHeader (istream& file, const string& indexFilename, const string& indexSchema);
+
+		/** Reads a record from the block, reading the next block from the file if needed
+		 * @param file: the file to read data from
+		 * @post: the fields of the record are stored in the buffer
+		 * @return: returns the first character in the record or -1 if the end of the file was reached */
+		long long read (istream& file);
+
+		/** Reads several records from the file into a batch
+		 * @param file: the file to read data from
+		 * @param batch: the batch the records will be stored in
+		 * @param n: the largest number of records to read
+		 * @post: the batch holds the CSV text of each record, quotes included, and where the fields of the records without escaped quotes are
+		 * @return: returns the number of records read, which is 0 once the end of the file is reached */
+		int readBatch (istream& file, PostalCodeBatch& batch, int n);
+
+		/** Parses a record of a batch into the buffer, so its fields can be unpacked
+		 * @param batch: the batch holding the record
+		 * @param i: the number of the record within the batch
+		 * @pre: the batch was filled by CsvPostalCodeBuffer::readBatch
+		 * @post: the fields of the record can be unpacked and the first field will be unpacked next. Fields are read from the batch in place, unless they had escaped quotes */
+		void select (const PostalCodeBatch& batch, int i);
+
+		/** Writes a record to the file, quoting fields when needed
+		 * @param file: the file to write data to
+		 * @post: the put pointer is placed after the record's line break
+		 * @return: returns the first character in the record or -1 if an error occured */
+		long long write (ostream& file) const;
+
+		/** Reads a record from the file
+		 * @param file: the file to read data from
+		 * @param fileIndex: the position within the file to start reading from
+		 * @pre: fileIndex is the first character of a record
+		 * @post: the block is discarded and refilled from fileIndex
+		 * @return: returns the first character in the record or -1 if the end of the file was reached */
+		long long dRead (istream& file, long long fileIndex);
+
+		/** Sets the value of the next field of the buffer
+		 * @param field: the character array to be set in buffer
+		 * @param size: the size of field, or -1 to use strlen
+		 * @post: the buffer grows if the field doesn't fit
+		 * @return: returns the number of bytes packed into the buffer or -1 if there is an error */
+		int pack (const char* field, int size = -1);
+
+		/** Cuts a field from a buffer and pastes it into a character array
+		 * @param field: the character array that the data will be pasted into
+		 * @param strLen: the maximum size of field
+		 * @post: if successful, the next field will be unpacked next time
+		 * @return: returns the number of bytes extracted from the buffer or -1 if an error occured */
+		int unpack (char* field, int strLen = -1);
+
+		/** Gets the next field of the buffer without copying it
+		 * @param field: set to the field's unquoted characters within the buffer. It stays valid until the next read or clear
+		 * @post: if successful, the next field will be unpacked next time
+		 * @return: returns the length of the field or -1 if an error occured */
+		int unpackView (string_view& field);
+
+		/** Erases the record from the buffer
+		 * @post: the buffer and the field list are emptied. The block is kept */
+		void clear ();
+
+		/** Parses a single record held in memory into the buffer
+		 * @param data: the first character of the record
+		 * @param available: the number of characters that can be read from data
+		 * @param final: whether data runs to the end of the file, so a record without a line break is complete
+		 * @post: if successful, the fields of the record are stored in the buffer
+		 * @return: returns the number of characters used by the record and its line break, 0 if there was no record,
+		 *          or -1 if the record continues past available */
+		int parse (const char* data, int available, bool final);
+
+			// CONSTANT METHODS
+		/** Gets the number of fields in the current record
+		 * @return: returns the number of fields */
+		int getFieldCount () const;
+
+	private:
+		/** Makes sure the buffer can hold a number of bytes
+		 * @param size: the number of bytes the buffer needs to hold
+		 * @post: the buffer is replaced with a bigger one if needed, keeping its contents */
+		void reserve (int size);
+
+		/** Moves the unread part of the block to the front and fills the rest from the file
+		 * @param file: the file to read data from
+		 * @post: the block holds more data, or atEnd is set if the file has no more
+		 * @return: returns the number of characters read from the file */
+		int refill (istream& file);
+
+		static const char recordDelim = '\n'; //!< The character that indicates the end of a record
+		static const char fieldDelim = ','; //!< The character that indicates the end of a field
+		static const char quote = '"'; //!< The character that surrounds quoted fields
+
+		vector<char> block; //!< Characters read from the file that haven't been parsed yet
+		int blockStart; //!< The first unparsed character in the block
+		int blockEnd; //!< The character after the last valid character in the block
+		long long blockPos; //!< The position of the first character of the block within the file
+		bool atEnd; //!< Whether the end of the file has been read into the block
+		vector<int> fieldStarts; //!< The start of each field within the record
+		vector<int> fieldEnds; //!< The end of each field within the record
+		vector<int> textBounds; //!< The start and end of each field within the text parsed last
+		bool sliced; //!< True if every field parsed last is a single piece of its text, so textBounds describes the whole record
+		int fieldIndex; //!< The next field to unpack
+};
+
+#include "CsvPostalCodeBuffer.cpp"
+#endif
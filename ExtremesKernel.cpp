@@ -0,0 +1,194 @@
+#include "ExtremesKernel.h"
+
+typedef StateExtremes (*ExtremesFunction) (const int32_t*, const double*, const double*, int);
+
+static ExtremesFunction extremesKernel = NULL; //!< The version used by findExtremes. NULL until the first call
+static string extremesKernelName = "scalar"; //!< The name of the version used by findExtremes
+
+StateExtremes findExtremes (const int32_t* zipCodes, const double* lats, const double* lngs, int count) {
+	if (extremesKernel == NULL)
+		selectExtremesKernel ("auto");
+
+	return extremesKernel (zipCodes, lats, lngs, count);
+}
+
+bool selectExtremesKernel (const string& name) {
+	bool avx2 = false;
+	bool avx512 = false;
+
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_cpu_init ();
+	avx2 = __builtin_cpu_supports ("avx2");
+	avx512 = __builtin_cpu_supports ("avx512f");
+
+	if ((name == "avx512" or name == "auto") and avx512) {
+		extremesKernel = findExtremesAvx512;
+		extremesKernelName = "avx512";
+		return true;
+	}
+
+	if ((name == "avx2" or name == "auto") and avx2) {
+		extremesKernel = findExtremesAvx2;
+		extremesKernelName = "avx2";
+		return true;
+	}
+#endif
+
+	if (name == "scalar" or name == "auto") {
+		extremesKernel = findExtremesScalar;
+		extremesKernelName = "scalar";
+		return true;
+	}
+
+	return false;
+}
+
+string getExtremesKernel () {
+	if (extremesKernel == NULL)
+		selectExtremesKernel ("auto");
+
+	return extremesKernelName;
+}
+
+StateExtremes findExtremesScalar (const int32_t* zipCodes, const double* lats, const double* lngs, int count) {
+	StateExtremes extremes;
+
+	for (int i = 0; i < count; ++i)
+		extremes.update (zipCodes[i], lats[i], lngs[i]);
+
+	return extremes;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+__attribute__ ((target ("avx2")))
+StateExtremes findExtremesAvx2 (const int32_t* zipCodes, const double* lats, const double* lngs, int count) {
+	const int lanes = 4;
+
+	if (count < lanes)
+		return findExtremesScalar (zipCodes, lats, lngs, count);
+
+	// Each lane starts with its first row. Zip codes are converted to doubles, which is exact for 32-bit integers
+	__m256d lat = _mm256_loadu_pd (lats);
+	__m256d lng = _mm256_loadu_pd (lngs);
+	__m256d zip = _mm256_cvtepi32_pd (_mm_loadu_si128 ((const __m128i*)zipCodes));
+	__m256d eastLng = lng, eastZip = zip;
+	__m256d westLng = lng, westZip = zip;
+	__m256d northLat = lat, northZip = zip;
+	__m256d southLat = lat, southZip = zip;
+
+	int i = lanes;
+	for (; i + lanes <= count; i += lanes) {
+		lat = _mm256_loadu_pd (lats + i);
+		lng = _mm256_loadu_pd (lngs + i);
+		zip = _mm256_cvtepi32_pd (_mm_loadu_si128 ((const __m128i*)(zipCodes + i)));
+
+		// Lowest longitude, lowest zip code on ties
+		__m256d better = _mm256_or_pd (_mm256_cmp_pd (lng, eastLng, _CMP_LT_OQ), _mm256_and_pd (_mm256_cmp_pd (lng, eastLng, _CMP_EQ_OQ), _mm256_cmp_pd (zip, eastZip, _CMP_LT_OQ)));
+		eastLng = _mm256_blendv_pd (eastLng, lng, better);
+		eastZip = _mm256_blendv_pd (eastZip, zip, better);
+
+		// Highest longitude, highest zip code on ties
+		better = _mm256_or_pd (_mm256_cmp_pd (lng, westLng, _CMP_GT_OQ), _mm256_and_pd (_mm256_cmp_pd (lng, westLng, _CMP_EQ_OQ), _mm256_cmp_pd (zip, westZip, _CMP_GT_OQ)));
+		westLng = _mm256_blendv_pd (westLng, lng, better);
+		westZip = _mm256_blendv_pd (westZip, zip, better);
+
+		// Highest latitude, lowest zip code on ties
+		better = _mm256_or_pd (_mm256_cmp_pd (lat, northLat, _CMP_GT_OQ), _mm256_and_pd (_mm256_cmp_pd (lat, northLat, _CMP_EQ_OQ), _mm256_cmp_pd (zip, northZip, _CMP_LT_OQ)));
+		northLat = _mm256_blendv_pd (northLat, lat, better);
+		northZip = _mm256_blendv_pd (northZip, zip, better);
+
+		// Lowest latitude, highest zip code on ties
+		better = _mm256_or_pd (_mm256_cmp_pd (lat, southLat, _CMP_LT_OQ), _mm256_and_pd (_mm256_cmp_pd (lat, southLat, _CMP_EQ_OQ), _mm256_cmp_pd (zip, southZip, _CMP_GT_OQ)));
+		southLat = _mm256_blendv_pd (southLat, lat, better);
+		southZip = _mm256_blendv_pd (southZip, zip, better);
+	}
+
+	// Merges the lanes, which uses the same tie-breaks
+	double eLng[lanes], eZip[lanes], wLng[lanes], wZip[lanes], nLat[lanes], nZip[lanes], sLat[lanes], sZip[lanes];
+	_mm256_storeu_pd (eLng, eastLng);
+	_mm256_storeu_pd (eZip, eastZip);
+	_mm256_storeu_pd (wLng, westLng);
+	_mm256_storeu_pd (wZip, westZip);
+	_mm256_storeu_pd (nLat, northLat);
+	_mm256_storeu_pd (nZip, northZip);
+	_mm256_storeu_pd (sLat, southLat);
+	_mm256_storeu_pd (sZip, southZip);
+
+	StateExtremes extremes;
+	for (int lane = 0; lane < lanes; ++lane)
+		extremes.merge (StateExtremes (eZip[lane], eLng[lane], wZip[lane], wLng[lane], nZip[lane], nLat[lane], sZip[lane], sLat[lane], i / lanes));
+
+	// Rows that don't fill a vector
+	for (; i < count; ++i)
+		extremes.update (zipCodes[i], lats[i], lngs[i]);
+
+	return extremes;
+}
+
+__attribute__ ((target ("avx512f")))
+StateExtremes findExtremesAvx512 (const int32_t* zipCodes, const double* lats, const double* lngs, int count) {
+	const int lanes = 8;
+
+	if (count < lanes)
+		return findExtremesScalar (zipCodes, lats, lngs, count);
+
+	// Each lane starts with its first row. Zip codes are converted to doubles, which is exact for 32-bit integers
+	// The conversion is the zero-masked form with every lane selected. The plain form passes GCC an uninitialized vector to merge
+	// into, which -Wmaybe-uninitialized reports
+	__m512d lat = _mm512_loadu_pd (lats);
+	__m512d lng = _mm512_loadu_pd (lngs);
+	__m512d zip = _mm512_maskz_cvtepi32_pd (0xFF, _mm256_loadu_si256 ((const __m256i*)zipCodes));
+	__m512d eastLng = lng, eastZip = zip;
+	__m512d westLng = lng, westZip = zip;
+	__m512d northLat = lat, northZip = zip;
+	__m512d southLat = lat, southZip = zip;
+
+	int i = lanes;
+	for (; i + lanes <= count; i += lanes) {
+		lat = _mm512_loadu_pd (lats + i);
+		lng = _mm512_loadu_pd (lngs + i);
+		zip = _mm512_maskz_cvtepi32_pd (0xFF, _mm256_loadu_si256 ((const __m256i*)(zipCodes + i)));
+
+		// Lowest longitude, lowest zip code on ties
+		__mmask8 better = _mm512_cmp_pd_mask (lng, eastLng, _CMP_LT_OQ) | (_mm512_cmp_pd_mask (lng, eastLng, _CMP_EQ_OQ) & _mm512_cmp_pd_mask (zip, eastZip, _CMP_LT_OQ));
+		eastLng = _mm512_mask_blend_pd (better, eastLng, lng);
+		eastZip = _mm512_mask_blend_pd (better, eastZip, zip);
+
+		// Highest longitude, highest zip code on ties
+		better = _mm512_cmp_pd_mask (lng, westLng, _CMP_GT_OQ) | (_mm512_cmp_pd_mask (lng, westLng, _CMP_EQ_OQ) & _mm512_cmp_pd_mask (zip, westZip, _CMP_GT_OQ));
+		westLng = _mm512_mask_blend_pd (better, westLng, lng);
+		westZip = _mm512_mask_blend_pd (better, westZip, zip);
+
+		// Highest latitude, lowest zip code on ties
+		better = _mm512_cmp_pd_mask (lat, northLat, _CMP_GT_OQ) | (_mm512_cmp_pd_mask (lat, northLat, _CMP_EQ_OQ) & _mm512_cmp_pd_mask (zip, northZip, _CMP_LT_OQ));
+		northLat = _mm512_mask_blend_pd (better, northLat, lat);
+		northZip = _mm512_mask_blend_pd (better, northZip, zip);
+
+		// Lowest latitude, highest zip code on ties
+		better = _mm512_cmp_pd_mask (lat, southLat, _CMP_LT_OQ) | (_mm512_cmp_pd_mask (lat, southLat, _CMP_EQ_OQ) & _mm512_cmp_pd_mask (zip, southZip, _CMP_GT_OQ));
+		southLat = _mm512_mask_blend_pd (better, southLat, lat);
+		southZip = _mm512_mask_blend_pd (better, southZip, zip);
+	}
+
+	// Merges the lanes, which uses the same tie-breaks
+	double eLng[lanes], eZip[lanes], wLng[lanes], wZip[lanes], nLat[lanes], nZip[lanes], sLat[lanes], sZip[lanes];
+	_mm512_storeu_pd (eLng, eastLng);
+	_mm512_storeu_pd (eZip, eastZip);
+	_mm512_storeu_pd (wLng, westLng);
+	_mm512_storeu_pd (wZip, westZip);
+	_mm512_storeu_pd (nLat, northLat);
+	_mm512_storeu_pd (nZip, northZip);
+	_mm512_storeu_pd (sLat, southLat);
+	_mm512_storeu_pd (sZip, southZip);
+
+	StateExtremes extremes;
+	for (int lane = 0; lane < lanes; ++lane)
+		extremes.merge (StateExtremes (eZip[lane], eLng[lane], wZip[lane], wLng[lane], nZip[lane], nLat[lane], sZip[lane], sLat[lane], i / lanes));
+
+	// Rows that don't fill a vector
+	for (; i < count; ++i)
+		extremes.update (zipCodes[i], lats[i], lngs[i]);
+
+	return extremes;
+}
+#endif
@@ -0,0 +1,60 @@
+#ifndef ExtremesKernel_
+#define ExtremesKernel_
+
+#include <iostream>
+#include <string>
+#include <cstdint>
+#include "StateExtremes.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+// Finds the farthest postal code in each compass direction from contiguous zip code, latitude and longitude columns
+// All four arg-min/arg-max searches are done in a single pass. Each vector lane keeps its own extremes, with the same
+// zip code tie-breaks as StateExtremes, and the lanes are merged at the end, so every version returns exactly the same zip codes
+// The fastest version supported by the CPU is chosen the first time the kernel is used:
+//	"avx512" - 8 rows at a time (x86 with AVX-512F)
+//	"avx2" - 4 rows at a time (x86 with AVX2)
+//	"scalar" - 1 row at a time (any CPU)
+
+/** Finds the farthest postal codes within a range of rows
+ * @param zipCodes: the zip code column
+ * @param lats: the latitude column
+ * @param lngs: the longitude column
+ * @param count: the number of rows to search
+ * @return: returns the extremes of the rows, which match what StateExtremes::update would find */
+StateExtremes findExtremes (const int32_t* zipCodes, const double* lats, const double* lngs, int count);
+
+/** Chooses which version of the kernel findExtremes uses
+ * @param name: "avx512", "avx2", "scalar" or "auto" to use the fastest version the CPU supports
+ * @post: findExtremes will use the chosen version
+ * @return: returns false if the CPU doesn't support the version, in which case the kernel isn't changed */
+bool selectExtremesKernel (const string& name);
+
+/** Gets the name of the version findExtremes uses
+ * @return: returns "avx512", "avx2" or "scalar" */
+string getExtremesKernel ();
+
+/** Finds the farthest postal codes one row at a time
+ * @param zipCodes: the zip code column
+ * @param lats: the latitude column
+ * @param lngs: the longitude column
+ * @param count: the number of rows to search
+ * @return: returns the extremes of the rows */
+StateExtremes findExtremesScalar (const int32_t* zipCodes, const double* lats, const double* lngs, int count);
+
+#if defined(__x86_64__) || defined(__i386__)
+/** Finds the farthest postal codes four rows at a time
+ * @pre: the CPU supports AVX2 */
+StateExtremes findExtremesAvx2 (const int32_t* zipCodes, const double* lats, const double* lngs, int count);
+
+/** Finds the farthest postal codes eight rows at a time
+ * @pre: the CPU supports AVX-512F */
+StateExtremes findExtremesAvx512 (const int32_t* zipCodes, const double* lats, const double* lngs, int count);
+#endif
+
+#include "ExtremesKernel.cpp"
+#endif
@@ -0,0 +1,140 @@
+#include "FieldParser.h"
+
+bool parseInt (const char* first, const char* last, int& value) {
+	STATS_SAMPLE (statsParse);
+
+	// from_chars doesn't skip leading spaces or a '+' like atoi does
+	first = skipPrefix (first, last);
+
+	from_chars_result result = from_chars (first, last, value);
+
+	if (result.ec != errc ()) {
+		value = 0;
+		return false;
+	}
+
+	return true;
+}
+
+bool parseMicrodegrees (const char* first, const char* last, int64_t& micro) {
+	const char* ch = first;
+	bool negative = false;
+	int64_t whole = 0;
+	int64_t fraction = 0;
+	int wholeDigits = 0;
+	int fractionDigits = 0;
+
+	if (ch < last and (*ch == '-' or *ch == '+')) {
+		negative = *ch == '-';
+		ch += 1;
+	}
+
+	// Up to 9 whole digits keeps the result well within the 53 bits a double can hold exactly
+	while (ch < last and *ch >= '0' and *ch <= '9' and wholeDigits < 10) {
+		whole = whole * 10 + (*ch - '0');
+		wholeDigits += 1;
+		ch += 1;
+	}
+
+	if (ch < last and *ch == '.') {
+		ch += 1;
+
+		while (ch < last and *ch >= '0' and *ch <= '9' and fractionDigits < 7) {
+			fraction = fraction * 10 + (*ch - '0');
+			fractionDigits += 1;
+			ch += 1;
+		}
+	}
+
+	// Anything the fast path can't represent exactly is left for from_chars
+	if (wholeDigits + fractionDigits == 0 or wholeDigits > 9 or fractionDigits > 6)
+		return false;
+	if (ch < last and ((*ch >= '0' and *ch <= '9') or *ch == 'e' or *ch == 'E'))
+		return false;
+
+	static const int64_t scale[] = {1000000, 100000, 10000, 1000, 100, 10, 1};
+	micro = whole * 1000000 + fraction * scale[fractionDigits];
+	if (negative)
+		micro = -micro;
+
+	return true;
+}
+
+bool parseCoordinate (const char* first, const char* last, double& value) {
+	STATS_SAMPLE (statsParse);
+	int64_t micro;
+
+	while (first < last and isSpace (*first))
+		first += 1;
+
+	if (parseMicrodegrees (first, last, micro)) {
+		value = micro / 1000000.0;
+
+		// Keeps the sign of "-0.0" like atof
+		if (micro == 0 and *first == '-')
+			value = -value;
+
+		return true;
+	}
+
+	first = skipPrefix (first, last);
+
+	from_chars_result result = from_chars (first, last, value);
+
+	// Out of range numbers become infinity or 0 like they do with atof. This only happens in corrupt files
+	if (result.ec == errc::result_out_of_range) {
+		string temp (first, last);
+		value = strtod (temp.c_str (), NULL);
+	}
+	else if (result.ec != errc ()) {
+		value = 0;
+		return false;
+	}
+
+	return true;
+}
+
+bool parseWhole (const char* text, long long& value) {
+	const char* last = text + strlen (text);
+	const char* first = skipPrefix (text, last);
+	long long number;
+
+	// Unlike atoll, a string with anything after the number isn't a number
+	from_chars_result result = from_chars (first, last, number);
+	if (result.ec != errc () or result.ptr != last)
+		return false;
+
+	value = number;
+
+	return true;
+}
+
+bool parseWhole (const char* text, double& value) {
+	const char* last = text + strlen (text);
+	const char* first = skipPrefix (text, last);
+	double number;
+
+	// from_chars reads "inf" and "nan", which atof would too, but they aren't coordinates or distances
+	from_chars_result result = from_chars (first, last, number);
+	if (result.ec != errc () or result.ptr != last or isfinite (number) == false)
+		return false;
+
+	value = number;
+
+	return true;
+}
+
+bool isSpace (char ch) {
+	return ch == ' ' or (ch >= '\t' and ch <= '\r');
+}
+
+const char* skipPrefix (const char* first, const char* last) {
+	while (first < last and isSpace (*first))
+		first += 1;
+
+	// A '+' is only skipped when a number follows, so "+-1" is still rejected like it is by atof
+	if (first + 1 < last and *first == '+' and ((first[1] >= '0' and first[1] <= '9') or first[1] == '.'))
+		first += 1;
+
+	return first;
+}
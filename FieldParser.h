@@ -0,0 +1,67 @@
+#ifndef FieldParser_
+#define FieldParser_
+
+#include <iostream>
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include "IngestStats.h"
+
+using namespace std;
+
+// Parses the numeric fields of a postal code record straight from the record's characters
+// Unlike atoi and atof, nothing has to be copied or zero terminated first and the current locale is ignored
+// Like atoi and atof, only the number at the start of the field is used and a field with no number is read as 0
+// Coordinates in our files have at most 6 decimal places, so they are read as a whole number of microdegrees
+// and divided by 1000000. Both numbers are exact and division is correctly rounded, so the result is the same double atof would return
+
+/** Parses a whole number
+ * @param first: the first character of the field
+ * @param last: the character after the end of the field
+ * @param value: set to the number, or 0 if the field doesn't start with one
+ * @return: returns true if the field started with a number */
+bool parseInt (const char* first, const char* last, int& value);
+
+/** Parses a coordinate with at most 6 decimal places as microdegrees
+ * @param first: the first character of the field
+ * @param last: the character after the end of the field
+ * @param micro: set to the coordinate multiplied by 1000000
+ * @return: returns false if the field isn't a number with at most 6 decimal places, in which case micro isn't set */
+bool parseMicrodegrees (const char* first, const char* last, int64_t& micro);
+
+/** Parses a coordinate
+ * @param first: the first character of the field
+ * @param last: the character after the end of the field
+ * @param value: set to the coordinate, or 0 if the field doesn't start with a number
+ * @post: uses parseMicrodegrees when possible and std::from_chars otherwise
+ * @return: returns true if the field started with a number */
+bool parseCoordinate (const char* first, const char* last, double& value);
+
+/** Determines if a character is skipped at the start of a number, like isspace in the C locale
+ * @param ch: the character to check
+ * @return: returns true for spaces, tabs and line breaks */
+bool isSpace (char ch);
+
+/** Parses a string that has to be a whole number with nothing after it, such as a command line argument
+ * @param text: the zero terminated string
+ * @param value: set to the number if the string is one
+ * @return: returns true if the whole string is a number that fits in value, otherwise false */
+bool parseWhole (const char* text, long long& value);
+
+/** Parses a string that has to be a finite decimal number with nothing after it, such as a command line argument
+ * @param text: the zero terminated string
+ * @param value: set to the number if the string is one
+ * @return: returns true if the whole string is a number, otherwise false */
+bool parseWhole (const char* text, double& value);
+
+/** Skips what atoi and atof allow before a number but std::from_chars doesn't
+ * @param first: the first character of the field
+ * @param last: the character after the end of the field
+ * @return: returns the first character after any leading spaces and a '+' sign */
+const char* skipPrefix (const char* first, const char* last);
+
+#include "FieldParser.cpp"
+#endif
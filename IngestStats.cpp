@@ -0,0 +1,177 @@
+#include "IngestStats.h"
+
+IngestStats::Totals IngestStats::finished;
+mutex IngestStats::finishedLock;
+atomic<long long> IngestStats::allocations (0);
+atomic<long long> IngestStats::allocatedBytes (0);
+
+	// MODIFICATION METHODS
+void IngestStats::count (StatsCounter counter, long long amount) {
+	local ().totals.counters[counter] += amount;
+}
+
+void IngestStats::addTime (StatsStage stage, long long nanoseconds, long long calls) {
+	Totals& totals = local ().totals;
+
+	totals.nanoseconds[stage] += nanoseconds;
+	totals.calls[stage] += calls;
+}
+
+void IngestStats::countAllocation (size_t size) {
+	allocations.fetch_add (1, memory_order_relaxed);
+	allocatedBytes.fetch_add (size, memory_order_relaxed);
+}
+
+
+	// CONSTANT METHODS
+IngestStats::Totals IngestStats::collect () {
+	Totals totals;
+
+	{
+		lock_guard<mutex> guard (finishedLock);
+		totals = finished;
+	}
+
+	const Totals& current = local ().totals;
+	for (int c = 0; c < statsCounterCount; ++c)
+		totals.counters[c] += current.counters[c];
+	for (int s = 0; s < statsStageCount; ++s) {
+		totals.nanoseconds[s] += current.nanoseconds[s];
+		totals.calls[s] += current.calls[s];
+	}
+
+	totals.allocations = allocations.load (memory_order_relaxed);
+	totals.allocatedBytes = allocatedBytes.load (memory_order_relaxed);
+
+	return totals;
+}
+
+void IngestStats::display (ostream& out) {
+	const char* labels[statsStageCount] = {"Header validation", "Record read", "Field unpack", "  Numeric parse", "Map insert", "Report"};
+	Totals totals = collect ();
+
+	out << "Statistics" << endl;
+	out << left << setw (24) << "  Bytes read" << totals.counters[statsBytesRead] << endl;
+	out << left << setw (24) << "  Records read" << totals.counters[statsRecordsRead] << endl;
+	out << left << setw (24) << "  Records rejected" << totals.counters[statsRecordsRejected] << endl;
+	out << left << setw (24) << "  Allocations" << totals.allocations << " (" << totals.allocatedBytes << " bytes)" << endl;
+
+	out << left << setw (24) << "  Stage" << right << setw (12) << "Time (ms)" << setw (14) << "Calls" << setw (16) << "Per call (ns)" << endl;
+	for (int s = 0; s < statsStageCount; ++s) {
+		long long calls = totals.calls[s];
+
+		out << left << setw (24) << string ("  ") + labels[s] << right << fixed << setprecision (3);
+		out << setw (12) << totals.nanoseconds[s] / 1e6 << setw (14) << calls;
+		out << setw (16) << setprecision (1) << (calls > 0 ? (double)totals.nanoseconds[s] / calls : 0.0) << endl;
+	}
+
+	if (totals.nanoseconds[statsRead] > 0)
+		out << "  Read throughput: " << setprecision (1) << totals.counters[statsBytesRead] * 1e3 / totals.nanoseconds[statsRead] << " MB/s" << endl;
+	out << "  Numeric parse time is part of the field unpack time. Per-record and per-field stages are timed on every " << sampleRate << "th call" << endl;
+
+	out.unsetf (ios::fixed);
+	out << setprecision (6);
+}
+
+void IngestStats::writeJson (ostream& out) {
+	Totals totals = collect ();
+
+	out << "{" << endl;
+	out << "  \"sampleRate\": " << sampleRate << "," << endl;
+	out << "  \"counters\": {" << endl;
+	for (int c = 0; c < statsCounterCount; ++c)
+		out << "    \"" << getCounterName ((StatsCounter)c) << "\": " << totals.counters[c] << (c + 1 < statsCounterCount ? "," : "") << endl;
+	out << "  }," << endl;
+	out << "  \"allocations\": {\"count\": " << totals.allocations << ", \"bytes\": " << totals.allocatedBytes << "}," << endl;
+	out << "  \"stages\": {" << endl;
+	for (int s = 0; s < statsStageCount; ++s) {
+		out << "    \"" << getStageName ((StatsStage)s) << "\": {\"nanoseconds\": " << totals.nanoseconds[s] << ", \"calls\": " << totals.calls[s] << "}";
+		out << (s + 1 < statsStageCount ? "," : "") << endl;
+	}
+	out << "  }" << endl;
+	out << "}" << endl;
+}
+
+const char* IngestStats::getStageName (StatsStage stage) {
+	const char* names[statsStageCount] = {"header", "read", "unpack", "parse", "insert", "report"};
+
+	return names[stage];
+}
+
+const char* IngestStats::getCounterName (StatsCounter counter) {
+	const char* names[statsCounterCount] = {"bytesRead", "recordsRead", "recordsRejected"};
+
+	return names[counter];
+}
+
+
+	// HELPER FUNCTIONS
+IngestStats::Local::~Local () {
+	lock_guard<mutex> guard (finishedLock);
+
+	for (int c = 0; c < statsCounterCount; ++c)
+		finished.counters[c] += totals.counters[c];
+	for (int s = 0; s < statsStageCount; ++s) {
+		finished.nanoseconds[s] += totals.nanoseconds[s];
+		finished.calls[s] += totals.calls[s];
+	}
+}
+
+IngestStats::Local& IngestStats::local () {
+	thread_local Local stats;
+
+	return stats;
+}
+
+
+	// CONSTRUCTORS
+StatsTimer::StatsTimer (StatsStage stage, int sampleRate) : stage (stage), weight (sampleRate) {
+	// Counts this thread's calls of each stage so every sampleRate-th one is timed. Stages that alternate on every record
+	// would otherwise always land on the same one. The counters have no destructor, so they cost no more than globals
+	static thread_local unsigned int ticks[statsStageCount] = {};
+
+	if (sampleRate > 1 and ++ticks[stage] % sampleRate != 0)
+		weight = 0;
+	else
+		start = chrono::steady_clock::now ();
+}
+
+StatsTimer::~StatsTimer () {
+	if (weight > 0)
+		IngestStats::addTime (stage, chrono::duration_cast<chrono::nanoseconds> (chrono::steady_clock::now () - start).count () * weight, weight);
+}
+
+
+#ifdef POSTAL_CODE_STATS
+// Counts every allocation made with new. The matching deletes have to be replaced too, since the memory comes from malloc.
+// They aren't inlined, so the compiler doesn't pair a free it can see with a new it can't
+__attribute__ ((noinline)) void* operator new (size_t size) {
+	IngestStats::countAllocation (size);
+
+	void* memory = malloc (size > 0 ? size : 1);
+	if (memory == NULL)
+		throw bad_alloc ();
+
+	return memory;
+}
+
+__attribute__ ((noinline)) void* operator new[] (size_t size) {
+	return operator new (size);
+}
+
+__attribute__ ((noinline)) void operator delete (void* memory) noexcept {
+	free (memory);
+}
+
+__attribute__ ((noinline)) void operator delete[] (void* memory) noexcept {
+	free (memory);
+}
+
+__attribute__ ((noinline)) void operator delete (void* memory, size_t) noexcept {
+	free (memory);
+}
+
+__attribute__ ((noinline)) void operator delete[] (void* memory, size_t) noexcept {
+	free (memory);
+}
+#endif
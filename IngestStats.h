@@ -0,0 +1,160 @@
+#ifndef IngestStats_
+#define IngestStats_
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+// Counts and times the work of reading a postal code file, for --stats
+// Only programs built with -DPOSTAL_CODE_STATS collect anything. Otherwise the STATS_ macros below expand to nothing,
+// so the buffers and the table functions compile exactly as they would without them
+// Each thread adds to its own counters, which are added to the totals when the thread ends, so threads never wait on each other
+// Stages that run once per batch or once per file are timed on every call. Stages that run once per record or field
+// are timed on every sampleRate-th call and the time is multiplied by sampleRate, which keeps the clock reads off most records
+// Times are added up over every thread, so a stage run on 4 threads for 1 second counts as 4 seconds
+// Allocations are counted by replacing the global operator new
+
+/** The amounts that are counted */
+enum StatsCounter {
+	statsBytesRead, //!< The bytes read from files, including headers
+	statsRecordsRead, //!< The records read from files
+	statsRecordsRejected, //!< The records that couldn't be unpacked
+	statsCounterCount //!< The number of counters
+};
+
+/** The stages that are timed */
+enum StatsStage {
+	statsHeader, //!< Reading and validating file headers
+	statsRead, //!< Reading records from files
+	statsUnpack, //!< Unpacking the fields of records, including numeric parsing
+	statsParse, //!< Parsing text numbers
+	statsInsert, //!< Adding postal codes to the state table
+	statsReport, //!< Displaying the report
+	statsStageCount //!< The number of stages
+};
+
+/** Used to collect and display the counters and stage times of the program
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class IngestStats {
+	public:
+		/** The counters and times of one thread, or the totals of every thread */
+		struct Totals {
+			long long counters[statsCounterCount] = {}; //!< The value of each counter
+			long long nanoseconds[statsStageCount] = {}; //!< The time spent in each stage
+			long long calls[statsStageCount] = {}; //!< The number of times each stage ran
+			long long allocations = 0; //!< The number of allocations
+			long long allocatedBytes = 0; //!< The number of bytes allocated
+		};
+
+			// MODIFICATION METHODS
+		/** Adds to a counter of the calling thread
+		 * @param counter: the counter to add to
+		 * @param amount: the amount to add */
+		static void count (StatsCounter counter, long long amount);
+
+		/** Adds time to a stage of the calling thread
+		 * @param stage: the stage to add to
+		 * @param nanoseconds: the time spent in the stage
+		 * @param calls: the number of calls the time is for */
+		static void addTime (StatsStage stage, long long nanoseconds, long long calls);
+
+		/** Counts an allocation
+		 * @param size: the number of bytes allocated
+		 * @post: safe to call from operator new, before and after main */
+		static void countAllocation (size_t size);
+
+			// CONSTANT METHODS
+		/** Adds up the counters and times
+		 * @return: returns the totals of the threads that have ended and of the calling thread */
+		static Totals collect ();
+
+		/** Displays the counters and times as a table
+		 * @param out: the stream to write to */
+		static void display (ostream& out);
+
+		/** Writes the counters and times as JSON
+		 * @param out: the stream to write to */
+		static void writeJson (ostream& out);
+
+		/** Gets the name of a stage
+		 * @param stage: the stage
+		 * @return: returns the name used in the table and the JSON */
+		static const char* getStageName (StatsStage stage);
+
+		/** Gets the name of a counter
+		 * @param counter: the counter
+		 * @return: returns the name used in the table and the JSON */
+		static const char* getCounterName (StatsCounter counter);
+
+#ifdef POSTAL_CODE_STATS
+		static constexpr bool enabled = true; //!< True if the program was built with -DPOSTAL_CODE_STATS
+#else
+		static constexpr bool enabled = false; //!< True if the program was built with -DPOSTAL_CODE_STATS
+#endif
+		static const int sampleRate = 64; //!< How often the stages that run once per record or field are timed
+
+	private:
+		/** The counters of one thread, which are added to the totals when the thread ends */
+		struct Local {
+			Totals totals; //!< The thread's counters and times
+			~Local ();
+		};
+
+		static Local& local ();
+
+		static Totals finished; //!< The totals of the threads that have ended
+		static mutex finishedLock; //!< Guards finished
+		static atomic<long long> allocations; //!< The number of allocations. Shared, since operator new can run while a thread is ending
+		static atomic<long long> allocatedBytes; //!< The number of bytes allocated
+};
+
+/** Times a stage from its construction to its destruction
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class StatsTimer {
+	public:
+			// CONSTRUCTORS
+		/** Constructor that starts timing
+		 * @param stage: the stage being timed
+		 * @param sampleRate: 1 to time every call, or n to time every n-th call of the thread
+		 * @post: reads the clock if this call is timed */
+		StatsTimer (StatsStage stage, int sampleRate = 1);
+
+		/** Destructor
+		 * @post: adds the time since construction to the stage, multiplied by the sample rate */
+		~StatsTimer ();
+
+		StatsTimer (const StatsTimer&) = delete;
+		StatsTimer& operator = (const StatsTimer&) = delete;
+
+	private:
+		StatsStage stage; //!< The stage being timed
+		int weight; //!< The number of calls this one stands for, or 0 if it isn't timed
+		chrono::steady_clock::time_point start; //!< When the timer started
+};
+
+#define STATS_JOIN_(a, b) a##b
+#define STATS_NAME_(line) STATS_JOIN_(statsTimer, line)
+
+#ifdef POSTAL_CODE_STATS
+#define STATS_COUNT(counter, amount) IngestStats::count (counter, amount)
+#define STATS_TIME(stage) StatsTimer STATS_NAME_(__LINE__) (stage)
+#define STATS_SAMPLE(stage) StatsTimer STATS_NAME_(__LINE__) (stage, IngestStats::sampleRate)
+#else
+#define STATS_COUNT(counter, amount) ((void)0)
+#define STATS_TIME(stage) ((void)0)
+#define STATS_SAMPLE(stage) ((void)0)
+#endif
+
+#include "IngestStats.cpp"
+#endif
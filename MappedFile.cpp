@@ -0,0 +1,72 @@
+#include "MappedFile.h"
+
+	// CONSTRUCTORS
+MappedFile::MappedFile () : mapping (NULL), length (0), opened (false) {}
+
+MappedFile::MappedFile (const string& filename, bool sequential) : mapping (NULL), length (0), opened (false) {
+	open (filename, sequential);
+}
+
+MappedFile::~MappedFile () {
+	close ();
+}
+
+
+	// MODIFICATION METHODS
+bool MappedFile::open (const string& filename, bool sequential) {
+	close ();
+
+	int fd = ::open (filename.c_str (), O_RDONLY);
+	if (fd == -1)
+		return false;
+
+	struct stat info;
+	if (fstat (fd, &info) == 0) {
+		length = info.st_size;
+
+		// mmap can't create an empty mapping, so empty files are left unmapped
+		if (length == 0)
+			opened = true;
+		else {
+			void* addr = mmap (NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+			if (addr != MAP_FAILED) {
+				mapping = (const char*)addr;
+				opened = true;
+
+				// Tells the kernel how much to read ahead
+				madvise (addr, length, sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+			}
+			else
+				length = 0;
+		}
+	}
+
+	// The mapping stays valid after the descriptor is closed
+	::close (fd);
+
+	return opened;
+}
+
+void MappedFile::close () {
+	if (mapping != NULL)
+		munmap ((void*)mapping, length);
+
+	mapping = NULL;
+	length = 0;
+	opened = false;
+}
+
+
+	// CONSTANT METHODS
+bool MappedFile::isOpen () const {
+	return opened;
+}
+
+const char* MappedFile::data () const {
+	return mapping;
+}
+
+size_t MappedFile::size () const {
+	return length;
+}
@@ -0,0 +1,73 @@
+#ifndef MappedFile_
+#define MappedFile_
+
+#include <iostream>
+#include <string>
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+// Maps an entire file into memory with mmap so it can be read like a character array
+// The mapping is read-only and is released when the object is closed or destroyed
+
+/** Used to map postal code data and index files into memory
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class MappedFile {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an object that isn't mapped to any file */
+		MappedFile ();
+
+		/** Constructor that maps a file
+		 * @param filename: the name of the file to map
+		 * @param sequential: whether the file will mostly be read from front to back
+		 * @post: maps the file into memory. isOpen () will return false if an error occured */
+		MappedFile (const string& filename, bool sequential = true);
+
+		/** Destructor
+		 * @post: unmaps the file if one is mapped */
+		~MappedFile ();
+
+			// MODIFICATION METHODS
+		/** Maps a file into memory, replacing the current mapping
+		 * @param filename: the name of the file to map
+		 * @param sequential: whether the file will mostly be read from front to back. Otherwise readahead is reduced for random access
+		 * @post: the file's contents can be accessed through data ()
+		 * @return: returns true if the file was mapped, otherwise false */
+		bool open (const string& filename, bool sequential = true);
+
+		/** Unmaps the current file
+		 * @post: data () will return NULL and size () will return 0 */
+		void close ();
+
+			// CONSTANT METHODS
+		/** Determines if a file is currently mapped
+		 * @return: returns true if a file is mapped */
+		bool isOpen () const;
+
+		/** Gets the first byte of the mapping
+		 * @return: returns a pointer to the file contents or NULL if no file is mapped */
+		const char* data () const;
+
+		/** Gets the size of the mapping
+		 * @return: returns the number of bytes in the mapped file */
+		size_t size () const;
+
+	private:
+		MappedFile (const MappedFile&) = delete;
+		MappedFile& operator = (const MappedFile&) = delete;
+
+		const char* mapping; //!< The start of the mapped file or NULL if no file is mapped
+		size_t length; //!< The size of the mapped file
+		bool opened; //!< Whether a file is mapped. Empty files are opened without a mapping
+};
+
+#include "MappedFile.cpp"
+#endif
@@ -0,0 +1,121 @@
+#include "MappedPostalCodeBuffer.h"
+
+	// CONSTRUCTORS
+MappedPostalCodeBuffer::MappedPostalCodeBuffer (const string& filename) : NewPostalCodeBuffer (), mapping (filename), data (mapping.data ()), dataSize (mapping.size ()), cursor (0) {}
+
+MappedPostalCodeBuffer::MappedPostalCodeBuffer (const char* data, size_t begin, size_t end) : NewPostalCodeBuffer (), data (data), dataSize (end), cursor (begin) {}
+
+MappedPostalCodeBuffer::~MappedPostalCodeBuffer () {}
+
+
+int MappedPostalCodeBuffer::readHeader (istream& stream, const string& indexFilename, const string& indexSchema) {
+	int result = NewPostalCodeBuffer::readHeader (stream, indexFilename, indexSchema);
+	unsigned int headerSize;
+	int prefix = PostalCodeHeader::decodeHeaderLength (data, dataSize, headerSize);
+
+	// Skips the header in the mapping no matter what, just like the stream version, unless the records can't be read at all
+	cursor = prefix == -1 or isSupported () == false ? dataSize : prefix + headerSize;
+
+	// The checksum directory after the last record isn't read
+	if (checksums.getDataEnd () != -1 and (size_t)checksums.getDataEnd () < dataSize)
+		dataSize = checksums.getDataEnd ();
+
+	return result;
+}
+
+long long MappedPostalCodeBuffer::read (istream&) {
+	return next ();
+}
+
+long long MappedPostalCodeBuffer::dRead (istream&, long long fileIndex) {
+	if (fileIndex < 0)
+		return -1;
+
+	cursor = fileIndex;
+
+	return next ();
+}
+
+long long MappedPostalCodeBuffer::next () {
+	long long result = -1;
+	unsigned int recordSize;
+
+	clear ();
+
+	while (result == -1 and cursor < dataSize) {
+		int prefix = 0;
+		size_t limit = dataSize;
+
+		// A block's checksum is checked before its first record is used, and the whole block is skipped if it doesn't match
+		int block = checksums.getDataEnd () == -1 ? -1 : uncheckedBlock (cursor);
+		if (block != -1) {
+			if (checksums.verify (data, block) == false) {
+				resyncs += 1;
+				cursor = checksums.getEnd (block);
+				continue;
+			}
+			setChecked (block);
+		}
+
+		// Fixed-length records don't have a length indicator
+		if (isFixed ())
+			recordSize = fixedRecordSize;
+		else
+			prefix = NewPostalCodeBuffer::decodeLength (data + cursor, dataSize - cursor, recordSize, getVersion ());
+
+		// In a file with checksums, no record runs into the next block
+		if (checksums.getDataEnd () != -1)
+			limit = min (limit, (size_t)checksums.nextCheckpoint (cursor));
+
+		// The whole record has to be inside the mapping and fit the same limit as the stream version
+		if (prefix != -1 and (int)recordSize <= maxBytes and cursor + prefix + recordSize <= limit) {
+			result = cursor;
+			record = data + cursor + prefix;
+			length = recordSize;
+			cursor += prefix + recordSize;
+		}
+		// Skips the rest of a damaged block
+		else if (checksums.getDataEnd () != -1) {
+			resyncs += 1;
+			cursor = limit;
+		}
+		// Starts again at the next valid record, unless the records are fixed-length and can't be told apart
+		else if (isFixed () == false) {
+			resyncs += 1;
+			resync (cursor + 1);
+		}
+		else
+			cursor = dataSize;
+	}
+
+	return result;
+}
+
+long long MappedPostalCodeBuffer::resync (size_t from) {
+	// A position is only trusted if the record there and the one after it are both valid, or it's the last record
+	for (size_t position = from; position < dataSize; ++position) {
+		size_t end;
+
+		if (isValidRecord (position, end) and (end == dataSize or isValidRecord (end, end))) {
+			cursor = position;
+			return position;
+		}
+	}
+
+	cursor = dataSize;
+
+	return -1;
+}
+
+	// CONSTANT METHODS
+string_view MappedPostalCodeBuffer::getRecord () const {
+	return string_view (record, length);
+}
+
+size_t MappedPostalCodeBuffer::getCursor () const {
+	return cursor;
+}
+
+bool MappedPostalCodeBuffer::isValidRecord (size_t position, size_t& end) const {
+	return NewPostalCodeBuffer::isValidRecord (data, dataSize, position, end);
+}
@@ -0,0 +1,100 @@
+#ifndef MappedPostalCodeBuffer_
+#define MappedPostalCodeBuffer_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include "NewPostalCodeBuffer.h"
+#include "MappedFile.h"
+
+using namespace std;
+
+// Used as a read-only file buffer for new DAT files
+// The whole file is mapped into memory, so records are never copied into the buffer
+// Instead, the record pointer is moved to each record within the mapping and fields are unpacked from there
+// The stream passed to the read methods is only used for validating the header
+// A buffer can also read a range of records from memory mapped by someone else, which lets several threads share one mapping
+
+/** Used to quickly read new DAT postal code files without copying
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class MappedPostalCodeBuffer : public NewPostalCodeBuffer {
+	public:
+			// CONSTRUCTORS
+		/** Constructor that maps a file
+		 * @param filename: the DAT file to read
+		 * @post: maps the file into memory. Reads will fail if the file couldn't be mapped */
+		MappedPostalCodeBuffer (const string& filename);
+
+		/** Constructor that reads a range of records from an existing mapping
+		 * @param data: the first byte of the mapped file
+		 * @param begin: the position of the first record's length indicator within the file
+		 * @param end: the position after the last record in the range
+		 * @pre: data stays mapped for the life of the buffer and begin is the start of a record. Call setVersion, setBinary or setFixed first if the file isn't a version 1 text file
+		 * @post: the next read will return the record at begin. Reads fail once end is reached */
+		MappedPostalCodeBuffer (const char* data, size_t begin, size_t end);
+
+		/** Destructor
+		 * @post: unmaps the file */
+		virtual ~MappedPostalCodeBuffer ();
+
+		/** Validates the file header and moves to the first record in the mapping
+		 * @param file: the stream that the header is validated from
+		 * @param indexFilename: The name of the index file, which should match the one listed in the header
+		 * @param indexSchema: The file storage scheme used by the index, which should match the one listed in the header
+		 * @post: the next read will return the first record, even if the header didn't match
+		 * @return: returns the size of the header or -1 if an error occured */
+		int readHeader (istream& file, const string& indexFilename, const string& indexSchema);
+
+		/** Moves to the next record in the mapping
+		 * @param file: unused, since records are read from the mapping
+		 * @post: the record pointer will point to the record within the mapping
+		 * @return: returns the first character in the record or -1 if the end of the file was reached before the end of the record */
+		long long read (istream& file);
+
+		/** Moves to a record in the mapping
+		 * @param file: unused, since records are read from the mapping
+		 * @param fileIndex: the position of the record's length indicator within the file
+		 * @post: the record pointer will point to the record and the next read will return the record after it
+		 * @return: returns the first character in the record or -1 if the end of the file was reached before the end of the record */
+		long long dRead (istream& file, long long fileIndex);
+
+		/** Moves to the next record in the mapping without a stream
+		 * @post: the record pointer will point to the record within the mapping
+		 * @return: returns the first character in the record or -1 if the end of the file was reached before the end of the record */
+		long long next ();
+
+		/** Scans for the next record boundary after damage, for files that don't have checksums. Called by next when a record can't be read
+		 * @param from: the first position to try
+		 * @post: the next read returns the record at the boundary, or fails if there isn't one
+		 * @return: returns the position of the first record at or after from that is valid and is followed by another valid record or the end of the data, or -1 if there's none */
+		long long resync (size_t from);
+
+			// CONSTANT METHODS
+		/** Gets the current record without copying it
+		 * @return: returns the record's characters within the mapping */
+		string_view getRecord () const;
+
+		/** Gets the position of the next record
+		 * @return: returns the position of the next record's length indicator, or the end of the data once reading has stopped */
+		size_t getCursor () const;
+
+		/** Determines if a valid record starts at a position
+		 * @param position: the position of the record's length indicator
+		 * @param end: set to the position after the record if it's valid
+		 * @post: the record is checked in place within the mapping
+		 * @return: returns true if the record fits, every field is present and the zip code, state and coordinates are in range, otherwise false */
+		bool isValidRecord (size_t position, size_t& end) const;
+
+	private:
+		MappedFile mapping; //!< The mapped DAT file. Unused when reading from another mapping
+		const char* data; //!< The first byte of the file being read
+		size_t dataSize; //!< The position after the last record that can be read
+		size_t cursor; //!< The position of the next record's length indicator
+};
+
+#include "MappedPostalCodeBuffer.cpp"
+#endif
@@ -1,23 +1,17 @@
 #include "NewPostalCodeBuffer.h"
 
+// Zip code, city, state, county, lat and long
+const int NewPostalCodeBuffer::fixedWidths[NewPostalCodeBuffer::fieldCount] = {intSize, 32, 2, 40, intSize, intSize};
+const int NewPostalCodeBuffer::fixedRecordSize = intSize + 32 + 2 + 40 + intSize + intSize;
+
 	// CONSTRUCTORS
-NewPostalCodeBuffer::NewPostalCodeBuffer (int mb) {
+NewPostalCodeBuffer::NewPostalCodeBuffer (int mb, bool binary) : PostalCodeBuffer (mb), resyncs (0), checkedStart (0), checkedEnd (0), supported (false), binary (binary), fixed (false), fieldIndex (0), dataStart (-1) {
 	// Sets default values for the postal code header
-	headerMan.setStructure ("LENGTH/DELIM");
 	headerMan.setVersion (1);
-	headerMan.setRecordSize (0);
 	headerMan.setSizeFormat (1);
-	headerMan.setFieldCount (6);
-	vector<string> fieldInfo = {
-		"zipCode/DELIM/,",
-		"city/DELIM/,",
-		"state/DELIM/,",
-		"county/DELIM/,",
-		"lat/DELIM/,",
-		"lng/DELIM/,"
-	};
-	headerMan.setFieldInfo (fieldInfo);
+	headerMan.setFieldCount (fieldCount);
 	headerMan.setPrimaryKey ("zipCode");
+	updateHeader ();
 }
 
 
@@ -29,14 +23,43 @@ NewPostalCodeBuffer::~NewPostalCodeBuffer () {
 
 
 int NewPostalCodeBuffer::readHeader (istream& file, const string& indexFilename, const string& indexSchema) {
+	// Uses the version, field encoding and record layout listed in the header
+	PostalCodeHeader fileHeader;
+	checksums.clear ();
+	resyncs = 0;
+	checkedStart = checkedEnd = 0;
+	dataStart = -1;
+	supported = fileHeader.readHeader (file) != -1 and fileHeader.isSupported ();
+
+	// A header that can't be read leaves the stream failed, so reading afterwards doesn't decode records with the wrong layout
+	if (supported == false) {
+		file.setstate (ios::failbit);
+		return -1;
+	}
+
+	setBinary (fileHeader.getStructure () == "LENGTH/BINARY");
+	setFixed (fileHeader.getStructure () == "FIXED/FIXED");
+	setVersion (fileHeader.getVersion ());
+
 	// Prepares the header manager for validating the header
 	headerMan.setIndexFilename (indexFilename);
 	headerMan.setIndexSchema (indexSchema);
-		
-	return headerMan.validateHeader (file);
+
+	int result = headerMan.validateHeader (file);
+	dataStart = result;
+
+	// The checksum directory is at the end of the file, so the read pointer is put back afterwards
+	long long position = file.tellg ();
+	if (position >= 0) {
+		checksums.read (file, position);
+		file.clear ();
+		file.seekg (position, ios::beg);
+	}
+
+	return result;
 }
 
-int NewPostalCodeBuffer::writeHeader (ostream& file, unsigned short recordCount, const string& indexFilename, const string& indexSchema) {
+int NewPostalCodeBuffer::writeHeader (ostream& file, unsigned long long recordCount, const string& indexFilename, const string& indexSchema) {
 	// Prepares the header manager for writing to the file
 	headerMan.setRecordCount (recordCount);
 	headerMan.setIndexFilename (indexFilename);
@@ -45,27 +68,92 @@ int NewPostalCodeBuffer::writeHeader (ostream& file, unsigned short recordCount,
 	return headerMan.writeHeader (file);
 }
 
-int NewPostalCodeBuffer::read (istream& file) {
-	int result = -1;
+long long NewPostalCodeBuffer::readRecord (istream& file, long long recordNumber) {
+	long long recaddr = recordAddress (recordNumber);
+
+	if (recaddr == -1)
+		return -1;
+
+	// dRead takes the whole address, so records past 2 GiB are found too
+	return dRead (file, recaddr);
+}
+
+long long NewPostalCodeBuffer::read (istream& file) {
+	long long recaddr = file.tellg ();
+
+	if (checksums.getDataEnd () == -1) {
+		long long result = readNext (file, -1);
+
+		// Anything but the end of the file is damage, so reading starts again at the next valid record
+		if (result == -1 and fixed == false and recaddr >= 0) {
+			file.clear ();
+			file.seekg (recaddr, ios::beg);
+
+			if (file.peek () != EOF) {
+				resyncs += 1;
+				recaddr = findRecord (file, recaddr + 1);
+				file.clear ();
+				file.seekg (recaddr, ios::beg);
+				result = readNext (file, -1);
+			}
+		}
+
+		return result;
+	}
+
+	// A damaged record is skipped along with the rest of its block, and so is a block that fails its checksum
+	while (recaddr >= 0 and recaddr < checksums.getDataEnd ()) {
+		long long checkpoint = checksums.nextCheckpoint (recaddr);
+		int block = uncheckedBlock (recaddr);
+		long long result = -1;
+
+		if (block == -1 or verifyBlock (file, block)) {
+			setChecked (block);
+			result = readNext (file, checkpoint);
+		}
+
+		if (result != -1)
+			return result;
+
+		resyncs += 1;
+		recaddr = checkpoint;
+		file.clear ();
+		file.seekg (recaddr, ios::beg);
+	}
+
+	clear ();
+
+	return -1;
+}
+
+long long NewPostalCodeBuffer::readNext (istream& file, long long limit) {
+	long long result = -1;
 
 	// Checks if the end of the file was reached
 	if (file.eof () == false) {
-		int recaddr = file.tellg (); // Position of the next record
-		char* temp = new char[2];
+		long long recaddr = file.tellg (); // Position of the next record
 		clear (); // Makes room in the buffer for the next record
 
-		// Reads the record size
-		unsigned short recordSize; // Unsigned shorts are 16-bit positive ints
-		file.read (temp, 2);
-		recordSize = (temp[1] << 8) | temp[0];
-		delete temp;
-		temp = NULL;
+		// Reads the record size, which fixed-length records don't store
+		unsigned int recordSize = fixedRecordSize;
+		if (fixed == false) {
+			char prefix[maxLengthSize];
+			int prefixSize = 0;
+
+			// Reads the length indicator a byte at a time until it can be decoded
+			while (prefixSize < maxLengthSize and file.get (prefix[prefixSize]) and decodeLength (prefix, ++prefixSize, recordSize, getVersion ()) == -1) {}
+			STATS_COUNT (statsBytesRead, prefixSize);
 
-		// Checks for file problems or buffer overflow before writing to the buffer
-		if (file.good () == false or maxBytes < recordSize)
+			if (decodeLength (prefix, prefixSize, recordSize, getVersion ()) == -1)
+				file.setstate (ios::failbit);
+		}
+
+		// Checks for file problems, buffer overflow or a record that runs past the limit before writing to the buffer
+		if (file.good () == false or (unsigned int)maxBytes < recordSize or (limit != -1 and (long long)file.tellg () + recordSize > limit))
 			clear ();
 		else {
 			file.read (buffer, recordSize);
+			STATS_COUNT (statsBytesRead, file.gcount ());
 
 			if (file.good () == true) {
 				result = recaddr;
@@ -79,20 +167,591 @@ int NewPostalCodeBuffer::read (istream& file) {
     return result;
 }
 
-int NewPostalCodeBuffer::write (ostream& file) const {
-	int result = -1;
-	int recaddr = file.tellp ();
-	unsigned short recordSize = length; // Gets the length of the record to write
+int NewPostalCodeBuffer::readBatch (istream& file, PostalCodeBatch& batch, int n) {
+	long long start = file.tellg (); // Position of the first record
+	size_t parsed = 0; // The number of bytes of the arena used by whole records
+	long long dataEnd = checksums.getDataEnd (); // The position of the checksum directory, or -1
+	long long checkpoint = -1; // The start of the next checksum block, which no record can run past
+	long long resume = -1; // Where the next read starts if a damaged record was skipped past the bytes read so far
+	bool done = start < 0 or (dataEnd != -1 and start >= dataEnd);
+
+	batch.clear ();
+	if (done == false and dataEnd != -1)
+		checkpoint = checksums.nextCheckpoint (start);
+
+	while (batch.size () < n and done == false) {
+		// Adds the next block of the file to the arena, without the checksum directory after the last record
+		size_t stored = batch.arenaSize ();
+		file.read (batch.extend (batchBlockSize), batchBlockSize);
+		long long added = file.gcount ();
+		done = added < batchBlockSize;
+		if (dataEnd != -1 and start + (long long)stored + added >= dataEnd) {
+			added = dataEnd - start - stored;
+			done = true;
+		}
+		batch.truncate (stored + added);
+
+		// Finds the whole records within the arena, up to the checksum directory
+		while (batch.size () < n and (dataEnd == -1 or start + (long long)parsed < dataEnd)) {
+			const char* data = batch.data () + parsed;
+			size_t available = batch.arenaSize () - parsed;
+			unsigned int recordSize = fixedRecordSize;
+			int prefix = 0;
+
+			if (fixed == false)
+				prefix = decodeLength (data, available, recordSize, getVersion ());
+
+			// A block's checksum is checked before its first record is used, from the arena once the whole block is in it
+			int block = checkpoint == -1 ? -1 : uncheckedBlock (start + parsed);
+			bool damaged = false;
+			if (block != -1) {
+				long long offset = checksums.getEntry (block).offset;
+				long long blockEnd = checksums.getEnd (block);
+
+				if (offset >= start and blockEnd - start > (long long)batch.arenaSize () and done == false)
+					break;
+
+				if (offset >= start and blockEnd - start <= (long long)batch.arenaSize ())
+					damaged = crc32c (batch.data () + (offset - start), blockEnd - offset) != checksums.getEntry (block).checksum;
+				else
+					damaged = verifyBlock (file, block) == false;
+
+				if (damaged == false)
+					setChecked (block);
+			}
+
+			// A record is also damaged if its length indicator is invalid, it's too big to read or it runs into the next checksum block
+			damaged = damaged or (prefix == -1 and available >= (size_t)maxLengthSize)
+				or (prefix != -1 and ((unsigned int)maxBytes < recordSize or (checkpoint != -1 and start + (long long)(parsed + prefix + recordSize) > checkpoint)));
+
+			// The rest of the record is in the next block
+			if (damaged == false and (prefix == -1 or prefix + recordSize > available))
+				break;
+
+			if (damaged) {
+				resyncs += 1;
+
+				// Without checksums, reading starts again at the next valid record, which is found by scanning the file
+				if (checkpoint == -1) {
+					resume = findRecord (file, start + parsed + 1);
+					break;
+				}
+
+				// Starts again at the next checksum block, which might not have been read yet
+				if (checkpoint - start > (long long)batch.arenaSize ()) {
+					resume = checkpoint;
+					break;
+				}
+				parsed = checkpoint - start;
+				checkpoint = checksums.nextCheckpoint (checkpoint);
+				continue;
+			}
+
+			batch.addStored (parsed + prefix, recordSize, start + parsed);
+			parsed += prefix + recordSize;
+			if (checkpoint != -1 and start + (long long)parsed >= checkpoint)
+				checkpoint = checksums.nextCheckpoint (start + parsed);
+		}
+
+		// Skips past the damage. An empty batch would look like the end of the file, so it starts over from there
+		if (resume != -1) {
+			if (batch.size () > 0)
+				break;
+
+			start = resume;
+			parsed = 0;
+			resume = -1;
+			batch.clear ();
+			file.clear ();
+			file.seekg (start, ios::beg);
+			done = dataEnd != -1 and start >= dataEnd;
+			if (dataEnd != -1)
+				checkpoint = checksums.nextCheckpoint (start);
+		}
+	}
+
+	// Leaves the read pointer at the first record that wasn't added, so the next read starts there
+	if (start >= 0) {
+		file.clear ();
+		file.seekg (resume != -1 ? resume : start + (long long)parsed, ios::beg);
+		STATS_COUNT (statsBytesRead, parsed);
+	}
+
+	return batch.size ();
+}
+
+long long NewPostalCodeBuffer::findRecord (istream& file, long long from) {
+	// Consecutive chunks overlap by two of the largest records, so both records tried at a position are always in the chunk
+	const size_t overlap = 2 * (maxLengthSize + maxBytes);
+	vector<char> chunk (batchBlockSize + overlap);
+
+	for (long long start = from; ; start += batchBlockSize) {
+		file.clear ();
+		file.seekg (start, ios::beg);
+		file.read (chunk.data (), chunk.size ());
+		size_t size = file.gcount ();
+		bool atEnd = size < chunk.size ();
+
+		for (size_t position = 0; position < (atEnd ? size : (size_t)batchBlockSize); ++position) {
+			size_t end;
+
+			if (isValidRecord (chunk.data (), size, position, end) and ((atEnd and end == size) or isValidRecord (chunk.data (), size, end, end)))
+				return start + position;
+		}
+
+		if (atEnd)
+			return start + size;
+	}
+}
+
+bool NewPostalCodeBuffer::verifyBlock (istream& file, int block) {
+	long long position = file.tellg ();
+	long long offset = checksums.getEntry (block).offset;
+	vector<char> bytes (checksums.getEnd (block) - offset);
+
+	file.clear ();
+	file.seekg (offset, ios::beg);
+	file.read (bytes.data (), bytes.size ());
+	bool valid = file.gcount () == (streamsize)bytes.size () and crc32c (bytes.data (), bytes.size ()) == checksums.getEntry (block).checksum;
+
+	file.clear ();
+	file.seekg (position, ios::beg);
+
+	return valid;
+}
+
+long long NewPostalCodeBuffer::write (ostream& file) const {
+	long long result = -1;
+	long long recaddr = file.tellp ();
+	char prefix[maxLengthSize];
+	int prefixSize = encodeLength (length, prefix, getVersion ()); // Gets the length of the record to write
+
+	// Fixed-length records must be completely packed
+	if ((fixed == true and length != fixedRecordSize) or prefixSize == -1)
+		return -1;
 
 	// Writes the record size to the file
-	file.write ((char*)&recordSize, sizeof (recordSize));
+	if (fixed == false)
+		file.write (prefix, prefixSize);
 
 	if (file.good () == true) {
-		file.write (buffer, length); // Writes the buffer contents
+		file.write (record, length); // Writes the buffer contents
 
 		if (file.good () == true)
 			result = recaddr;
 	}
 
 	return result;
-}
\ No newline at end of file
+}
+
+int NewPostalCodeBuffer::append (string& out) const {
+	char prefix[maxLengthSize];
+	int prefixSize = encodeLength (length, prefix, getVersion ());
+	size_t start = out.size ();
+
+	// Fixed-length records must be completely packed
+	if ((fixed == true and length != fixedRecordSize) or prefixSize == -1)
+		return -1;
+
+	if (fixed == false)
+		out.append (prefix, prefixSize);
+	out.append (record, length);
+
+	return out.size () - start;
+}
+
+int NewPostalCodeBuffer::pack (const char* field, int size) {
+	if (binary == false)
+		return PostalCodeBuffer::pack (field, size);
+
+	int len = size >= 0 ? size : strlen (field);
+
+	if (fixed == true) {
+		// The string is padded with zeros to the width of the field
+		if (fieldIndex >= fieldCount or len > fixedWidths[fieldIndex] or nextByte + fixedWidths[fieldIndex] > maxBytes)
+			return -1;
+
+		memcpy (&buffer[nextByte], field, len);
+		memset (&buffer[nextByte + len], 0, fixedWidths[fieldIndex] - len);
+		nextByte += fixedWidths[fieldIndex];
+	}
+	else {
+		// The length has to fit in a single byte
+		if (len > maxStringSize or nextByte + 1 + len > maxBytes)
+			return -1;
+
+		buffer[nextByte] = (char)len;
+		memcpy (&buffer[nextByte + 1], field, len);
+		nextByte += len + 1;
+	}
+	length = nextByte;
+	fieldIndex += 1;
+
+	return len;
+}
+
+int NewPostalCodeBuffer::packInt (int n) {
+	if (binary == false)
+		return PostalCodeBuffer::packInt (n);
+
+	if (nextByte + intSize > maxBytes)
+		return -1;
+
+	int32_t value = n;
+	memcpy (&buffer[nextByte], &value, intSize);
+	nextByte += intSize;
+	length = nextByte;
+	fieldIndex += 1;
+
+	return intSize;
+}
+
+int NewPostalCodeBuffer::packCoordinate (double value) {
+	if (binary == false)
+		return PostalCodeBuffer::packCoordinate (value);
+
+	// Coordinates are within +-180 degrees, so millionths of a degree fit in an int
+	if (!(value >= -180 and value <= 180))
+		return -1;
+
+	return packInt ((int)llround (value * 1000000));
+}
+
+int NewPostalCodeBuffer::unpack (char* field, int strLen) {
+	if (binary == false)
+		return PostalCodeBuffer::unpack (field, strLen);
+
+	string_view view;
+	int fieldLen = unpackView (view);
+
+	// Checks whether the field will fit into the provided character array
+	if (fieldLen != -1 and (fieldLen < strLen or strLen == -1)) {
+		memcpy (field, view.data (), fieldLen);
+		field[fieldLen] = 0;
+	}
+	else
+		fieldLen = -1;
+
+	return fieldLen;
+}
+
+int NewPostalCodeBuffer::unpackView (string_view& field) {
+	if (binary == false)
+		return PostalCodeBuffer::unpackView (field);
+
+	int fieldLen = -1;
+
+	if (fixed == true) {
+		// The string ends at the first padding zero or at the end of the field
+		if (fieldIndex < fieldCount and nextByte + fixedWidths[fieldIndex] <= length) {
+			const char* start = record + nextByte;
+			const char* end = (const char*)memchr (start, 0, fixedWidths[fieldIndex]);
+
+			fieldLen = end == NULL ? fixedWidths[fieldIndex] : end - start;
+			field = string_view (start, fieldLen);
+			nextByte += fixedWidths[fieldIndex];
+			fieldIndex += 1;
+		}
+	}
+	// Checks that the length and the string both fit within the record
+	else if (nextByte < length) {
+		int size = (unsigned char)record[nextByte];
+
+		if (nextByte + 1 + size <= length) {
+			field = string_view (record + nextByte + 1, size);
+			nextByte += size + 1;
+			fieldLen = size;
+			fieldIndex += 1;
+		}
+	}
+
+	return fieldLen;
+}
+
+int NewPostalCodeBuffer::unpackInt (int& n) {
+	if (binary == false)
+		return PostalCodeBuffer::unpackInt (n);
+
+	if (nextByte + intSize > length)
+		return -1;
+
+	int32_t value;
+	memcpy (&value, record + nextByte, intSize);
+	n = value;
+	nextByte += intSize;
+	fieldIndex += 1;
+
+	return intSize;
+}
+
+int NewPostalCodeBuffer::unpackCoordinate (double& value) {
+	if (binary == false)
+		return PostalCodeBuffer::unpackCoordinate (value);
+
+	int micro;
+	int fieldLen = unpackInt (micro);
+
+	// Exact, since dividing by 1000000 is correctly rounded
+	if (fieldLen != -1)
+		value = micro / 1000000.0;
+
+	return fieldLen;
+}
+
+int NewPostalCodeBuffer::unpackRecord (int& zipCode, string_view& city, string_view& state, string_view& county, double& lat, double& lng) {
+	if (unpackInt (zipCode) == -1
+		or unpackView (city) == -1
+		or unpackView (state) == -1
+		or unpackView (county) == -1
+		or unpackCoordinate (lat) == -1)
+		return -1;
+
+	return unpackCoordinate (lng);
+}
+
+void NewPostalCodeBuffer::clear () {
+	PostalCodeBuffer::clear ();
+	fieldIndex = 0;
+}
+
+void NewPostalCodeBuffer::setBinary (bool binary) {
+	this->binary = binary;
+	fixed = fixed and binary;
+	updateHeader ();
+}
+
+void NewPostalCodeBuffer::setFixed (bool fixed) {
+	this->fixed = fixed;
+	binary = binary or fixed;
+	updateHeader ();
+}
+
+void NewPostalCodeBuffer::setVersion (unsigned short version) {
+	headerMan.setVersion (version);
+}
+
+unsigned short NewPostalCodeBuffer::getVersion () const {
+	return headerMan.getVersion ();
+}
+
+bool NewPostalCodeBuffer::isBinary () const {
+	return binary;
+}
+
+bool NewPostalCodeBuffer::isFixed () const {
+	return fixed;
+}
+
+long long NewPostalCodeBuffer::recordAddress (long long recordNumber) const {
+	if (fixed == false or dataStart == -1 or recordNumber < 0)
+		return -1;
+
+	// The checksum directory isn't a record
+	long long recaddr = dataStart + recordNumber * fixedRecordSize;
+	if (checksums.getDataEnd () != -1 and recaddr + fixedRecordSize > checksums.getDataEnd ())
+		return -1;
+
+	return recaddr;
+}
+
+const ChecksumDirectory& NewPostalCodeBuffer::getChecksums () const {
+	return checksums;
+}
+
+void NewPostalCodeBuffer::setChecksums (const ChecksumDirectory& checksums) {
+	this->checksums = checksums;
+	checkedStart = checkedEnd = 0;
+}
+
+int NewPostalCodeBuffer::getResyncCount () const {
+	return resyncs;
+}
+
+bool NewPostalCodeBuffer::isSupported () const {
+	return supported;
+}
+
+bool NewPostalCodeBuffer::isValidRecord (const char* data, size_t size, size_t position, size_t& end) const {
+	unsigned int recordSize = fixedRecordSize;
+	int prefix = 0;
+
+	if (position >= size)
+		return false;
+	if (fixed == false)
+		prefix = decodeLength (data + position, size - position, recordSize, getVersion ());
+	if (prefix == -1 or (unsigned int)maxBytes < recordSize or recordSize > size - position - prefix)
+		return false;
+
+	// The fields are checked where they are, without copying the record
+	const char* first = data + position + prefix;
+	const char* last = first + recordSize;
+	int zipCode;
+	int32_t number;
+	size_t stateSize = 0;
+	double lat, lng;
+
+	if (fixed == true) {
+		const char* state = first + fixedWidths[0] + fixedWidths[1];
+		const char* stateEnd = (const char*)memchr (state, 0, fixedWidths[2]);
+
+		memcpy (&number, first, intSize);
+		zipCode = number;
+		stateSize = stateEnd == NULL ? fixedWidths[2] : stateEnd - state;
+		memcpy (&number, last - 2 * intSize, intSize);
+		lat = number / 1000000.0;
+		memcpy (&number, last - intSize, intSize);
+		lng = number / 1000000.0;
+	}
+	else if (binary == true) {
+		// The zip code, three strings with 1-byte lengths and the coordinates have to use up the record exactly
+		size_t next = intSize;
+		for (int i = 1; i <= 3; ++i) {
+			if (next >= recordSize)
+				return false;
+			if (i == 2)
+				stateSize = (unsigned char)first[next];
+			next += 1 + (unsigned char)first[next];
+		}
+		if (next + 2 * intSize != recordSize)
+			return false;
+
+		memcpy (&number, first, intSize);
+		zipCode = number;
+		memcpy (&number, last - 2 * intSize, intSize);
+		lat = number / 1000000.0;
+		memcpy (&number, last - intSize, intSize);
+		lng = number / 1000000.0;
+	}
+	else {
+		// Every field ends with a delimiter, and the last one ends the record
+		const char* fields[fieldCount + 1] = {first};
+		for (int i = 0; i < fieldCount; ++i) {
+			const char* delim = (const char*)memchr (fields[i], fieldDelim, last - fields[i]);
+			if (delim == NULL)
+				return false;
+			fields[i + 1] = delim + 1;
+		}
+		if (fields[fieldCount] != last)
+			return false;
+
+		parseInt (fields[0], fields[1] - 1, zipCode);
+		stateSize = fields[3] - 1 - fields[2];
+		parseCoordinate (fields[4], fields[5] - 1, lat);
+		parseCoordinate (fields[5], fields[6] - 1, lng);
+	}
+
+	if (zipCode <= 0 or zipCode > 99999 or stateSize != 2 or !(lat >= -90 and lat <= 90) or !(lng >= -180 and lng <= 180))
+		return false;
+
+	end = position + prefix + recordSize;
+
+	return true;
+}
+
+int NewPostalCodeBuffer::uncheckedBlock (long long position) const {
+	if (position >= checkedStart and position < checkedEnd)
+		return -1;
+
+	return checksums.findBlock (position);
+}
+
+void NewPostalCodeBuffer::setChecked (int block) {
+	if (block == -1)
+		return;
+
+	checkedStart = checksums.getEntry (block).offset;
+	checkedEnd = checksums.getEnd (block);
+}
+
+void NewPostalCodeBuffer::updateHeader () {
+	// The header lists the encoding of every field
+	vector<string> fieldInfo;
+	if (fixed) {
+		headerMan.setStructure ("FIXED/FIXED");
+		headerMan.setRecordSize (fixedRecordSize);
+		fieldInfo = {
+			"zipCode/FIXED/" + to_string (fixedWidths[0]),
+			"city/FIXED/" + to_string (fixedWidths[1]),
+			"state/FIXED/" + to_string (fixedWidths[2]),
+			"county/FIXED/" + to_string (fixedWidths[3]),
+			"lat/FIXED/" + to_string (fixedWidths[4]),
+			"lng/FIXED/" + to_string (fixedWidths[5])
+		};
+	}
+	else if (binary) {
+		headerMan.setStructure ("LENGTH/BINARY");
+		headerMan.setRecordSize (0);
+		fieldInfo = {
+			"zipCode/FIXED/4",
+			"city/LENGTH/1",
+			"state/LENGTH/1",
+			"county/LENGTH/1",
+			"lat/FIXED/4",
+			"lng/FIXED/4"
+		};
+	}
+	else {
+		headerMan.setStructure ("LENGTH/DELIM");
+		headerMan.setRecordSize (0);
+		fieldInfo = {
+			"zipCode/DELIM/,",
+			"city/DELIM/,",
+			"state/DELIM/,",
+			"county/DELIM/,",
+			"lat/DELIM/,",
+			"lng/DELIM/,"
+		};
+	}
+	headerMan.setFieldInfo (fieldInfo);
+}
+
+int NewPostalCodeBuffer::encodeLength (unsigned int recordSize, char* data, unsigned short version) {
+	// Version 1 lengths are 2-byte values with the least significant byte first
+	if (version < 2) {
+		if (recordSize > 0xFFFF)
+			return -1;
+
+		data[0] = (char)recordSize;
+		data[1] = (char)(recordSize >> 8);
+		return 2;
+	}
+
+	// Version 2 lengths are varints: 7 bits per byte, least significant first, with the top bit set on every byte but the last
+	int size = 0;
+	while (recordSize >= 0x80) {
+		data[size++] = (char)(recordSize | 0x80);
+		recordSize >>= 7;
+	}
+	data[size++] = (char)recordSize;
+
+	return size;
+}
+
+int NewPostalCodeBuffer::decodeLength (const char* data, size_t available, unsigned int& recordSize, unsigned short version) {
+	const unsigned char* bytes = (const unsigned char*)data;
+
+	if (version < 2) {
+		if (available < 2)
+			return -1;
+
+		recordSize = bytes[0] | (bytes[1] << 8);
+		return 2;
+	}
+
+	// A 32-bit length needs at most 5 varint bytes
+	unsigned int size = 0;
+	for (size_t i = 0; i < available and i < (size_t)maxLengthSize; ++i) {
+		size |= (unsigned int)(bytes[i] & 0x7F) << (7 * i);
+
+		if ((bytes[i] & 0x80) == 0) {
+			// The last byte can only hold the top 4 bits
+			if (i == (size_t)maxLengthSize - 1 and bytes[i] > 0x0F)
+				return -1;
+
+			recordSize = size;
+			return i + 1;
+		}
+	}
+
+	return -1;
+}
@@ -5,17 +5,30 @@
 #include <fstream>
 #include <cstring>
 #include <vector>
+#include <cmath>
+#include <cstdint>
 #include "PostalCodeBuffer.h"
 #include "PostalCodeHeader.h"
+#include "ChecksumDirectory.h"
 
 using namespace std;
 
 // Used as a file buffer for zip code objects
 // Implemented as a length-indicated record, delimited field buffer
 // ',' is used as a field delimiter. Thus, it should not be used within any fields
-// The length is indicated by a 2-byte value at the beginning of the record
+// The length is indicated by a 2-byte value at the beginning of the record, or by a varint in version 2 files
 // It assumes that each record is stored in the following format:
 // ZipCode,PlaceName,State,County,Lat,Long
+// Binary files (structure LENGTH/BINARY) store the same fields without delimiters:
+// the zip code, lat and long are 4-byte ints, with coordinates stored in millionths of a degree,
+// and the strings are preceded by a 1-byte length. The numbers don't have to be parsed when they're read
+// Fixed-length files (structure FIXED/FIXED) use the same binary numbers, but have no length indicators
+// and pad each string with zeros to the width listed in the header. The header also lists the record size,
+// so record k starts at headerSize + k * recordSize and can be read without reading the records before it
+// Files written by the converter end with a ChecksumDirectory. Reading stops where it starts, and each block's checksum is
+// checked before its first record is used. A block that fails its checksum, or has a record that can't be read or that runs
+// into the next block, is skipped instead of ending the file. In files without checksums, reading starts again after a
+// record that can't be read at the next place where two valid records follow each other
 
 /** Used to read and write new DAT postal code files
  * @author CSCI 331 Group 4
@@ -27,17 +40,18 @@ class NewPostalCodeBuffer : public PostalCodeBuffer {
 		/** Constructor with default parameters
 		 * @param mb: the maximum number of bytes the buffer will be able to hold
 		 * @post: creates a zip code buffer object with a maximum size and initialized the buffer on the heap */
-		NewPostalCodeBuffer (int mb = 1000);
+		NewPostalCodeBuffer (int mb = 1000, bool binary = false);
 		
 		/** Destructor
 		 * @post: destroys the character array on the heap and assigns NULL to the buffer attribute */
 		virtual ~NewPostalCodeBuffer ();
 		
 		/** Reads the file header, validates it, and ensures the file uses the correct delimiter
+		 * The buffer switches to the binary or text field encoding used by the file
 		 * @param file: the file to read data from
 		 * @param indexFilename: The name of the index file, which should match the one listed in the header
 		 * @param indexSchema: The file storage scheme used by the index, which should match the one listed in the header
-		 * @post: sets the read pointer to the first character after the end of the header
+		 * @post: sets the read pointer to the first character after the end of the header and reads the checksum directory, if the file has one. If the header isn't supported, the stream is left failed
 		 * @return: returns the size of the header or -1 if an error occured*/
 		int readHeader (istream& file, const string& indexFilename, const string& indexSchema);
 
@@ -48,25 +62,241 @@ class NewPostalCodeBuffer : public PostalCodeBuffer {
 		 * @param indexSchema: The file storage scheme that will be used by the associated index
 		 * @post: sets the put pointer to the character after the buffer
 		 * @return: returns the size of the header or -1 if an error occured */
-		int writeHeader(ostream& file, unsigned short recordCount, const string& indexFilename, const string& indexSchema);
+		int writeHeader(ostream& file, unsigned long long recordCount, const string& indexFilename, const string& indexSchema);
 		
+		/** Reads a record from a fixed-length file by its record number
+		 * @param file: the file to read data from
+		 * @param recordNumber: the number of the record, starting at 0
+		 * @pre: the header has been read with readHeader
+		 * @post: seeks straight to the record with a 64-bit offset and packs the buffer
+		 * @return: returns the first character in the record or -1 if the file doesn't have fixed-length records or the record couldn't be read */
+		long long readRecord (istream& file, long long recordNumber);
+
 		/** Reads a record from the file
 		 * @param file: the file to read data from
 		 * @pre: assumes the file follows the correct data format
 		 * @post: sets the read pointer to the first character after the end of the header and packs the buffer
 		 * @return: returns the first character in the record or -1 if the end of the file was reached before the end of the record */
-		int read (istream& file);
+		long long read (istream& file);
+
+		/** Reads several records from the file into a batch
+		 * The file is read into the batch's arena in large blocks, and the records are found within the arena,
+		 * so a batch takes a few stream reads instead of two per record
+		 * @param file: the file to read data from
+		 * @param batch: the batch the records will be stored in
+		 * @param n: the largest number of records to read
+		 * @post: the batch holds the records and the read pointer is placed after the last one
+		 * @return: returns the number of records read, which is 0 once the end of the file is reached */
+		int readBatch (istream& file, PostalCodeBatch& batch, int n);
 
 		/** Writes a record to the file
 		 * @param file: the file to write data to
 		 * @pre: the file is formatted correctly
 		 * @post: sets the put pointer to the beginning of the stream and unpacks the buffer
 		 * @return: returns the first character in the record or -1 if an error occured */
-		int write(ostream& file) const;
+		long long write(ostream& file) const;
+
+		/** Packs a string as the next field of the buffer
+		 * @param field: the string to pack
+		 * @param size: the length of the string, or -1 to use strlen
+		 * @post: in binary mode, the string is preceded by its length instead of being followed by a delimiter
+		 * @return: returns the number of bytes of the string that were packed or -1 if there is an error */
+		int pack (const char* field, int size = -1);
+
+		/** Packs a whole number as the next field of the buffer
+		 * @param n: the number to pack
+		 * @post: in binary mode, the number is packed as a 4-byte int
+		 * @return: returns the number of bytes packed into the buffer or -1 if there is an error */
+		int packInt (int n);
+
+		/** Packs a coordinate as the next field of the buffer
+		 * @param value: the coordinate to pack
+		 * @post: in binary mode, the coordinate is rounded to millionths of a degree and packed as a 4-byte int
+		 * @return: returns the number of bytes packed into the buffer or -1 if there is an error */
+		int packCoordinate (double value);
+
+		/** Cuts a string field from a buffer and pastes it into a character array
+		 * @param field: the character array that the data will be pasted into
+		 * @param strLen: the maximum size of field
+		 * @post: if successful, next byte will be moved to the next field
+		 * @return: returns the length of the field or -1 if an error occured */
+		int unpack (char* field, int strLen = -1);
+
+		/** Points a view at the next string field of the buffer without copying it
+		 * @param field: set to the field's characters within the buffer
+		 * @pre: in binary mode, the next field must be a string. Numbers are unpacked with unpackInt and unpackCoordinate
+		 * @post: if successful, next byte will be moved to the next field
+		 * @return: returns the length of the field or -1 if an error occured */
+		int unpackView (string_view& field) final;
+
+		/** Unpacks the next field of the buffer as a whole number
+		 * @param n: set to the number
+		 * @post: if successful, next byte will be moved to the next field
+		 * @return: returns the number of bytes the field used or -1 if an error occured */
+		int unpackInt (int& n) final;
+
+		/** Unpacks the next field of the buffer as a coordinate
+		 * @param value: set to the coordinate
+		 * @post: if successful, next byte will be moved to the next field
+		 * @return: returns the number of bytes the field used or -1 if an error occured */
+		int unpackCoordinate (double& value) final;
+
+		/** Unpacks every field of a postal code record without copying the strings
+		 * Works for the text, binary and fixed-length records
+		 * @param zipCode: set to the zip code
+		 * @param city: set to the city's characters within the record
+		 * @param state: set to the state's characters within the record
+		 * @param county: set to the county's characters within the record
+		 * @param lat: set to the latitude
+		 * @param lng: set to the longitude
+		 * @pre: the next field is the first field of the record
+		 * @post: if successful, next byte will be moved past the record's fields
+		 * @return: returns the number of bytes the last field used or -1 if a field is missing or isn't valid */
+		int unpackRecord (int& zipCode, string_view& city, string_view& state, string_view& county, double& lat, double& lng) final;
+
+		/** Erases all data from the buffer
+		 * @post: sets the next byte, length and field number to 0 */
+		void clear ();
+
+		/** Switches between the binary and text field encodings
+		 * @param binary: true to use binary fields
+		 * @post: the header written by writeHeader describes the selected encoding. Turning binary fields off also turns off fixed-length records */
+		void setBinary (bool binary);
+
+		/** Switches between fixed-length and length-indicated records
+		 * @param fixed: true to use fixed-length records
+		 * @post: the header written by writeHeader describes the selected layout. Fixed-length records always use binary numbers */
+		void setFixed (bool fixed);
+
+		/** Sets the file version used by writeHeader, write and append
+		 * @param version: 1 for 2-byte counts and length indicators or 2 for 64-bit counts and varint length indicators
+		 * @post: records and headers will be written in the selected version */
+		void setVersion (unsigned short version);
+
+		/** Returns the file version
+		 * @return: returns the version of the file being read or written */
+		unsigned short getVersion () const;
+
+		/** Returns whether the buffer uses binary fields
+		 * @return: returns true if the numbers are stored as binary values */
+		bool isBinary () const;
+
+		/** Returns whether the buffer uses fixed-length records
+		 * @return: returns true if every record has the same size and no length indicator */
+		bool isFixed () const;
+
+		/** Returns the position of a record in a fixed-length file
+		 * @param recordNumber: the number of the record, starting at 0
+		 * @pre: the header has been read with readHeader
+		 * @return: returns the position of the record or -1 if the buffer doesn't use fixed-length records */
+		long long recordAddress (long long recordNumber) const;
+
+		/** Appends the record to a string the way write would write it to a file
+		 * @param out: the string the record is appended to
+		 * @post: adds the length indicator, unless the records are fixed-length, and the record to the end of out
+		 * @return: returns the number of bytes appended or -1 if the record can't be written */
+		int append (string& out) const;
+
+		/** Encodes the length indicator of a record
+		 * @param recordSize: the size of the record
+		 * @param data: set to the length indicator. Must have room for maxLengthSize bytes
+		 * @param version: the version of the file
+		 * @return: returns the size of the length indicator or -1 if the size is too big for the version */
+		static int encodeLength (unsigned int recordSize, char* data, unsigned short version);
+
+		/** Decodes the length indicator at the start of a record held in memory
+		 * @param data: the first byte of the length indicator
+		 * @param available: the number of bytes that can be read from data
+		 * @param recordSize: set to the size of the record that follows the length indicator
+		 * @param version: the version of the file
+		 * @return: returns the size of the length indicator or -1 if it doesn't fit within available or isn't valid */
+		static int decodeLength (const char* data, size_t available, unsigned int& recordSize, unsigned short version = 1);
+
+		/** Gets the checksum directory read by readHeader
+		 * @return: returns the directory, which is empty if the file doesn't have one */
+		const ChecksumDirectory& getChecksums () const;
+
+		/** Sets the checksum directory used to skip damaged records, for buffers that read part of a file without its header
+		 * @param checksums: the directory of the file
+		 * @post: reading stops at the end of the directory's data and skips to the next block after a damaged record */
+		void setChecksums (const ChecksumDirectory& checksums);
+
+		/** Gets the number of damaged records that reading has skipped past
+		 * @return: returns the number of times reading started again at the next checksum block or valid record */
+		int getResyncCount () const;
+
+		/** Determines if readHeader found a header the buffer can read
+		 * @return: returns false if the header was damaged or describes a version or structure the buffer doesn't support, or hasn't been read */
+		bool isSupported () const;
+
+		/** Determines if a valid record starts at a position in memory, without copying it into the buffer
+		 * @param data: the bytes that hold the record
+		 * @param size: the number of bytes that can be read from data
+		 * @param position: the position of the record's length indicator within data
+		 * @param end: set to the position after the record if it's valid
+		 * @return: returns true if the record fits, every field is present and the zip code, state and coordinates are in range, otherwise false */
+		bool isValidRecord (const char* data, size_t size, size_t position, size_t& end) const;
+
+		static const int maxLengthSize = 5; //!< The largest length indicator, which is a varint holding 32 bits
+
+		static const int fixedRecordSize; //!< The size of a fixed-length record
 	
-	private:
+	protected:
 		static const char fieldDelim = ','; //!< The character that indicates the end of a field
+
+		static const int batchBlockSize = 1 << 16; //!< The number of bytes readBatch reads at a time
+		static const int intSize = 4; //!< The size of a number in a binary record
+		static const int maxStringSize = 255; //!< The longest string whose length fits in a binary record's 1-byte length
+		static const int fieldCount = 6; //!< The number of fields in a record
+		static const int fixedWidths[fieldCount]; //!< The width of each field in a fixed-length record
+
+		/** Finds the checksum block that holds a position, if its checksum hasn't been checked yet
+		 * @param position: the position of a record
+		 * @return: returns the number of the block, or -1 if the position is in the block checked last or isn't in a block */
+		int uncheckedBlock (long long position) const;
+
+		/** Remembers the block whose checksum was just checked, so the records after the first one don't check it again
+		 * @param block: the number of the block
+		 * @post: uncheckedBlock returns -1 for positions in the block */
+		void setChecked (int block);
+
+		ChecksumDirectory checksums; //!< The checksum blocks of the file being read. Empty if it has none
+		int resyncs; //!< The number of damaged records skipped
+		long long checkedStart; //!< The position of the block whose checksum was checked last
+		long long checkedEnd; //!< The position after the block whose checksum was checked last
+		bool supported; //!< True if the header read last describes a file the buffer can read
+
+	private:
+		/** Reads the next record without skipping damaged ones
+		 * @param file: the file to read data from
+		 * @param limit: the position the record has to end by, or -1 for no limit
+		 * @return: returns the first character in the record or -1 if the record couldn't be read or runs past the limit */
+		long long readNext (istream& file, long long limit);
+
+		/** Scans the file for the next record boundary after damage, for files that don't have checksums
+		 * The file is read in large blocks and each position is tried with isValidRecord
+		 * @param file: the file to scan
+		 * @param from: the first position to try
+		 * @post: the read pointer is moved
+		 * @return: returns the position of the first record at or after from that is valid and is followed by another valid record or the end of the file, or the end of the file if there's none */
+		long long findRecord (istream& file, long long from);
+
+		/** Checks a block against its checksum by reading it from the file
+		 * @param file: the file to read the block from
+		 * @param block: the number of the block
+		 * @post: the read pointer is put back where it was
+		 * @return: returns true if the whole block was read and its checksum matches, otherwise false */
+		bool verifyBlock (istream& file, int block);
+
+		/** Describes the current field encoding and record layout in the header manager
+		 * @post: sets the structure, record size and field schema that writeHeader will write */
+		void updateHeader ();
+
 		PostalCodeHeader headerMan; //!< The header manager for the postal code buffer
+		bool binary; //!< True if the fields use the binary encoding
+		bool fixed; //!< True if the records have a fixed length and no length indicator
+		int fieldIndex; //!< The number of fields packed or unpacked from the current record
+		long long dataStart; //!< The position of the first record, or -1 if the header hasn't been read
 };
 
 #include "NewPostalCodeBuffer.cpp"
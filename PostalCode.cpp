@@ -1,61 +1,82 @@
-#include "PostalCode.h"
-
-PostalCode::PostalCode () : zipCode (-1), city ("City"), state ("NA"), county ("County"), lat (0), lng (0) {}
-
-
-	// MODIFICATION METHODS
-void PostalCode::setZipCode (int n) {
-	zipCode = n;
-}
-
-void PostalCode::setCity (string s) {
-	city = s;
-}
-
-void PostalCode::setState (string s) {
-	state = s;
-}
-
-void PostalCode::setCounty (string s) {
-	county = s;
-}
-
-void PostalCode::setLat (double n) {
-	lat = n;
-}
-
-void PostalCode::setLong (double n) {
-	lng = n;
-}
-	
-	
-	// CONSTANT METHODS
-int PostalCode::getZipCode () const {
-	return zipCode;
-}
-
-string PostalCode::getCity () const {
-	return city;
-}
-
-string PostalCode::getState () const {
-	return state;
-}
-
-string PostalCode::getCounty () const {
-	return county;
-}
-
-double PostalCode::getLat () const {
-	return lat;
-}
-
-double PostalCode::getLong () const {
-	return lng;
-}
-
-void PostalCode::print () const {
-	cout << zipCode << ", " << city << ", " << state << ", " << county << ", " << lat << ", " << lng << endl;
-	
-	return;
+#include "PostalCode.h"
+
+const unsigned int PostalCode::defaultCity = StringPool::global ().intern ("City");
+const unsigned int PostalCode::defaultState = StringPool::global ().intern ("NA");
+const unsigned int PostalCode::defaultCounty = StringPool::global ().intern ("County");
+
+PostalCode::PostalCode () : zipCode (-1), city (defaultCity), state (defaultState), county (defaultCounty), pool (&StringPool::current ()), lat (0), lng (0) {}
+
+
+	// MODIFICATION METHODS
+void PostalCode::setZipCode (int n) {
+	zipCode = n;
+}
+
+void PostalCode::setCity (string_view s) {
+	city = pool->intern (s);
+}
+
+void PostalCode::setState (string_view s) {
+	state = pool->intern (s);
+}
+
+void PostalCode::setCounty (string_view s) {
+	county = pool->intern (s);
+}
+
+void PostalCode::setLat (double n) {
+	lat = n;
+}
+
+void PostalCode::setLong (double n) {
+	lng = n;
+}
+
+void PostalCode::moveStrings (const vector<unsigned int>& ids, StringPool& to) {
+	city = ids[city];
+	state = ids[state];
+	county = ids[county];
+	pool = &to;
+}
+
+unique_ptr<StringPool> PostalCode::createPool () {
+	unique_ptr<StringPool> pool (new StringPool ());
+
+	// The defaults were the first strings added to the global pool, so adding them first here gives them the same IDs
+	for (unsigned int id = 0; id <= max ({defaultCity, defaultState, defaultCounty}); ++id)
+		pool->intern (StringPool::global ().get (id));
+
+	return pool;
+}
+	
+	
+	// CONSTANT METHODS
+int PostalCode::getZipCode () const {
+	return zipCode;
+}
+
+string_view PostalCode::getCity () const {
+	return pool->get (city);
+}
+
+string_view PostalCode::getState () const {
+	return pool->get (state);
+}
+
+string_view PostalCode::getCounty () const {
+	return pool->get (county);
+}
+
+double PostalCode::getLat () const {
+	return lat;
+}
+
+double PostalCode::getLong () const {
+	return lng;
+}
+
+void PostalCode::print () const {
+	cout << zipCode << ", " << getCity () << ", " << getState () << ", " << getCounty () << ", " << lat << ", " << lng << endl;
+	
+	return;
 }
\ No newline at end of file
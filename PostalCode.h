@@ -1,89 +1,114 @@
-#ifndef PostalCode_
-#define PostalCode_
-
-#include <iostream>
-
-using namespace std;
-
-/** Contains postal code information for a US city 
- * @author CSCI 331 Group 4
- * @date 2023-11-09
- */
-class PostalCode {
-	public:
-			// CONSTRUCTORS
-		/** Constructor that sets default values
-		 * @post: creates a postal code object with default values that need to be set later */
-		PostalCode ();
-		
-			// MODIFICATION METHODS
-		/** Sets the zip code value
-		 * @param n: the new zip code value
-		 * @post: sets the value of the zip code */
-		void setZipCode (int n);
-		
-		/** Sets the city value
-		 * @param s: the new city value
-		 * @post: sets the value of the city */
-		void setCity (string s);
-		
-		/** Sets the state value
-		 * @param s: the new state value
-		 * @post: sets the value of the state */
-		void setState (string s);
-		
-		/** Sets the county value
-		 * @param s: the new zip code value
-		 * @post: sets the value of the county */
-		void setCounty (string s);
-		
-		/** Sets the latitude value
-		 * @param n: the new latitude value
-		 * @post: sets the value of the latitude */
-		void setLat (double n);
-		
-		/** Sets the longitude value
-		 * @param n: the new longitude value
-		 * @post: sets the value of the longitude */
-		void setLong (double n);
-			
-			// CONSTANT METHODS
-		/** Gets the value of the zip code
-		 * @return: returns the zip code value */
-		int getZipCode () const;
-		
-		/** Gets the value of the city
-		 * @return: returns the city value */
-		string getCity () const;
-		
-		/** Gets the value of the state
-		 * @return: returns the state value */
-		string getState () const;
-		
-		/** Gets the value of the county
-		 * @return: returns the county value */
-		string getCounty () const;
-		
-		/** Gets the value of the latitude
-		 * @return: returns the latitude value */
-		double getLat () const;
-		
-		/** Gets the value of the longitude
-		 * @return: returns the longitude value */
-		double getLong () const;
-		
-		/** Prints the attributes to the screen
-		 * @post: the object's attributes will be printed to the screen via cout */
-		void print () const;
-	
-	private:
-		int zipCode; //!< The zip code of the area
-		string city; //!< The city of the area
-		string state; //!< The state of the area
-		string county; //!< The county of the area
-		double lat; //!< The latitude of the area
-		double lng; //!< The longitude of the area
-};
-
-#include "PostalCode.cpp"
+#ifndef PostalCode_
+#define PostalCode_
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include "StringPool.h"
+
+using namespace std;
+
+/** Contains postal code information for a US city 
+ * The city, state and county are interned in a string pool, so each postal code only holds their IDs
+ * and the many postal codes that share a state or county share one copy of its name
+ * Each postal code keeps the pool its IDs belong to, which is the calling thread's StringPool::current when it's created,
+ * so it can be read on any thread for as long as that pool exists
+ * @author CSCI 331 Group 4
+ * @date 2023-11-09
+ */
+class PostalCode {
+	public:
+			// CONSTRUCTORS
+		/** Constructor that sets default values
+		 * @post: creates a postal code object with default values that need to be set later. Its strings are interned in StringPool::current */
+		PostalCode ();
+		
+			// MODIFICATION METHODS
+		/** Sets the zip code value
+		 * @param n: the new zip code value
+		 * @post: sets the value of the zip code */
+		void setZipCode (int n);
+		
+		/** Sets the city value
+		 * @param s: the new city value
+		 * @post: sets the value of the city */
+		void setCity (string_view s);
+		
+		/** Sets the state value
+		 * @param s: the new state value
+		 * @post: sets the value of the state */
+		void setState (string_view s);
+		
+		/** Sets the county value
+		 * @param s: the new zip code value
+		 * @post: sets the value of the county */
+		void setCounty (string_view s);
+		
+		/** Sets the latitude value
+		 * @param n: the new latitude value
+		 * @post: sets the value of the latitude */
+		void setLat (double n);
+		
+		/** Sets the longitude value
+		 * @param n: the new longitude value
+		 * @post: sets the value of the longitude */
+		void setLong (double n);
+
+		/** Changes the city, state and county to their IDs in another pool
+		 * @param ids: the ID in the other pool of each string, by its ID in the pool the postal code was filled from, as filled by StringPool::merge
+		 * @param to: the pool the strings were merged into
+		 * @post: the postal code's strings are read from the other pool */
+		void moveStrings (const vector<unsigned int>& ids, StringPool& to);
+
+		/** Creates a pool for the postal codes of one thread
+		 * @return: returns a pool that holds the default city, state and county with the same IDs as the global pool */
+		static unique_ptr<StringPool> createPool ();
+			
+			// CONSTANT METHODS
+		/** Gets the value of the zip code
+		 * @return: returns the zip code value */
+		int getZipCode () const;
+		
+		/** Gets the value of the city
+		 * @return: returns the city value, which stays valid for the life of its pool */
+		string_view getCity () const;
+		
+		/** Gets the value of the state
+		 * @return: returns the state value, which stays valid for the life of its pool */
+		string_view getState () const;
+		
+		/** Gets the value of the county
+		 * @return: returns the county value, which stays valid for the life of its pool */
+		string_view getCounty () const;
+		
+		/** Gets the value of the latitude
+		 * @return: returns the latitude value */
+		double getLat () const;
+		
+		/** Gets the value of the longitude
+		 * @return: returns the longitude value */
+		double getLong () const;
+		
+		/** Prints the attributes to the screen
+		 * @post: the object's attributes will be printed to the screen via cout */
+		void print () const;
+	
+	private:
+		int zipCode; //!< The zip code of the area
+		unsigned int city; //!< The ID of the city of the area in the string pool
+		unsigned int state; //!< The ID of the state of the area in the string pool
+		unsigned int county; //!< The ID of the county of the area in the string pool
+		StringPool* pool; //!< The pool the city, state and county IDs belong to
+		double lat; //!< The latitude of the area
+		double lng; //!< The longitude of the area
+
+		static const unsigned int defaultCity; //!< The ID of the default city, interned once
+		static const unsigned int defaultState; //!< The ID of the default state, interned once
+		static const unsigned int defaultCounty; //!< The ID of the default county, interned once
+};
+
+#include "PostalCode.cpp"
 #endif
\ No newline at end of file
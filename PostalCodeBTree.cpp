@@ -0,0 +1,497 @@
+#include "PostalCodeBTree.h"
+
+	// CONSTRUCTORS
+PostalCodeBTree::PostalCodeBTree (int ps, int poolPages) : pool (ps, poolPages), pageSize (ps), root (0), height (0), firstLeaf (0), count (0) {
+	leafCapacity = (pageSize - pageHeaderSize) / leafEntrySize;
+	innerCapacity = (pageSize - pageHeaderSize - 4) / innerEntrySize;
+}
+
+PostalCodeBTree::~PostalCodeBTree () {
+	close ();
+}
+
+
+	// MODIFICATION METHODS
+bool PostalCodeBTree::create (const string& filename) {
+	unsigned int page;
+
+	if (pool.open (filename, true) == false or pool.allocate (page) == NULL)
+		return false;
+	pool.unpin (page, true);
+
+	// The root of an empty tree is an empty leaf
+	char* data = pool.allocate (root);
+	if (data == NULL)
+		return false;
+
+	data[0] = leafPage;
+	pool.unpin (root, true);
+
+	height = 1;
+	firstLeaf = root;
+	count = 0;
+
+	return writeMeta ();
+}
+
+bool PostalCodeBTree::open (const string& filename) {
+	if (pool.open (filename, false) == false)
+		return false;
+
+	const char* data = pool.pin (0);
+	if (data == NULL)
+		return false;
+
+	int storedSize;
+	bool valid = memcmp (data, "PCBTREE1", 8) == 0;
+	memcpy (&storedSize, data + 8, 4);
+	memcpy (&root, data + 12, 4);
+	memcpy (&height, data + 16, 4);
+	memcpy (&firstLeaf, data + 20, 4);
+	memcpy (&count, data + 24, 8);
+	pool.unpin (0, false);
+
+	if (valid == false or storedSize != pageSize or height < 1 or root >= pool.getPageCount () or firstLeaf >= pool.getPageCount ()) {
+		pool.close ();
+		return false;
+	}
+
+	return true;
+}
+
+bool PostalCodeBTree::close () {
+	return pool.close ();
+}
+
+long long PostalCodeBTree::build (const string& dataFilename, const string& filename, NewPostalCodeBuffer* reader) {
+	ifstream infile (dataFilename.c_str (), ios::binary);
+	PostalCodeHeader header;
+	NewPostalCodeBuffer local;
+	NewPostalCodeBuffer& buffer = reader != NULL ? *reader : local;
+	vector<pair<int, long long> > entries;
+
+	if (!infile.is_open () or header.readHeader (infile) == -1)
+		return -1;
+
+	// Validates the header against itself to place the read pointer at the first record
+	if (buffer.readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1)
+		return -1;
+
+	// Collects the zip code and offset of every record
+	long long recaddr;
+	while ((recaddr = buffer.read (infile)) != -1) {
+		int zip;
+		if (buffer.unpackInt (zip) == -1)
+			return -1;
+
+		entries.push_back (make_pair (zip, recaddr));
+	}
+	infile.close ();
+
+	// Stable so duplicate keys keep their file order
+	stable_sort (entries.begin (), entries.end (), [](const pair<int, long long>& a, const pair<int, long long>& b) {
+		return a.first < b.first;
+	});
+
+	if (bulkLoad (entries, filename) == false)
+		return -1;
+
+	return entries.size ();
+}
+
+bool PostalCodeBTree::bulkLoad (const vector<pair<int, long long> >& entries, const string& filename) {
+	if (entries.empty ())
+		return create (filename);
+
+	unsigned int page;
+	if (pool.open (filename, true) == false or pool.allocate (page) == NULL)
+		return false;
+	pool.unpin (page, true);
+
+	// Each level is a list of its pages and the first key in each one
+	vector<pair<int, unsigned int> > level;
+	size_t n = entries.size ();
+	size_t pages = (n + leafCapacity - 1) / leafCapacity;
+
+	// The leaves are allocated one after another, so each one's next leaf is the page after it
+	for (size_t p = 0; p < pages; ++p) {
+		size_t begin = n * p / pages;
+		size_t end = n * (p + 1) / pages;
+		char* data = pool.allocate (page);
+
+		if (data == NULL)
+			return false;
+
+		data[0] = leafPage;
+		setCount (data, end - begin);
+		setNext (data, p + 1 < pages ? page + 1 : 0);
+		for (size_t i = begin; i < end; ++i)
+			setLeaf (data, i - begin, entries[i].first, entries[i].second);
+
+		pool.unpin (page, true);
+		level.push_back (make_pair (entries[begin].first, page));
+	}
+
+	firstLeaf = level[0].second;
+	height = 1;
+
+	// Builds each level of internal pages above the one below it until a single page is left
+	while (level.size () > 1) {
+		vector<pair<int, unsigned int> > above;
+		size_t children = level.size ();
+		pages = (children + innerCapacity) / (innerCapacity + 1);
+
+		for (size_t p = 0; p < pages; ++p) {
+			size_t begin = children * p / pages;
+			size_t end = children * (p + 1) / pages;
+			char* data = pool.allocate (page);
+
+			if (data == NULL)
+				return false;
+
+			data[0] = innerPage;
+			setCount (data, end - begin - 1);
+			memcpy (data + pageHeaderSize, &level[begin].second, 4);
+			for (size_t i = begin + 1; i < end; ++i)
+				setInner (data, i - begin - 1, level[i].first, level[i].second);
+
+			pool.unpin (page, true);
+			above.push_back (make_pair (level[begin].first, page));
+		}
+
+		level.swap (above);
+		height += 1;
+	}
+
+	root = level[0].second;
+	count = n;
+
+	return writeMeta () and pool.flush ();
+}
+
+bool PostalCodeBTree::insert (int zipCode, long long recaddr) {
+	bool split = false;
+	int splitKey;
+	unsigned int splitPage;
+
+	if (height < 1 or insertInto (root, height, zipCode, recaddr, split, splitKey, splitPage) == false)
+		return false;
+
+	// A split root gets a new root above it
+	if (split) {
+		unsigned int page;
+		char* data = pool.allocate (page);
+
+		if (data == NULL)
+			return false;
+
+		data[0] = innerPage;
+		setCount (data, 1);
+		memcpy (data + pageHeaderSize, &root, 4);
+		setInner (data, 0, splitKey, splitPage);
+		pool.unpin (page, true);
+
+		root = page;
+		height += 1;
+	}
+
+	count += 1;
+
+	return writeMeta ();
+}
+
+
+	// CONSTANT METHODS
+long long PostalCodeBTree::find (int zipCode) {
+	vector<pair<int, long long> > results;
+
+	// The first match is all that's needed, so the range stops at the first leaf with a larger zip code
+	if (range (zipCode, zipCode, results) <= 0)
+		return -1;
+
+	return results[0].second;
+}
+
+long long PostalCodeBTree::range (int low, int high, vector<pair<int, long long> >& results) {
+	results.clear ();
+
+	if (height < 1 or low > high)
+		return 0;
+
+	unsigned int page = findLeaf (low, false);
+	if (page == 0)
+		return -1;
+
+	// Reads the leaves from left to right until a zip code past the range is found
+	while (page != 0) {
+		const char* data = pool.pin (page);
+		if (data == NULL)
+			return -1;
+
+		int entries = getCount (data);
+		int i = 0;
+		while (i < entries and leafKey (data, i) < low)
+			i += 1;
+
+		for (; i < entries; ++i) {
+			int key = leafKey (data, i);
+
+			if (key > high) {
+				pool.unpin (page, false);
+				return results.size ();
+			}
+
+			results.push_back (make_pair (key, leafPosition (data, i)));
+		}
+
+		unsigned int next = getNext (data);
+		pool.unpin (page, false);
+		page = next;
+	}
+
+	return results.size ();
+}
+
+long long PostalCodeBTree::size () const {
+	return count;
+}
+
+int PostalCodeBTree::getHeight () const {
+	return height;
+}
+
+long long PostalCodeBTree::getPageReads () const {
+	return pool.getReads ();
+}
+
+
+	// HELPER FUNCTIONS
+unsigned int PostalCodeBTree::findLeaf (int zipCode, bool after) {
+	unsigned int page = root;
+
+	for (int level = height; level > 1; --level) {
+		const char* data = pool.pin (page);
+		if (data == NULL)
+			return 0;
+
+		unsigned int child = innerChild (data, childIndex (data, zipCode, after));
+		pool.unpin (page, false);
+		page = child;
+	}
+
+	return page;
+}
+
+bool PostalCodeBTree::insertInto (unsigned int page, int level, int zipCode, long long recaddr, bool& split, int& splitKey, unsigned int& splitPage) {
+	split = false;
+
+	if (level == 1) {
+		char* data = pool.pin (page);
+		if (data == NULL)
+			return false;
+
+		// Goes after any entries with the same zip code
+		int entries = getCount (data);
+		int pos = 0;
+		while (pos < entries and leafKey (data, pos) <= zipCode)
+			pos += 1;
+
+		if (entries < leafCapacity) {
+			char* at = data + pageHeaderSize + pos * leafEntrySize;
+			memmove (at + leafEntrySize, at, (entries - pos) * leafEntrySize);
+			setLeaf (data, pos, zipCode, recaddr);
+			setCount (data, entries + 1);
+			pool.unpin (page, true);
+
+			return true;
+		}
+
+		// A full leaf gives the upper half of its entries and the new one to a new leaf after it
+		char* right = pool.allocate (splitPage);
+		if (right == NULL) {
+			pool.unpin (page, false);
+			return false;
+		}
+
+		vector<char> all ((entries + 1) * leafEntrySize);
+		memcpy (all.data (), data + pageHeaderSize, pos * leafEntrySize);
+		memcpy (all.data () + pos * leafEntrySize, &zipCode, 4);
+		memcpy (all.data () + pos * leafEntrySize + 4, &recaddr, 8);
+		memcpy (all.data () + (pos + 1) * leafEntrySize, data + pageHeaderSize + pos * leafEntrySize, (entries - pos) * leafEntrySize);
+
+		int leftCount = (entries + 1) / 2;
+		memcpy (data + pageHeaderSize, all.data (), leftCount * leafEntrySize);
+		memcpy (right + pageHeaderSize, all.data () + leftCount * leafEntrySize, (entries + 1 - leftCount) * leafEntrySize);
+
+		right[0] = leafPage;
+		setCount (right, entries + 1 - leftCount);
+		setNext (right, getNext (data));
+		setCount (data, leftCount);
+		setNext (data, splitPage);
+
+		split = true;
+		splitKey = leafKey (right, 0);
+		pool.unpin (splitPage, true);
+		pool.unpin (page, true);
+
+		return true;
+	}
+
+	// Finds the child to follow, then lets the page go so only one page per level is ever pinned
+	const char* path = pool.pin (page);
+	if (path == NULL)
+		return false;
+
+	int pos = childIndex (path, zipCode, true);
+	unsigned int child = innerChild (path, pos);
+	pool.unpin (page, false);
+
+	bool childSplit;
+	int childKey;
+	unsigned int childPage;
+	if (insertInto (child, level - 1, zipCode, recaddr, childSplit, childKey, childPage) == false)
+		return false;
+	if (childSplit == false)
+		return true;
+
+	// The new child goes right after the child that split
+	char* data = pool.pin (page);
+	if (data == NULL)
+		return false;
+
+	int entries = getCount (data);
+	if (entries < innerCapacity) {
+		char* at = data + pageHeaderSize + 4 + pos * innerEntrySize;
+		memmove (at + innerEntrySize, at, (entries - pos) * innerEntrySize);
+		setInner (data, pos, childKey, childPage);
+		setCount (data, entries + 1);
+		pool.unpin (page, true);
+
+		return true;
+	}
+
+	// A full internal page keeps its lower half, moves the middle key up and gives its upper half to a new page
+	char* right = pool.allocate (splitPage);
+	if (right == NULL) {
+		pool.unpin (page, false);
+		return false;
+	}
+
+	vector<char> all ((entries + 1) * innerEntrySize);
+	char* first = data + pageHeaderSize + 4;
+	memcpy (all.data (), first, pos * innerEntrySize);
+	memcpy (all.data () + pos * innerEntrySize, &childKey, 4);
+	memcpy (all.data () + pos * innerEntrySize + 4, &childPage, 4);
+	memcpy (all.data () + (pos + 1) * innerEntrySize, first + pos * innerEntrySize, (entries - pos) * innerEntrySize);
+
+	int leftCount = (entries + 1) / 2;
+	memcpy (first, all.data (), leftCount * innerEntrySize);
+	memcpy (&splitKey, all.data () + leftCount * innerEntrySize, 4);
+	memcpy (right + pageHeaderSize, all.data () + leftCount * innerEntrySize + 4, 4);
+	memcpy (right + pageHeaderSize + 4, all.data () + (leftCount + 1) * innerEntrySize, (entries - leftCount) * innerEntrySize);
+
+	right[0] = innerPage;
+	setCount (right, entries - leftCount);
+	setCount (data, leftCount);
+
+	split = true;
+	pool.unpin (splitPage, true);
+	pool.unpin (page, true);
+
+	return true;
+}
+
+bool PostalCodeBTree::writeMeta () {
+	char* data = pool.pin (0);
+	if (data == NULL)
+		return false;
+
+	memcpy (data, "PCBTREE1", 8);
+	memcpy (data + 8, &pageSize, 4);
+	memcpy (data + 12, &root, 4);
+	memcpy (data + 16, &height, 4);
+	memcpy (data + 20, &firstLeaf, 4);
+	memcpy (data + 24, &count, 8);
+	pool.unpin (0, true);
+
+	return true;
+}
+
+int PostalCodeBTree::childIndex (const char* data, int zipCode, bool after) {
+	int low = 0;
+	int high = getCount (data);
+
+	// Counts the keys less than the zip code, or not greater than it when after is true
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+		int key = innerKey (data, mid);
+
+		if (key < zipCode or (after and key == zipCode))
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low;
+}
+
+int PostalCodeBTree::getCount (const char* data) {
+	unsigned short n;
+	memcpy (&n, data + 2, 2);
+
+	return n;
+}
+
+void PostalCodeBTree::setCount (char* data, int count) {
+	unsigned short n = count;
+	memcpy (data + 2, &n, 2);
+}
+
+unsigned int PostalCodeBTree::getNext (const char* data) {
+	unsigned int page;
+	memcpy (&page, data + 4, 4);
+
+	return page;
+}
+
+void PostalCodeBTree::setNext (char* data, unsigned int page) {
+	memcpy (data + 4, &page, 4);
+}
+
+int PostalCodeBTree::leafKey (const char* data, int i) {
+	int key;
+	memcpy (&key, data + pageHeaderSize + i * leafEntrySize, 4);
+
+	return key;
+}
+
+long long PostalCodeBTree::leafPosition (const char* data, int i) {
+	long long recaddr;
+	memcpy (&recaddr, data + pageHeaderSize + i * leafEntrySize + 4, 8);
+
+	return recaddr;
+}
+
+void PostalCodeBTree::setLeaf (char* data, int i, int zipCode, long long recaddr) {
+	memcpy (data + pageHeaderSize + i * leafEntrySize, &zipCode, 4);
+	memcpy (data + pageHeaderSize + i * leafEntrySize + 4, &recaddr, 8);
+}
+
+int PostalCodeBTree::innerKey (const char* data, int i) {
+	int key;
+	memcpy (&key, data + pageHeaderSize + 4 + i * innerEntrySize, 4);
+
+	return key;
+}
+
+unsigned int PostalCodeBTree::innerChild (const char* data, int i) {
+	unsigned int child;
+	memcpy (&child, data + pageHeaderSize + i * innerEntrySize, 4);
+
+	return child;
+}
+
+void PostalCodeBTree::setInner (char* data, int i, int key, unsigned int child) {
+	memcpy (data + pageHeaderSize + 4 + i * innerEntrySize, &key, 4);
+	memcpy (data + pageHeaderSize + 8 + i * innerEntrySize, &child, 4);
+}
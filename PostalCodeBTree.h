@@ -0,0 +1,173 @@
+#ifndef PostalCodeBTree_
+#define PostalCodeBTree_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "BufferPool.h"
+#include "PostalCodeHeader.h"
+#include "NewPostalCodeBuffer.h"
+
+using namespace std;
+
+/* A B+-tree on zip code, stored on disk in fixed-size pages and read through a BufferPool
+Each leaf entry holds a zip code and the offset of its record in the DAT file, which can be passed to PostalCodeBuffer::dRead
+The leaves are linked from left to right, so a range search finds its first leaf and then reads the leaves after it,
+costing O(log n + k) page reads. Only the pages on that path are read, so the tree can be much bigger than the pool
+Page 0 describes the tree:
+	"PCBTREE1" - 8 bytes
+	page size, root page, height (1 when the root is a leaf), first leaf - 4 bytes each
+	entry count - 8 bytes
+Every other page starts with an 8-byte header: its type (1 byte: 1 = leaf, 2 = internal), an unused byte, its entry count (2 bytes)
+and, for leaves, the page of the next leaf (4 bytes, 0 for the last leaf)
+	leaf entries - a 4-byte zip code and an 8-byte record offset
+	internal entries - the first child (4 bytes), then a 4-byte key and 4-byte child for each entry.
+		Every key in a child is at least the key before it and at most the key after it
+Numbers are stored in the machine's byte order, like the sizes in the DAT header
+Duplicate zip codes are allowed and keep the order they were added in
+*/
+
+/** Used to search a DAT file by zip code and zip code range through a disk-resident B+-tree
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class PostalCodeBTree {
+	public:
+			// CONSTRUCTORS
+		/** Constructor with default parameters
+		 * @param ps: the size of each page in bytes, used when a tree is created
+		 * @param poolPages: the number of pages the buffer pool holds
+		 * @post: creates a tree that isn't attached to a file */
+		PostalCodeBTree (int ps = 4096, int poolPages = 64);
+
+		/** Destructor
+		 * @post: writes any changes and closes the file */
+		~PostalCodeBTree ();
+
+			// MODIFICATION METHODS
+		/** Creates an empty tree, replacing any file with the same name
+		 * @param filename: the name of the tree file
+		 * @post: the tree is open and empty
+		 * @return: returns true if the tree was created, otherwise false */
+		bool create (const string& filename);
+
+		/** Opens an existing tree
+		 * @param filename: the name of the tree file
+		 * @post: the tree can be searched and added to
+		 * @return: returns true if the file holds a tree, otherwise false */
+		bool open (const string& filename);
+
+		/** Writes any changes and closes the tree
+		 * @return: returns true if the changes were written, otherwise false */
+		bool close ();
+
+		/** Creates a tree from the records of a DAT file
+		 * @param dataFilename: the DAT file to index
+		 * @param filename: the name of the tree file, which is replaced
+		 * @param reader: the buffer used to read the DAT file. If NULL, a NewPostalCodeBuffer is used
+		 * @post: the tree is open and holds every record of the DAT file
+		 * @return: returns the number of entries or -1 if an error occured */
+		long long build (const string& dataFilename, const string& filename, NewPostalCodeBuffer* reader = NULL);
+
+		/** Creates a tree from entries sorted by zip code, filling the pages from left to right
+		 * @param entries: the zip codes and record offsets, sorted by zip code
+		 * @param filename: the name of the tree file, which is replaced
+		 * @post: the tree is open and holds the entries. The pages of each level are filled as evenly as possible
+		 * @return: returns true if the tree was written, otherwise false */
+		bool bulkLoad (const vector<pair<int, long long> >& entries, const string& filename);
+
+		/** Adds an entry, splitting full pages
+		 * @param zipCode: the zip code
+		 * @param recaddr: the offset of the record in the DAT file
+		 * @pre: the tree is open
+		 * @post: the entry is added after any entries with the same zip code
+		 * @return: returns true if the entry was added, otherwise false */
+		bool insert (int zipCode, long long recaddr);
+
+			// CONSTANT METHODS
+		/** Finds the first record with a zip code
+		 * @param zipCode: the zip code to find
+		 * @return: returns the offset of the record or -1 if the zip code isn't in the tree */
+		long long find (int zipCode);
+
+		/** Finds every record in a range of zip codes
+		 * @param low: the lowest zip code to find
+		 * @param high: the highest zip code to find
+		 * @param results: the vector that will receive the zip codes and record offsets in zip code order
+		 * @return: returns the number of records found or -1 if a page couldn't be read */
+		long long range (int low, int high, vector<pair<int, long long> >& results);
+
+		/** Gets the number of entries
+		 * @return: returns the number of entries in the tree */
+		long long size () const;
+
+		/** Gets the height of the tree
+		 * @return: returns the number of pages on the path from the root to a leaf */
+		int getHeight () const;
+
+		/** Gets the number of pages read from the file
+		 * @return: returns the reads since the tree was opened, not counting pages already in the pool */
+		long long getPageReads () const;
+
+	private:
+		/** Finds the leaf that would hold a zip code
+		 * @param zipCode: the zip code
+		 * @param after: whether to find the leaf after any entries with the same zip code instead of the leaf before them
+		 * @return: returns the page of the leaf or 0 if a page couldn't be read */
+		unsigned int findLeaf (int zipCode, bool after);
+
+		/** Adds an entry to a subtree
+		 * @param page: the root page of the subtree
+		 * @param level: the height of the subtree
+		 * @param zipCode: the zip code
+		 * @param recaddr: the offset of the record
+		 * @param split: set to true if the page was split
+		 * @param splitKey: set to the first key of the new page when the page was split
+		 * @param splitPage: set to the new page when the page was split
+		 * @return: returns true if the entry was added, otherwise false */
+		bool insertInto (unsigned int page, int level, int zipCode, long long recaddr, bool& split, int& splitKey, unsigned int& splitPage);
+
+		/** Writes the tree's description to page 0
+		 * @return: returns true if the page was written, otherwise false */
+		bool writeMeta ();
+
+		/** Finds the child of an internal page to follow for a zip code
+		 * @param data: the page
+		 * @param zipCode: the zip code
+		 * @param after: whether to follow the child after keys equal to the zip code
+		 * @return: returns the position of the child */
+		static int childIndex (const char* data, int zipCode, bool after);
+
+		// Page layout helpers
+		static int getCount (const char* data);
+		static void setCount (char* data, int count);
+		static unsigned int getNext (const char* data);
+		static void setNext (char* data, unsigned int page);
+		static int leafKey (const char* data, int i);
+		static long long leafPosition (const char* data, int i);
+		static void setLeaf (char* data, int i, int zipCode, long long recaddr);
+		static int innerKey (const char* data, int i);
+		static unsigned int innerChild (const char* data, int i);
+		static void setInner (char* data, int i, int key, unsigned int child);
+
+		static const int pageHeaderSize = 8; //!< The size of each page's header
+		static const int leafEntrySize = 12; //!< The size of a leaf entry
+		static const int innerEntrySize = 8; //!< The size of an internal entry
+		static const char leafPage = 1; //!< The type of a leaf page
+		static const char innerPage = 2; //!< The type of an internal page
+
+		BufferPool pool; //!< The pages of the tree file
+		int pageSize; //!< The size of each page
+		int leafCapacity; //!< The most entries a leaf holds
+		int innerCapacity; //!< The most keys an internal page holds
+		unsigned int root; //!< The root page
+		int height; //!< The number of pages from the root to a leaf
+		unsigned int firstLeaf; //!< The leftmost leaf
+		long long count; //!< The number of entries
+};
+
+#include "PostalCodeBTree.cpp"
+#endif
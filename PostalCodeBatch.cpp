@@ -0,0 +1,84 @@
+#include "PostalCodeBatch.h"
+
+	// CONSTRUCTORS
+PostalCodeBatch::PostalCodeBatch () : used (0) {}
+
+
+	// MODIFICATION METHODS
+void PostalCodeBatch::add (const char* record, int size, long long recaddr) {
+	size_t offset = used;
+
+	memcpy (extend (size), record, size);
+	addStored (offset, size, recaddr);
+}
+
+void PostalCodeBatch::addStored (size_t offset, int size, long long recaddr) {
+	offsets.push_back (offset);
+	sizes.push_back (size);
+	addresses.push_back (recaddr);
+}
+
+void PostalCodeBatch::setFields (const int* bounds, int count) {
+	// Records added since the last one with fields don't have any
+	fieldsEnd.resize (offsets.size () - 1, fieldBounds.size ());
+	fieldBounds.insert (fieldBounds.end (), bounds, bounds + 2 * count);
+	fieldsEnd.push_back (fieldBounds.size ());
+}
+
+char* PostalCodeBatch::extend (size_t size) {
+	// Grows by at least half, so adding records one at a time doesn't reallocate every time
+	if (used + size > arena.size ())
+		arena.resize (max (used + size, arena.size () + arena.size () / 2));
+
+	used += size;
+
+	return arena.data () + used - size;
+}
+
+void PostalCodeBatch::truncate (size_t size) {
+	if (size < used)
+		used = size;
+}
+
+void PostalCodeBatch::clear () {
+	used = 0;
+	offsets.clear ();
+	sizes.clear ();
+	addresses.clear ();
+	fieldBounds.clear ();
+	fieldsEnd.clear ();
+}
+
+
+	// CONSTANT METHODS
+string_view PostalCodeBatch::getRecord (int i) const {
+	return string_view (arena.data () + offsets[i], sizes[i]);
+}
+
+long long PostalCodeBatch::getAddress (int i) const {
+	return addresses[i];
+}
+
+const int* PostalCodeBatch::getFields (int i, int& count) const {
+	if ((size_t)i >= fieldsEnd.size ()) {
+		count = 0;
+		return NULL;
+	}
+
+	size_t start = i == 0 ? 0 : fieldsEnd[i - 1];
+	count = (fieldsEnd[i] - start) / 2;
+
+	return count > 0 ? fieldBounds.data () + start : NULL;
+}
+
+int PostalCodeBatch::size () const {
+	return offsets.size ();
+}
+
+const char* PostalCodeBatch::data () const {
+	return arena.data ();
+}
+
+size_t PostalCodeBatch::arenaSize () const {
+	return used;
+}
@@ -0,0 +1,107 @@
+#ifndef PostalCodeBatch_
+#define PostalCodeBatch_
+
+#include <iostream>
+#include <cstring>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// Holds a group of records read from a postal code file at once
+// The records are stored in a single arena, so reading a batch doesn't allocate memory once the arena has grown to fit one
+// Each record is found by its offset and size within the arena. Records don't have to be next to each other,
+// so a reader can fill the arena straight from the file and leave the length indicators between the records
+
+/** Used to read and decode many postal code records at a time
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class PostalCodeBatch {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an empty batch */
+		PostalCodeBatch ();
+
+			// MODIFICATION METHODS
+		/** Copies a record into the arena
+		 * @param record: the first character of the record
+		 * @param size: the size of the record
+		 * @param recaddr: the position of the record within the file
+		 * @post: the record is added to the end of the batch */
+		void add (const char* record, int size, long long recaddr);
+
+		/** Adds a record that is already in the arena
+		 * @param offset: the position of the record within the arena
+		 * @param size: the size of the record
+		 * @param recaddr: the position of the record within the file
+		 * @pre: the record fits within the arena
+		 * @post: the record is added to the end of the batch */
+		void addStored (size_t offset, int size, long long recaddr);
+
+		/** Stores where the fields of the last record are, so a buffer that found them while reading doesn't have to find them again
+		 * @param bounds: the start and end of each field, relative to the first character of the record
+		 * @param count: the number of fields
+		 * @pre: a record has been added
+		 * @post: getFields returns the bounds for the last record */
+		void setFields (const int* bounds, int count);
+
+		/** Makes room at the end of the arena
+		 * @param size: the number of bytes to add
+		 * @post: the arena grows by size bytes, which can be filled by the caller
+		 * @return: returns the first new byte. It stays valid until the arena grows again */
+		char* extend (size_t size);
+
+		/** Shrinks the arena
+		 * @param size: the new size of the arena
+		 * @pre: no record is stored past size
+		 * @post: bytes past size are no longer part of the arena */
+		void truncate (size_t size);
+
+		/** Removes every record
+		 * @post: the batch is empty, but the arena keeps its memory */
+		void clear ();
+
+			// CONSTANT METHODS
+		/** Gets a record without copying it
+		 * @param i: the number of the record within the batch
+		 * @return: returns the record's characters within the arena */
+		string_view getRecord (int i) const;
+
+		/** Gets the position a record was read from
+		 * @param i: the number of the record within the batch
+		 * @return: returns the position of the record within the file */
+		long long getAddress (int i) const;
+
+		/** Gets where the fields of a record are, if setFields stored them
+		 * @param i: the number of the record within the batch
+		 * @param count: set to the number of fields, or 0 if they weren't stored
+		 * @return: returns the start and end of each field, relative to the first character of the record, or NULL if they weren't stored */
+		const int* getFields (int i, int& count) const;
+
+		/** Gets the number of records
+		 * @return: returns the number of records in the batch */
+		int size () const;
+
+		/** Gets the arena
+		 * @return: returns the first byte of the arena */
+		const char* data () const;
+
+		/** Gets the size of the arena
+		 * @return: returns the number of bytes in the arena */
+		size_t arenaSize () const;
+
+	private:
+		vector<char> arena; //!< The characters of every record
+		size_t used; //!< The number of bytes of the arena in use. The vector isn't shrunk, so it's never refilled with zeros
+		vector<size_t> offsets; //!< The position of each record within the arena
+		vector<int> sizes; //!< The size of each record
+		vector<long long> addresses; //!< The position of each record within the file
+		vector<int> fieldBounds; //!< The start and end of the fields stored by setFields, for every record in order
+		vector<size_t> fieldsEnd; //!< The end of each record's bounds within fieldBounds. Records after the last one with fields have none
+};
+
+#include "PostalCodeBatch.cpp"
+#endif
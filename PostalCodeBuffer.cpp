@@ -1,7 +1,7 @@
 #include "PostalCodeBuffer.h"
 
 	// CONSTRUCTORS
-PostalCodeBuffer::PostalCodeBuffer (int mb) : maxBytes (mb), buffer (new char[maxBytes]), nextByte (0), length (0) {}
+PostalCodeBuffer::PostalCodeBuffer (int mb) : maxBytes (mb), buffer (new char[maxBytes]), record (buffer), nextByte (0), length (0) {}
 
 PostalCodeBuffer::PostalCodeBuffer (const PostalCodeBuffer& buff) {
 	maxBytes = buff.maxBytes;
@@ -9,6 +9,7 @@ PostalCodeBuffer::PostalCodeBuffer (const PostalCodeBuffer& buff) {
 	length = buff.length;
 	buffer = new char[maxBytes]; // Allocates a new buffer
 	memcpy (buffer, buff.buffer, length); // Copies the old buffer
+	record = buff.record == buff.buffer ? buffer : buff.record; // Records outside of the buffer aren't owned, so they are shared
 }
 
 PostalCodeBuffer::~PostalCodeBuffer () {
@@ -31,11 +32,13 @@ PostalCodeBuffer& PostalCodeBuffer::operator = (const PostalCodeBuffer& buff) {
 	nextByte = buff.nextByte;
 	length = buff.length;
 	memcpy (buffer, buff.buffer, length); // Copies the old buffer
+	record = buff.record == buff.buffer ? buffer : buff.record;
 	
 	return *this;
 }
 
 int PostalCodeBuffer::readHeader (istream& file, const string& indexFilename, const string& indexSchema) {
+	STATS_TIME (statsHeader);
 	int result = -1;
 	bool error = file.eof () or !file.good (); // Determines if the end of file was reached or if an error occured
 	char ch = file.get (); // Stores the last character read from the file
@@ -79,8 +82,8 @@ int PostalCodeBuffer::writeHeader (ostream& file) const
     return file.tellp();
 }
 
-int PostalCodeBuffer::read (istream& file) {
-	int result = file.tellg ();
+long long PostalCodeBuffer::read (istream& file) {
+	long long result = file.tellg ();
 
 	// Clears the buffer
 	clear ();
@@ -106,6 +109,8 @@ int PostalCodeBuffer::read (istream& file) {
         result = -1;
         file.clear ();
     }
+    else
+        STATS_COUNT (statsBytesRead, length + (eof ? 0 : 1));
     
     // Appends a delimiter to the end of the buffer
     buffer[length] = fieldDelim;
@@ -119,16 +124,16 @@ int PostalCodeBuffer::read (istream& file) {
     return result;
 }
 
-int PostalCodeBuffer::write(ostream& file) const
+long long PostalCodeBuffer::write(ostream& file) const
 {
   // Write specified record
   const char delim[] = {recordDelim, 0};
-  int result = file.tellp();
+  long long result = file.tellp();
 
   // Checks for error with file
   if (!file)
     result = -1;
-  file.write(buffer, length); // Writes buffer
+  file.write(record, length); // Writes buffer
   file.write(delim, 1); // Write delimiter
 
   // Checks whether state of stream is good
@@ -138,8 +143,8 @@ int PostalCodeBuffer::write(ostream& file) const
   return result;
 }
 
-int PostalCodeBuffer::dRead (istream& file, int fileIndex) {
-	int result;
+long long PostalCodeBuffer::dRead (istream& file, long long fileIndex) {
+	long long result;
 	
 	// Sets the position of the get pointer
 	file.seekg (fileIndex, ios::beg);
@@ -153,6 +158,25 @@ int PostalCodeBuffer::dRead (istream& file, int fileIndex) {
     return result;
 }
 
+int PostalCodeBuffer::readBatch (istream& file, PostalCodeBatch& batch, int n) {
+	long long recaddr;
+
+	batch.clear ();
+
+	while (batch.size () < n and (recaddr = read (file)) != -1)
+		batch.add (record, length, recaddr);
+
+	return batch.size ();
+}
+
+void PostalCodeBuffer::select (const PostalCodeBatch& batch, int i) {
+	string_view selected = batch.getRecord (i);
+
+	clear ();
+	record = selected.data ();
+	length = selected.size ();
+}
+
 int PostalCodeBuffer::dWrite(ostream& file, int fileIndex) const
 {
   // Sets the position of the put pointer
@@ -188,6 +212,23 @@ int PostalCodeBuffer::pack (const char* field, int size)
 	return len;
 }
 
+int PostalCodeBuffer::packInt (int n) {
+	char temp[16];
+	char* end = to_chars (temp, temp + sizeof (temp), n).ptr;
+
+	return pack (temp, end - temp);
+}
+
+int PostalCodeBuffer::packCoordinate (double value) {
+	char temp[64];
+	to_chars_result result = to_chars (temp, temp + sizeof (temp), value, chars_format::fixed, 6);
+
+	if (result.ec != errc ())
+		return -1;
+
+	return pack (temp, result.ptr - temp);
+}
+
 int PostalCodeBuffer::unpack (char* field, int strLen) {
 	int fieldLen = 0; // The length of the unpacked field
 	int start = nextByte; // The next character to read from the buffer
@@ -198,14 +239,14 @@ int PostalCodeBuffer::unpack (char* field, int strLen) {
 	cout << endl;*/
 	
 	// Reads characters and appends them to field until a delimiter is encountered
-	while (start < length and buffer[start] != fieldDelim) {
+	while (start < length and record[start] != fieldDelim) {
 		fieldLen += 1;
 		start += 1;
 	}
 	
 	// Checks if a delimiter was found and whether the field will fit into the provided character array
-	if ((fieldLen < strLen or strLen == -1) and start >= nextByte and buffer[start] == fieldDelim) {
-		memcpy (field, &buffer[nextByte], fieldLen); // Copies the field into the provided character array
+	if ((fieldLen < strLen or strLen == -1) and start >= nextByte and start < length and record[start] == fieldDelim) {
+		memcpy (field, &record[nextByte], fieldLen); // Copies the field into the provided character array
 		field[fieldLen] = 0; // Zero termination
 		nextByte = start + 1; // Updates nextByte
 	}
@@ -215,8 +256,61 @@ int PostalCodeBuffer::unpack (char* field, int strLen) {
 	return fieldLen;
 }
 
+int PostalCodeBuffer::unpackView (string_view& field) {
+	int fieldLen = -1;
+
+	if (nextByte < length) {
+		const char* start = record + nextByte;
+		const char* end = (const char*)memchr (start, fieldDelim, length - nextByte); // Finds the delimiter in a single scan
+
+		if (end != NULL) {
+			fieldLen = end - start;
+			field = string_view (start, fieldLen);
+			nextByte += fieldLen + 1;
+		}
+	}
+
+	return fieldLen;
+}
+
+int PostalCodeBuffer::unpackInt (int& n) {
+	string_view field;
+	int fieldLen = unpackView (field);
+
+	if (fieldLen != -1)
+		parseInt (field.data (), field.data () + fieldLen, n);
+
+	return fieldLen;
+}
+
+int PostalCodeBuffer::unpackCoordinate (double& value) {
+	string_view field;
+	int fieldLen = unpackView (field);
+
+	if (fieldLen != -1)
+		parseCoordinate (field.data (), field.data () + fieldLen, value);
+
+	return fieldLen;
+}
+
+int PostalCodeBuffer::unpackRecord (int& zipCode, string_view& city, string_view& state, string_view& county, double& lat, double& lng) {
+	if (unpackInt (zipCode) == -1
+		or unpackView (city) == -1
+		or unpackView (state) == -1
+		or unpackView (county) == -1
+		or unpackCoordinate (lat) == -1)
+		return -1;
+
+	return unpackCoordinate (lng);
+}
+
 void PostalCodeBuffer::clear () {
 	// This effectly clears the character array from the program's perspective
 	nextByte = 0;
 	length = 0;
+	record = buffer;
+}
+
+int PostalCodeBuffer::getLength () const {
+	return length;
 }
@@ -4,6 +4,11 @@
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <string>
+#include <string_view>
+#include <charconv>
+#include "FieldParser.h"
+#include "PostalCodeBatch.h"
 
 using namespace std;
 
@@ -62,14 +67,29 @@ class PostalCodeBuffer {
 		 * @pre: assumes the file follows the correct data format
 		 * @post: sets the read pointer to the first character after the end of the header and packs the buffer
 		 * @return: returns the first character in the record or -1 if the end of the file was reached before the end of the record */
-		virtual int read (istream& file);
+		virtual long long read (istream& file);
 
 		/** Writes a record to the file
 		 * @param file: the file to write data to
 		 * @pre: the file is formatted correctly
 		 * @post: sets the put pointer to the beginning of the stream and unpacks the buffer
 		 * @return: returns the first character in the record or -1 if an error occured */
-		virtual int write(ostream& file) const;
+		virtual long long write(ostream& file) const;
+
+		/** Reads several records from the file into a batch
+		 * @param file: the file to read data from
+		 * @param batch: the batch the records will be stored in
+		 * @param n: the largest number of records to read
+		 * @post: the batch holds the records and the read pointer is placed after the last one
+		 * @return: returns the number of records read, which is 0 once the end of the file is reached */
+		virtual int readBatch (istream& file, PostalCodeBatch& batch, int n);
+
+		/** Makes a record of a batch the current record, so its fields can be unpacked
+		 * @param batch: the batch holding the record
+		 * @param i: the number of the record within the batch
+		 * @pre: the batch was filled by readBatch of the same type of buffer and stays unchanged while the record is unpacked
+		 * @post: the record pointer points to the record within the batch and the first field will be unpacked next */
+		virtual void select (const PostalCodeBatch& batch, int i);
 		
 		/** Reads a record from the file
 		 * @param file: the file to read data from
@@ -77,7 +97,7 @@ class PostalCodeBuffer {
 		 * @pre: assumes that fileIndex starts at the first character of a valid record within the file and that the file follows the correct data format
 		 * @post: sets the read pointer to the first character after the end of the header and packs the buffer
 		 * @return: returns the first character in the record or -1 if the end of the file was reached before thre end of the record */
-		virtual int dRead (istream& file, int fileIndex);
+		virtual long long dRead (istream& file, long long fileIndex);
 
 		/** Writes a record to the file
 		 * @param file: the file to write data to
@@ -94,6 +114,18 @@ class PostalCodeBuffer {
 		 * @return returns the number of bytes packed into the buffer or -1 if there is an error */
 		virtual int pack (const char* field, int size = -1);
 		
+		/** Packs a whole number as the next field of the buffer
+		 * @param n: the number to pack
+		 * @post: the number is packed as text
+		 * @return: returns the number of bytes packed into the buffer or -1 if there is an error */
+		virtual int packInt (int n);
+
+		/** Packs a coordinate as the next field of the buffer
+		 * @param value: the coordinate to pack
+		 * @post: the coordinate is packed as text with 6 decimal places, like the coordinates in the DAT files
+		 * @return: returns the number of bytes packed into the buffer or -1 if there is an error */
+		virtual int packCoordinate (double value);
+		
 		/** Cuts a field from a buffer and pastes it into a character array
 		 * @param field: the character array that the data will be pasted into
 		 * @param strLen: the maximum size of field
@@ -101,9 +133,45 @@ class PostalCodeBuffer {
 		 * @return: returns the number of bytes extracted from the buffer or -1 if an error occured */
 		virtual int unpack (char* field, int strLen = -1);
 		
+		/** Gets the next field of the buffer without copying it
+		 * @param field: set to the field's characters within the record. It stays valid until the next read or clear
+		 * @post: if successful, next byte will be moved to the next field
+		 * @return: returns the length of the field or -1 if an error occured */
+		virtual int unpackView (string_view& field);
+
+		/** Unpacks the next field of the buffer as a whole number
+		 * @param n: set to the number, or 0 if the field isn't a number
+		 * @post: if successful, next byte will be moved to the next field
+		 * @return: returns the number of bytes the field used or -1 if an error occured */
+		virtual int unpackInt (int& n);
+
+		/** Unpacks the next field of the buffer as a coordinate
+		 * @param value: set to the coordinate, or 0 if the field isn't a number
+		 * @post: if successful, next byte will be moved to the next field
+		 * @return: returns the number of bytes the field used or -1 if an error occured */
+		virtual int unpackCoordinate (double& value);
+
+		/** Unpacks every field of a postal code record without copying the strings
+		 * The numbers are unpacked with unpackInt and unpackCoordinate, so it works for text and binary records
+		 * @param zipCode: set to the zip code
+		 * @param city: set to the city's characters within the record
+		 * @param state: set to the state's characters within the record
+		 * @param county: set to the county's characters within the record
+		 * @param lat: set to the latitude
+		 * @param lng: set to the longitude
+		 * @pre: the next field is the first field of the record
+		 * @post: if successful, next byte will be moved past the record's fields
+		 * @return: returns the number of bytes the last field used or -1 if a field is missing or isn't valid */
+		virtual int unpackRecord (int& zipCode, string_view& city, string_view& state, string_view& county, double& lat, double& lng);
+		
 		/** Erases all data from the buffer
 		 * @post: sets the next byte and length to 0, effectively resetting the buffer */
 		virtual void clear ();
+
+			// GETTERS
+		/** Returns the size of the record held by the buffer
+		 * @return: returns the number of bytes that have been packed or read */
+		int getLength () const;
 	
 	private:
 		static const char recordDelim = '\n'; //!< The character that indicates the end of a record
@@ -114,6 +182,7 @@ class PostalCodeBuffer {
 	protected:
 		int maxBytes; //!< The maximum number of characters the buffer can hold
 		char* buffer; //!< The buffer that will temporarily hold data. If it equals NULL then it hasn't been initialized yet
+		const char* record; //!< The record that is unpacked and written. Points to buffer unless a subclass reads records from somewhere else
 		int nextByte; //!< The index of the next byte to unpack from the buffer
 		int length; //!< The size of the buffer
 };
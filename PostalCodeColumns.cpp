@@ -0,0 +1,198 @@
+#include "PostalCodeColumns.h"
+
+	// CONSTRUCTORS
+PostalCodeColumns::PostalCodeColumns () : stateStarts (1, 0), grouped (true) {}
+
+
+	// MODIFICATION METHODS
+void PostalCodeColumns::add (const PostalCode& pc) {
+	add (pc.getZipCode (), pc.getCity (), pc.getState (), pc.getCounty (), pc.getLat (), pc.getLong ());
+}
+
+void PostalCodeColumns::add (int zipCode, string_view city, string_view state, string_view county, double lat, double lng) {
+	// Finds or creates the state's code
+	auto it = stateLookup.find (state);
+	uint16_t code;
+
+	if (it != stateLookup.end ())
+		code = it->second;
+	else {
+		code = stateNames.size ();
+		stateNames.push_back (string (state));
+		stateLookup.emplace (string (state), code);
+	}
+
+	zipColumn.push_back (zipCode);
+	latColumn.push_back (lat);
+	lngColumn.push_back (lng);
+	stateColumn.push_back (code);
+	cityOffsets.push_back (store (city));
+	cityLengths.push_back (city.size ());
+	countyOffsets.push_back (store (county));
+	countyLengths.push_back (county.size ());
+
+	grouped = false;
+}
+
+void PostalCodeColumns::groupByState () {
+	int states = stateNames.size ();
+	int rows = size ();
+
+	// Renumbers the states in alphabetical order. The map is already sorted by name
+	vector<uint16_t> newCode (states);
+	vector<string> names;
+	for (auto it = stateLookup.begin (); it != stateLookup.end (); ++it) {
+		newCode[it->second] = names.size ();
+		it->second = names.size ();
+		names.push_back (it->first);
+	}
+	stateNames.swap (names);
+
+	// Counts the rows of each state to find where each state starts
+	stateStarts.assign (states + 1, 0);
+	for (int i = 0; i < rows; ++i) {
+		stateColumn[i] = newCode[stateColumn[i]];
+		stateStarts[stateColumn[i] + 1] += 1;
+	}
+	for (int s = 0; s < states; ++s)
+		stateStarts[s + 1] += stateStarts[s];
+
+	// A stable counting sort keeps the file order within each state
+	vector<int> order (rows);
+	vector<int> next (stateStarts.begin (), stateStarts.end () - 1);
+	for (int i = 0; i < rows; ++i)
+		order[next[stateColumn[i]]++] = i;
+
+	auto reorder = [&order, rows] (auto& column) {
+		typename remove_reference<decltype (column)>::type sorted (rows);
+		for (int i = 0; i < rows; ++i)
+			sorted[i] = column[order[i]];
+		column.swap (sorted);
+	};
+
+	reorder (zipColumn);
+	reorder (latColumn);
+	reorder (lngColumn);
+	reorder (stateColumn);
+	reorder (cityOffsets);
+	reorder (cityLengths);
+	reorder (countyOffsets);
+	reorder (countyLengths);
+
+	grouped = true;
+}
+
+void PostalCodeColumns::reserve (int rows) {
+	zipColumn.reserve (rows);
+	latColumn.reserve (rows);
+	lngColumn.reserve (rows);
+	stateColumn.reserve (rows);
+	cityOffsets.reserve (rows);
+	cityLengths.reserve (rows);
+	countyOffsets.reserve (rows);
+	countyLengths.reserve (rows);
+}
+
+void PostalCodeColumns::clear () {
+	zipColumn.clear ();
+	latColumn.clear ();
+	lngColumn.clear ();
+	stateColumn.clear ();
+	cityOffsets.clear ();
+	cityLengths.clear ();
+	countyOffsets.clear ();
+	countyLengths.clear ();
+	arena.clear ();
+	stateNames.clear ();
+	stateLookup.clear ();
+	stateStarts.assign (1, 0);
+	grouped = true;
+}
+
+
+	// CONSTANT METHODS
+int PostalCodeColumns::size () const {
+	return zipColumn.size ();
+}
+
+int PostalCodeColumns::getZipCode (int row) const {
+	return zipColumn[row];
+}
+
+string_view PostalCodeColumns::getCity (int row) const {
+	return string_view (arena.data () + cityOffsets[row], cityLengths[row]);
+}
+
+string_view PostalCodeColumns::getState (int row) const {
+	return stateNames[stateColumn[row]];
+}
+
+string_view PostalCodeColumns::getCounty (int row) const {
+	return string_view (arena.data () + countyOffsets[row], countyLengths[row]);
+}
+
+double PostalCodeColumns::getLat (int row) const {
+	return latColumn[row];
+}
+
+double PostalCodeColumns::getLong (int row) const {
+	return lngColumn[row];
+}
+
+PostalCode PostalCodeColumns::getPostalCode (int row) const {
+	PostalCode pc;
+
+	pc.setZipCode (zipColumn[row]);
+	pc.setCity (getCity (row));
+	pc.setState (getState (row));
+	pc.setCounty (getCounty (row));
+	pc.setLat (latColumn[row]);
+	pc.setLong (lngColumn[row]);
+
+	return pc;
+}
+
+const int32_t* PostalCodeColumns::zipCodes () const {
+	return zipColumn.data ();
+}
+
+const double* PostalCodeColumns::lats () const {
+	return latColumn.data ();
+}
+
+const double* PostalCodeColumns::lngs () const {
+	return lngColumn.data ();
+}
+
+const uint16_t* PostalCodeColumns::stateCodes () const {
+	return stateColumn.data ();
+}
+
+int PostalCodeColumns::stateCount () const {
+	return stateNames.size ();
+}
+
+string_view PostalCodeColumns::getStateName (int code) const {
+	return stateNames[code];
+}
+
+int PostalCodeColumns::stateBegin (int code) const {
+	return stateStarts[code];
+}
+
+int PostalCodeColumns::stateEnd (int code) const {
+	return stateStarts[code + 1];
+}
+
+bool PostalCodeColumns::isGrouped () const {
+	return grouped;
+}
+
+
+	// HELPER FUNCTIONS
+uint32_t PostalCodeColumns::store (string_view str) {
+	uint32_t offset = arena.size ();
+	arena.append (str.data (), str.size ());
+
+	return offset;
+}
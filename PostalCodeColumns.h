@@ -0,0 +1,166 @@
+#ifndef PostalCodeColumns_
+#define PostalCodeColumns_
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdint>
+#include "PostalCode.h"
+
+using namespace std;
+
+// Stores postal codes as a structure of arrays instead of an array of PostalCode objects
+// Each attribute is kept in its own contiguous column, so a scan over coordinates doesn't pull cities and counties into the cache:
+//	zip codes - int32_t
+//	latitudes and longitudes - double
+//	states - a dense 16-bit code for each state. The state names are stored once
+//	cities and counties - an offset and length into a single string arena
+// After groupByState is called, the rows of each state are contiguous and the states are numbered in alphabetical order,
+// which is the same order the state table is displayed in
+
+/** Used to store postal codes by column
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class PostalCodeColumns {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an empty store */
+		PostalCodeColumns ();
+
+			// MODIFICATION METHODS
+		/** Adds a row to the end of the store
+		 * @param pc: the postal code to add
+		 * @post: the store is no longer grouped by state */
+		void add (const PostalCode& pc);
+
+		/** Adds a row to the end of the store
+		 * @param zipCode: the zip code of the row
+		 * @param city: the city of the row
+		 * @param state: the state of the row
+		 * @param county: the county of the row
+		 * @param lat: the latitude of the row
+		 * @param lng: the longitude of the row
+		 * @post: the store is no longer grouped by state */
+		void add (int zipCode, string_view city, string_view state, string_view county, double lat, double lng);
+
+		/** Reorders the rows so the rows of each state are contiguous
+		 * @post: states are numbered in alphabetical order and rows keep their relative order within each state */
+		void groupByState ();
+
+		/** Makes room for a number of rows
+		 * @param rows: the number of rows the store should hold without growing */
+		void reserve (int rows);
+
+		/** Removes every row and state
+		 * @post: the store is empty */
+		void clear ();
+
+			// CONSTANT METHODS
+		/** Gets the number of rows
+		 * @return: returns the number of postal codes in the store */
+		int size () const;
+
+		/** Gets the zip code of a row
+		 * @param row: the row to read
+		 * @return: returns the zip code */
+		int getZipCode (int row) const;
+
+		/** Gets the city of a row
+		 * @param row: the row to read
+		 * @return: returns the city's characters within the string arena */
+		string_view getCity (int row) const;
+
+		/** Gets the state of a row
+		 * @param row: the row to read
+		 * @return: returns the state's name */
+		string_view getState (int row) const;
+
+		/** Gets the county of a row
+		 * @param row: the row to read
+		 * @return: returns the county's characters within the string arena */
+		string_view getCounty (int row) const;
+
+		/** Gets the latitude of a row
+		 * @param row: the row to read
+		 * @return: returns the latitude */
+		double getLat (int row) const;
+
+		/** Gets the longitude of a row
+		 * @param row: the row to read
+		 * @return: returns the longitude */
+		double getLong (int row) const;
+
+		/** Copies a row into a postal code object
+		 * @param row: the row to copy
+		 * @return: returns a postal code with the row's attributes */
+		PostalCode getPostalCode (int row) const;
+
+		/** Gets the zip code column
+		 * @return: returns the zip codes of every row */
+		const int32_t* zipCodes () const;
+
+		/** Gets the latitude column
+		 * @return: returns the latitudes of every row */
+		const double* lats () const;
+
+		/** Gets the longitude column
+		 * @return: returns the longitudes of every row */
+		const double* lngs () const;
+
+		/** Gets the state column
+		 * @return: returns the state code of every row */
+		const uint16_t* stateCodes () const;
+
+		/** Gets the number of states
+		 * @return: returns the number of distinct states */
+		int stateCount () const;
+
+		/** Gets the name of a state
+		 * @param code: the state's code
+		 * @return: returns the state's name */
+		string_view getStateName (int code) const;
+
+		/** Gets the first row of a state
+		 * @param code: the state's code
+		 * @pre: the store is grouped by state
+		 * @return: returns the first row of the state */
+		int stateBegin (int code) const;
+
+		/** Gets the row after the last row of a state
+		 * @param code: the state's code
+		 * @pre: the store is grouped by state
+		 * @return: returns the row after the last row of the state */
+		int stateEnd (int code) const;
+
+		/** Determines if the rows of each state are contiguous
+		 * @return: returns true if groupByState was called after the last row was added */
+		bool isGrouped () const;
+
+	private:
+		/** Copies characters to the end of the string arena
+		 * @param str: the characters to copy
+		 * @return: returns the offset of the characters within the arena */
+		uint32_t store (string_view str);
+
+		vector<int32_t> zipColumn; //!< The zip code of each row
+		vector<double> latColumn; //!< The latitude of each row
+		vector<double> lngColumn; //!< The longitude of each row
+		vector<uint16_t> stateColumn; //!< The state code of each row
+		vector<uint32_t> cityOffsets; //!< The offset of each row's city within the arena
+		vector<uint16_t> cityLengths; //!< The length of each row's city
+		vector<uint32_t> countyOffsets; //!< The offset of each row's county within the arena
+		vector<uint16_t> countyLengths; //!< The length of each row's county
+		string arena; //!< Holds the characters of every city and county
+		vector<string> stateNames; //!< The name of each state code
+		map<string, uint16_t, less<> > stateLookup; //!< Finds the code of a state name
+		vector<int> stateStarts; //!< The first row of each state, followed by the number of rows. Only valid when grouped
+		bool grouped; //!< Whether the rows of each state are contiguous
+};
+
+#include "PostalCodeColumns.cpp"
+#endif
@@ -31,40 +31,76 @@ string PostalCodeHeader::readHeaderHelper (string& str) const {
 
     return token;
 }
-	
 
-    // BUFFER OPERATIONS
-int PostalCodeHeader::readHeader (istream& file) {
-    int result = -1;
-    unsigned short size; // Header record size
-    char* temp = new char[4]; // Used for reading sizes from the header
-    string header;
+unsigned long long PostalCodeHeader::readHeaderNumber (string& str, int bytes) const {
+    unsigned long long value = 0;
+
+    // Binary fields can contain the '|' byte, so they are cut by size instead of searching for the delimiter
+    if ((int)str.size () >= bytes) {
+        for (int i = bytes - 1; i >= 0; --i)
+            value = (value << 8) | (unsigned char)str[i];
+        str.erase (0, (int)str.size () > bytes ? bytes + 1 : bytes);
+    }
+    else
+        str.clear ();
+
+    return value;
+}
+
+int PostalCodeHeader::readHeaderRecord (istream& file, string& header) const {
+    unsigned char bytes[4];
+    unsigned int size = 0; // Header record size
+    int prefix = 2; // The number of bytes used by the size
 
     // Sets the get pointer to the beginning of the file
     file.seekg (0, ios::beg);
 
-    // Reads the header record size
-    file.read (temp, 2);
-    size = (temp[1] << 8) | temp[0];
+    // Reads the header record size. A size of 0 means the real size follows in 4 bytes
+    file.read ((char*)bytes, 2);
+    size = bytes[0] | (bytes[1] << 8);
+    if (file.good () == true and size == 0) {
+        file.read ((char*)bytes, 4);
+        size = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+        prefix += 4;
+    }
+
+    // Reads the rest of the header. Real headers are tiny, so a huge size means the file isn't a DAT file
+    header.clear ();
+    if (file.good () == true and size <= maxHeaderSize) {
+        header.resize (size);
+        file.read (&header[0], size);
+        STATS_COUNT (statsBytesRead, prefix + file.gcount ());
+    }
+
+    return file.good () == true and size <= maxHeaderSize ? prefix + size : -1;
+}
 
-    // Reads the rest of the header
-    char ch;
-    for (int i = 0; i < size && file.get(ch); i++)
-        header += ch;
+void PostalCodeHeader::writeHeaderNumber (ostream& ss, unsigned long long value, int bytes) const {
+    for (int i = 0; i < bytes; ++i)
+        ss.put ((char)(value >> (8 * i)));
+    ss << "|";
+}
+	
+
+    // BUFFER OPERATIONS
+int PostalCodeHeader::readHeader (istream& file) {
+    STATS_TIME (statsHeader);
+    int result = -1;
+    string header;
+    int size = readHeaderRecord (file, header); // Header size, including the header record size
 
-    if (file.good () == true) {
+    if (size != -1) {
         string field; // Holds the current field taken from the header
 
         // File structure type
         structure = readHeaderHelper (header);
 
-        // File version
-        field = readHeaderHelper (header);
-        version = (field[1] << 8) | field[0];
+        // File version, which decides the size of the numbers after it
+        version = readHeaderNumber (header, 2);
+        bool wide = version >= 2;
 
         // Record size
-        field = readHeaderHelper (header);
-        recordSize = (field[1] << 8) | field[0];
+        recordSize = readHeaderNumber (header, wide ? 4 : 2);
 
         // Size format
         field = readHeaderHelper (header);
@@ -77,51 +113,38 @@ int PostalCodeHeader::readHeader (istream& file) {
         indexSchema = readHeaderHelper (header);
 
         // Record count
-        field = readHeaderHelper (header);
-        recordCount = (field[1] << 8) | field[0];
+        recordCount = readHeaderNumber (header, wide ? 8 : 2);
 
         // Field count
-        field = readHeaderHelper (header);
-        fieldCount = (field[1] << 8) | field[0];
+        fieldCount = readHeaderNumber (header, wide ? 4 : 2);
 
         // Field file schemas
-        for (int i = 0; i < fieldCount; ++i)
-            fieldInfo[i] = readHeaderHelper (header);
+        fieldInfo.clear ();
+        for (unsigned int i = 0; i < fieldCount and header != ""; ++i)
+            fieldInfo.push_back (readHeaderHelper (header));
 
         // Primary key
         primaryKey = readHeaderHelper (header);
 
         // The header string should be empty by this point
         if (header == "")
-            result = size + 2;
+            result = size;
     }
 
     return result;
 }
 
 int PostalCodeHeader::validateHeader (istream& file) const {
+    STATS_TIME (statsHeader);
     int result = -1;
-    unsigned short size; // Header record size
     string header;
+    int size = readHeaderRecord (file, header); // Header size, including the header record size
 
-    // Sets the get pointer to the beginning of the file
-    file.seekg (0, ios::beg);
-
-    // Reads the header record size
-    file.read ((char*)&size, sizeof (size));
-
-    // Reads the rest of the header
-    char ch;
-    for (int i = 0; i < size && file.get(ch); i++)
-        header += ch;
-
-    //cout << "SIZE: " << size << endl;
-    //cout << "START: " << header << endl << endl;
-
-    if (file.good () == true) {
+    if (size != -1) {
         string field; // Holds the current field taken from the header
-        unsigned short tempVal; // Holds the current field if it has been translated to a number
+        unsigned long long tempVal; // Holds the current field if it has been translated to a number
         int invalid = false;
+        bool wide = version >= 2; // Decides the size of the numbers after the version
 
         // File structure type
         field = readHeaderHelper (header);
@@ -130,15 +153,13 @@ int PostalCodeHeader::validateHeader (istream& file) const {
         //cout << invalid << " (" << field << "), " << endl;
 
         // File version
-        field = readHeaderHelper (header);
-        tempVal = (field[1] << 8) | field[0];
+        tempVal = readHeaderNumber (header, 2);
         invalid = invalid or tempVal != version;
 
         //cout << invalid << "(" << tempVal << "), " << endl;
 
         // Record size
-        field = readHeaderHelper (header);
-        tempVal = (field[1] << 8) | field[0];
+        tempVal = readHeaderNumber (header, wide ? 4 : 2);
         invalid = invalid or tempVal != recordSize;
 
         //cout << invalid << "(" << tempVal << "), " << endl;
@@ -146,7 +167,7 @@ int PostalCodeHeader::validateHeader (istream& file) const {
         // Size format
         field = readHeaderHelper (header);
         tempVal = int(field[0]) - 48;
-        invalid = invalid or tempVal != sizeFormat;
+        invalid = invalid or (int)tempVal != sizeFormat;
 
         //cout << invalid << "(" << tempVal << "), " << endl;
 
@@ -163,21 +184,20 @@ int PostalCodeHeader::validateHeader (istream& file) const {
         //cout << invalid << "(" << field << "), " << endl;
 
         // Record count (not checked)
-        field = readHeaderHelper (header);
+        readHeaderNumber (header, wide ? 8 : 2);
 
         //cout << invalid << "(" << field << "), " << endl;
 
         // Field count
-        field = readHeaderHelper (header);
-        tempVal = (field[1] << 8) | field[0];
+        tempVal = readHeaderNumber (header, wide ? 4 : 2);
         invalid = invalid or tempVal != fieldCount;
 
         //cout << invalid << "(" << tempVal << "), " << endl;
 
         // Field file schemas
-        for (int i = 0; i < fieldCount; ++i) {
+        for (unsigned int i = 0; i < fieldCount; ++i) {
             field = readHeaderHelper (header);
-            invalid = invalid or field != fieldInfo[i];
+            invalid = invalid or i >= fieldInfo.size () or field != fieldInfo[i];
 
             //cout << invalid << "(" << field << "), " << endl;
         }
@@ -190,7 +210,7 @@ int PostalCodeHeader::validateHeader (istream& file) const {
 
         // The header string should be empty by this point
         if (header == "" and invalid == false)
-            result = size + 2;
+            result = size;
     }
 
     return result;
@@ -200,23 +220,24 @@ int PostalCodeHeader::writeHeader (ostream& file) const {
     int result = -1;
     string temp; // Holds the entire header string so the method can get its size later
     stringstream ss; // Allows the program to manipulate the string like a file stream
-    unsigned short size;
-	
-	// Sets the put pointer to the beginning of the file
-	file.seekp (0, ios::beg);
+    bool wide = version >= 2; // Version 2 headers use bigger numbers
+    unsigned int size;
+
+    // Version 1 headers can only hold 2-byte numbers
+    if (wide == false and (recordSize > 0xFFFF or recordCount > 0xFFFF or fieldCount > 0xFFFF))
+        return -1;
+
+    // Sets the put pointer to the beginning of the file
+    file.seekp (0, ios::beg);
 
     ss << structure << "|"; // File structure type
-    ss.write ((char*)&version, sizeof (version)); // File version
-    ss << "|";
-    ss.write ((char*)&recordSize, sizeof (recordSize)); // Record size
-    ss << "|";
+    writeHeaderNumber (ss, version, 2); // File version
+    writeHeaderNumber (ss, recordSize, wide ? 4 : 2); // Record size
     ss << sizeFormat << "|"; // Size storage format
     ss << indexFilename << "|"; // Name of the index file
     ss << indexSchema << "|"; // Index storage scheme
-    ss.write ((char*)&recordCount, sizeof (recordCount)); // Number of records
-    ss << "|";
-    ss.write ((char*)&fieldCount, sizeof (fieldCount)); // Number of fields per record
-    ss << "|";
+    writeHeaderNumber (ss, recordCount, wide ? 8 : 2); // Number of records
+    writeHeaderNumber (ss, fieldCount, wide ? 4 : 2); // Number of fields per record
     // Name and schema for each field
     for (int i = 0; i < fieldInfo.size (); ++i)
         ss << fieldInfo[i] << "|";
@@ -226,7 +247,14 @@ int PostalCodeHeader::writeHeader (ostream& file) const {
     size = temp.size (); // Gets the size of the header
 
     // Writes the entire header with its size at the start
-    file.write ((char*)&size, sizeof (size));
+    if (wide) {
+        file.write ("\0\0", 2); // Version 1 headers are never empty, so a size of 0 marks the 4-byte size
+        file.put ((char)size).put ((char)(size >> 8)).put ((char)(size >> 16)).put ((char)(size >> 24));
+    }
+    else if (size <= 0xFFFF)
+        file.put ((char)size).put ((char)(size >> 8));
+    else
+        return -1;
     file << temp;
 
     if (file.good () == true)
@@ -235,6 +263,31 @@ int PostalCodeHeader::writeHeader (ostream& file) const {
     return result;
 }
 
+int PostalCodeHeader::decodeHeaderLength (const char* data, size_t available, unsigned int& headerSize) {
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    if (available < 2)
+        return -1;
+
+    headerSize = bytes[0] | (bytes[1] << 8);
+    if (headerSize != 0)
+        return 2;
+
+    // Version 2 header
+    if (available < 6)
+        return -1;
+
+    headerSize = bytes[2] | (bytes[3] << 8) | (bytes[4] << 16) | ((unsigned int)bytes[5] << 24);
+    return 6;
+}
+
+bool PostalCodeHeader::isSupported () const {
+    // A damaged header can still parse, so the numbers it decides the record layout with are checked too
+    bool known = structure == "LENGTH/DELIM" or structure == "LENGTH/BINARY" or structure == "FIXED/FIXED" or structure == "BLOCK/BINARY";
+
+    return (version == 1 or version == 2) and known;
+}
+
 void PostalCodeHeader::clear () {
     // Sets all the attributes to default values
     structure = "NULL|NULL";
@@ -258,7 +311,7 @@ unsigned short PostalCodeHeader::getVersion() const {
     return version;
 }
 
-unsigned short PostalCodeHeader::getRecordSize() const {
+unsigned int PostalCodeHeader::getRecordSize() const {
     return recordSize;
 }
 
@@ -274,11 +327,11 @@ string PostalCodeHeader::getIndexSchema() const {
     return indexSchema;
 }
 
-unsigned short PostalCodeHeader::getRecordCount() const {
+unsigned long long PostalCodeHeader::getRecordCount() const {
     return recordCount;
 }
 
-unsigned short PostalCodeHeader::getFieldCount() const {
+unsigned int PostalCodeHeader::getFieldCount() const {
     return fieldCount;
 }
 
@@ -300,7 +353,7 @@ void PostalCodeHeader::setVersion(unsigned short version) {
     this->version = version;
 }
 
-void PostalCodeHeader::setRecordSize(unsigned short recordSize) {
+void PostalCodeHeader::setRecordSize(unsigned int recordSize) {
     this->recordSize = recordSize;
 }
 
@@ -316,11 +369,11 @@ void PostalCodeHeader::setIndexSchema(const string& indexSchema) {
     this->indexSchema = indexSchema;
 }
 
-void PostalCodeHeader::setRecordCount(unsigned short recordCount) {
+void PostalCodeHeader::setRecordCount(unsigned long long recordCount) {
     this->recordCount = recordCount;
 }
 
-void PostalCodeHeader::setFieldCount(unsigned short fieldCount) {
+void PostalCodeHeader::setFieldCount(unsigned int fieldCount) {
     this->fieldCount = fieldCount;
 }
 
@@ -7,23 +7,27 @@
 #include <vector>
 #include <sstream>
 #include <string>
+#include "IngestStats.h"
 
 using namespace std;
 
 /* Reads, validates, and writes the header record for a postal code data file
 Instead of saving the header to a character array, the header is stored in attributes so it's more user-friendly
 The file format is as follows. All fields after the header record size are delimited by '|':
-	00 - Header record size (unsigned short)
-	"TYPE/TYPE" - Record/field file structure type (ex: LENGTH/DELIM = Length-incated records, delimited fields)
+	00 - Header record size (unsigned short). Version 2 headers start with a size of 0 followed by the real size (4 bytes)
+	"TYPE/TYPE" - Record/field file structure type (ex: LENGTH/DELIM = Length-incated records, delimited fields,
+		LENGTH/BINARY = Length-indicated records, binary numbers and length-indicated strings)
 	00 - File structure version (unsigned short)
-	00 - Record size for fixed length records, 0 if not a fixed length record (unsigned short)
+	00 - Record size for fixed length records, 0 if not a fixed length record (unsigned short, 4 bytes in version 2)
 	0 - Size format, 0 = ASCII and 1 = Binary (int)
 	"index_filename.ind" - Name of the index file
 	"key/TYPE/VALUE/pos/TYPE/VALUE" - Index file schema for reading/writing the key and position (ex: key/DELIM/,/pos/FIXED/8)
-	00 - Record count (unsigned short)
-	00 - Number of fields (unsigned short)
+	00 - Record count (unsigned short, 8 bytes in version 2)
+	00 - Number of fields (unsigned short, 4 bytes in version 2)
 	"field/TYPE/VALUE" - Field file schema, repeated for the number of fields (ex: height/DELIM/, = height field is delimited with a comma)
 	"field" - The field used as the primary key
+Binary numbers are stored with the least significant byte first
+Version 1 files use 2-byte record length indicators. Version 2 files use varints, so records and files have no 16-bit limits
 */
 
 /** Used to read, write, and validate headers for new DAT postal code files
@@ -61,10 +65,25 @@ class PostalCodeHeader {
 		 * @brief Writes the header using the stored attirbutes
 		 * @param file: the file to read data from
 		 * @post sets the put pointer to the beginning of the stream and writes to the file
-		 * @return returns the size of the header or -1 if error occured
+		 * @return returns the size of the header or -1 if error occured, including numbers too big for a version 1 header
 		*/
 		int writeHeader(ostream& file) const;
 
+		/**
+		 * @brief Decodes the header record size at the start of a file held in memory
+		 * @param data the first byte of the file
+		 * @param available the number of bytes that can be read from data
+		 * @param headerSize set to the size of the header that follows the size
+		 * @return returns the number of bytes used by the size (2 or 6) or -1 if it doesn't fit within available
+		*/
+		static int decodeHeaderLength (const char* data, size_t available, unsigned int& headerSize);
+
+		/**
+		 * @brief Checks if a header read by readHeader describes a file the postal code buffers can read
+		 * @return returns true if the version is 1 or 2 and the structure is LENGTH/DELIM, LENGTH/BINARY, FIXED/FIXED or BLOCK/BINARY
+		*/
+		bool isSupported () const;
+
 		/**
 		 * @brief Erases all data from the buffer
 		 * @post sets all attributes to their default values
@@ -87,9 +106,9 @@ class PostalCodeHeader {
 
 		/**
 		 * @brief Returns the record size of the postal code header.
-		 * @return An unsigned short representing the record size of the postal code header.
+		 * @return An unsigned int representing the record size of the postal code header.
 		*/
-		unsigned short getRecordSize() const;
+		unsigned int getRecordSize() const;
 
 		/**
 		 * @brief Returns the size format of the postal code header.
@@ -111,15 +130,15 @@ class PostalCodeHeader {
 
 		/**
 		 * @brief Returns the number of records in the postal code header.
-		 * @return An unsigned short representing the number of records in the postal code header.
+		 * @return An unsigned long long representing the number of records in the postal code header.
 		*/
-		unsigned short getRecordCount() const;
+		unsigned long long getRecordCount() const;
 
 		/**
 		 * @brief Returns the number of fields in the postal code header.
-		 * @return An unsigned short representing the number of fields in the postal code header.
+		 * @return An unsigned int representing the number of fields in the postal code header.
 		*/
-		unsigned short getFieldCount() const;
+		unsigned int getFieldCount() const;
 
 		/**
 		 * @brief Returns the field information of the postal code header.
@@ -148,9 +167,9 @@ class PostalCodeHeader {
 
 		/**
 		 * @brief Sets the record size of the postal code header.
-		 * @param recordSize An unsigned short representing the record size of the postal code header.
+		 * @param recordSize An unsigned int representing the record size of the postal code header.
 		*/
-		void setRecordSize(unsigned short recordSize);
+		void setRecordSize(unsigned int recordSize);
 
 		/**
 		 * @brief Sets the size format of the postal code header.
@@ -172,15 +191,15 @@ class PostalCodeHeader {
 
 		/**
 		 * @brief Sets the number of records in the postal code header.
-		 * @param recordCount An unsigned short representing the number of records in the postal code header.
+		 * @param recordCount An unsigned long long representing the number of records in the postal code header.
 		*/
-		void setRecordCount(unsigned short recordCount);
+		void setRecordCount(unsigned long long recordCount);
 
 		/**
 		 * @brief Sets the number of fields in the postal code header.
-		 * @param fieldCount An unsigned short representing the number of fields in the postal code header.
+		 * @param fieldCount An unsigned int representing the number of fields in the postal code header.
 		*/
-		void setFieldCount(unsigned short fieldCount);
+		void setFieldCount(unsigned int fieldCount);
 
 		/**
 		 * @brief Sets the field information of the postal code header.
@@ -203,15 +222,43 @@ class PostalCodeHeader {
 		 * @return The token will be returned, or the entire string will be returned if an error occured
 		*/
 		string readHeaderHelper (string& str) const;
+
+		/**
+		 * @brief Takes a string and extracts a binary number and its trailing "|" from the front of it
+		 * @param str The delimited string that the number resides within
+		 * @param bytes The size of the number
+		 * @post The string will have the number and its delimiter removed from it
+		 * @return The number will be returned, or 0 if the string was too short
+		*/
+		unsigned long long readHeaderNumber (string& str, int bytes) const;
+
+		/**
+		 * @brief Reads the header record size and the header record
+		 * @param file the file to read data from
+		 * @param header set to the header record, without its size
+		 * @post sets the read pointer to the first character after the end of the header
+		 * @return returns the size of the header, including its size, or -1 if the file ended first
+		*/
+		int readHeaderRecord (istream& file, string& header) const;
+
+		/**
+		 * @brief Writes a binary number followed by "|"
+		 * @param ss the stream the number is written to
+		 * @param value the number to write
+		 * @param bytes the size of the number
+		*/
+		void writeHeaderNumber (ostream& ss, unsigned long long value, int bytes) const;
 		
+		static const unsigned int maxHeaderSize = 1 << 20; //!< The largest header that will be read
+
 		string structure; //!< Overall structure of the file
 		unsigned short version; //!< File version
-		unsigned short recordSize; //!< Size of the records or 0 if not fixed-length
+		unsigned int recordSize; //!< Size of the records or 0 if not fixed-length
 		int sizeFormat; //!< The format used to store numbers in the file. 0 = ASCII and 1 = binary
 		string indexFilename; //!< The name of the index file associated with this header
 		string indexSchema; //!< The file storage scheme used by the index
-		unsigned short recordCount; //!< The number of records in the data file
-		unsigned short fieldCount; //!< The number of fields per record
+		unsigned long long recordCount; //!< The number of records in the data file
+		unsigned int fieldCount; //!< The number of fields per record
 		vector<string> fieldInfo; //!< The file storage scheme for each field
 		string primaryKey; //!< The field that's used as the primary key
 };
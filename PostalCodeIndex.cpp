@@ -0,0 +1,249 @@
+#include "PostalCodeIndex.h"
+
+	// CONSTRUCTORS
+PostalCodeIndex::PostalCodeIndex () : keyFixed (false), keyDelim (','), keySize (0), posSize (8), count (0) {}
+
+
+	// MODIFICATION METHODS
+bool PostalCodeIndex::setSchema (const string& schema) {
+	vector<string> tokens;
+	string rest = schema;
+	size_t pos;
+
+	// Splits the schema into its '/' separated parts
+	while ((pos = rest.find ('/')) != string::npos) {
+		tokens.push_back (rest.substr (0, pos));
+		rest.erase (0, pos + 1);
+	}
+	tokens.push_back (rest);
+
+	// The key type is followed by an optional value, so the position part is found by name
+	int posStart = -1;
+	for (int i = 2; i < (int)tokens.size (); ++i)
+		if (tokens[i] == "pos")
+			posStart = i;
+
+	if (tokens.size () < 5 or tokens[0] != "key" or posStart == -1 or posStart + 2 >= (int)tokens.size ())
+		return false;
+
+	// Key layout
+	if (tokens[1] == "DELIM") {
+		keyFixed = false;
+		keyDelim = posStart == 3 and tokens[2].size () == 1 ? tokens[2][0] : ',';
+		keySize = 0;
+	}
+	else if (tokens[1] == "FIXED" and posStart == 3) {
+		keyFixed = true;
+		keySize = atoi (tokens[2].c_str ());
+	}
+	else
+		return false;
+
+	// Position layout (only fixed-size offsets can be read without another delimiter)
+	posSize = atoi (tokens[posStart + 2].c_str ());
+
+	return tokens[posStart + 1] == "FIXED" and posSize > 0 and posSize <= 8 and (keyFixed == false or (keySize > 0 and keySize <= 4));
+}
+
+int PostalCodeIndex::build (const string& dataFilename, const string& indexFilename, NewPostalCodeBuffer* reader) {
+	ifstream infile (dataFilename.c_str (), ios::binary);
+	PostalCodeHeader header;
+	NewPostalCodeBuffer local;
+	NewPostalCodeBuffer& buffer = reader != NULL ? *reader : local;
+	vector<pair<int, long long> > entries;
+
+	error = "";
+	if (!infile.is_open ()) {
+		error = "could not open '" + dataFilename + "': " + strerror (errno);
+		return -1;
+	}
+
+	// Validates the header against itself to place the read pointer at the first record
+	if (header.readHeader (infile) == -1 or buffer.readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1) {
+		error = "could not read the header of '" + dataFilename + "'";
+		return -1;
+	}
+
+	if (setSchema (header.getIndexSchema ()) == false) {
+		error = "the index schema '" + header.getIndexSchema () + "' of '" + dataFilename + "' isn't supported";
+		return -1;
+	}
+
+	// Collects the zip code and offset of every record
+	entries.reserve (header.getRecordCount ());
+	long long recaddr;
+	while ((recaddr = buffer.read (infile)) != -1) {
+		int zip;
+		if (buffer.unpackInt (zip) == -1) {
+			error = "could not read the zip code of the record at offset " + to_string (recaddr) + " of '" + dataFilename + "'";
+			return -1;
+		}
+
+		entries.push_back (make_pair (zip, recaddr));
+	}
+	infile.close ();
+
+	// Stable so duplicate keys keep their file order
+	stable_sort (entries.begin (), entries.end (), [](const pair<int, long long>& a, const pair<int, long long>& b) {
+		return a.first < b.first;
+	});
+
+	// Writes the entries with a single write
+	string out;
+	out.reserve (entries.size () * (keyFixed ? keySize + posSize : 8 + posSize));
+	for (size_t i = 0; i < entries.size (); ++i) {
+		if (keyFixed)
+			out.append ((const char*)&entries[i].first, keySize);
+		else {
+			out += to_string (entries[i].first);
+			out += keyDelim;
+		}
+		out.append ((const char*)&entries[i].second, posSize);
+	}
+
+	string name = indexFilename == "" ? locate (dataFilename, header.getIndexFilename ()) : indexFilename;
+	ofstream outfile (name.c_str (), ios::binary | ios::trunc);
+	outfile.write (out.data (), out.size ());
+
+	if (outfile.good () == false) {
+		error = "could not write '" + name + "': " + strerror (errno);
+		return -1;
+	}
+
+	return entries.size ();
+}
+
+bool PostalCodeIndex::open (const string& indexFilename) {
+	close ();
+	error = "";
+
+	if (indexFile.open (indexFilename, false) == false) {
+		error = "could not open '" + indexFilename + "': " + strerror (errno);
+		return false;
+	}
+
+	const char* data = indexFile.data ();
+	size_t length = indexFile.size ();
+
+	if (keyFixed) {
+		// Fixed-size entries are searched in place
+		if (length % (keySize + posSize) != 0) {
+			close ();
+			error = "the size of '" + indexFilename + "' isn't a whole number of entries of the schema " + getSchema ();
+			return false;
+		}
+		count = length / (keySize + posSize);
+	}
+	else {
+		// Delimited keys have to be decoded before they can be searched
+		size_t i = 0;
+		while (i < length) {
+			int key = 0;
+			size_t start = i;
+
+			while (i < length and data[i] != keyDelim and data[i] >= '0' and data[i] <= '9' and i - start < 9) {
+				key = key * 10 + (data[i] - '0');
+				i += 1;
+			}
+
+			// Every key is a number of up to 9 digits followed by the delimiter and a whole offset
+			if (i == start or i >= length or data[i] != keyDelim or i + 1 + posSize > length) {
+				close ();
+				error = "the entry at offset " + to_string (start) + " of '" + indexFilename + "' doesn't match the schema " + getSchema ();
+				return false;
+			}
+
+			long long recaddr = 0;
+			memcpy (&recaddr, &data[i + 1], posSize);
+			i += 1 + posSize;
+
+			keys.push_back (key);
+			positions.push_back (recaddr);
+		}
+		count = keys.size ();
+	}
+
+	return true;
+}
+
+void PostalCodeIndex::close () {
+	indexFile.close ();
+	keys.clear ();
+	positions.clear ();
+	count = 0;
+}
+
+
+	// CONSTANT METHODS
+long long PostalCodeIndex::find (int zipCode) const {
+	int low = 0;
+	int high = count;
+
+	// Finds the first entry that isn't less than the zip code
+	while (low < high) {
+		int mid = low + (high - low) / 2;
+
+		if (keyAt (mid) < zipCode)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	if (low < count and keyAt (low) == zipCode)
+		return positionAt (low);
+
+	return -1;
+}
+
+int PostalCodeIndex::size () const {
+	return count;
+}
+
+string PostalCodeIndex::getSchema () const {
+	string schema = "key/";
+
+	if (keyFixed)
+		schema += "FIXED/" + to_string (keySize);
+	else
+		schema += string ("DELIM/") + keyDelim;
+
+	return schema + "/pos/FIXED/" + to_string (posSize);
+}
+
+string PostalCodeIndex::getError () const {
+	return error;
+}
+
+string PostalCodeIndex::locate (const string& dataFilename, const string& indexFilename) {
+	if (indexFilename.empty () or indexFilename[0] == '/')
+		return indexFilename;
+
+	// Keeps the directory of the DAT file and the file name from the header
+	size_t dataSlash = dataFilename.find_last_of ('/');
+	size_t indexSlash = indexFilename.find_last_of ('/');
+	string directory = dataSlash == string::npos ? "" : dataFilename.substr (0, dataSlash + 1);
+
+	return directory + (indexSlash == string::npos ? indexFilename : indexFilename.substr (indexSlash + 1));
+}
+
+
+	// HELPER FUNCTIONS
+int PostalCodeIndex::keyAt (int i) const {
+	if (keyFixed == false)
+		return keys[i];
+
+	int key = 0;
+	memcpy (&key, indexFile.data () + (size_t)i * (keySize + posSize), keySize);
+
+	return key;
+}
+
+long long PostalCodeIndex::positionAt (int i) const {
+	if (keyFixed == false)
+		return positions[i];
+
+	long long recaddr = 0;
+	memcpy (&recaddr, indexFile.data () + (size_t)i * (keySize + posSize) + keySize, posSize);
+
+	return recaddr;
+}
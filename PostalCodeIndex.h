@@ -0,0 +1,117 @@
+#ifndef PostalCodeIndex_
+#define PostalCodeIndex_
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include "MappedFile.h"
+#include "PostalCodeHeader.h"
+#include "NewPostalCodeBuffer.h"
+
+using namespace std;
+
+/* Builds and searches the primary key index advertised in a DAT file header
+The index file contains one entry for each record, sorted by zip code. It has no header of its own
+Each entry is laid out according to the index schema stored in the DAT header:
+	"key/DELIM/,/pos/FIXED/8" - The zip code in ASCII followed by ',' and then an 8-byte binary record offset
+	"key/FIXED/4/pos/FIXED/8" - A 4-byte binary zip code followed by an 8-byte binary record offset
+The delimiter value may be left out of a DELIM key (ex: key/DELIM/pos/FIXED/8), in which case ',' is used
+Binary values are stored in the machine's byte order, like the sizes in the DAT header
+Indexes with fixed-size keys are binary searched directly in the mapped file, so opening one and finding a zip code is O(log n)
+Delimited entries can't be found from the middle of the file, since the binary offsets can hold any byte, including digits and
+the delimiter. Delimited indexes are decoded in full when they're opened, which is O(n), and then binary searched.
+The converter and generator write fixed-size keys unless another schema is chosen
+*/
+
+/** Used to build and search the zip code index for new DAT postal code files
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class PostalCodeIndex {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an index that uses the schema "key/DELIM/,/pos/FIXED/8" and isn't opened */
+		PostalCodeIndex ();
+
+			// MODIFICATION METHODS
+		/** Sets the layout used for the entries in the index file
+		 * @param schema: the index schema from the DAT header (ex: key/DELIM/,/pos/FIXED/8)
+		 * @post: the schema will be used by the next build or open
+		 * @return: returns true if the schema is supported, otherwise false */
+		bool setSchema (const string& schema);
+
+		/** Scans a DAT file and writes a sorted index for it
+		 * @param dataFilename: the DAT file to index
+		 * @param indexFilename: the index file to create. If empty, the index filename in the DAT header will be found with locate
+		 * @param reader: the buffer used to read the DAT file. If NULL, a NewPostalCodeBuffer is used
+		 * @pre: the DAT file has a valid header. Its index schema replaces the current one
+		 * @post: writes the index file. If an error occured, getError describes it
+		 * @return: returns the number of entries written or -1 if an error occured */
+		int build (const string& dataFilename, const string& indexFilename = "", NewPostalCodeBuffer* reader = NULL);
+
+		/** Maps an index file into memory so it can be searched
+		 * @param indexFilename: the index file to open
+		 * @pre: the index was written with the current schema
+		 * @post: find () will search the index. Delimited indexes are read into memory first. If the index couldn't be opened, getError describes why
+		 * @return: returns true if the index was opened, or false if it couldn't be read or a delimited key isn't a number */
+		bool open (const string& indexFilename);
+
+		/** Releases the index file
+		 * @post: the index will be empty */
+		void close ();
+
+			// CONSTANT METHODS
+		/** Searches the index for a zip code using binary search
+		 * @param zipCode: the zip code to find
+		 * @return: returns the offset of the record within the DAT file or -1 if the zip code isn't indexed */
+		long long find (int zipCode) const;
+
+		/** Gets the number of entries in the index
+		 * @return: returns the number of indexed records */
+		int size () const;
+
+		/** Gets the schema used by the index
+		 * @return: returns the index schema in the same format as the DAT header */
+		string getSchema () const;
+
+		/** Gets why the last build or open failed
+		 * @return: returns a description that names the file and the reason, or "" if nothing failed */
+		string getError () const;
+
+		/** Finds the index file named in a DAT header
+		 * The name was written relative to the directory the DAT file was made in, so the index is looked for next to the DAT file,
+		 * the same way the B+-tree and bitmap files are
+		 * @param dataFilename: the DAT file
+		 * @param indexFilename: the index filename from the DAT file's header
+		 * @return: returns the file name of the index in the DAT file's directory, or indexFilename if it's an absolute path */
+		static string locate (const string& dataFilename, const string& indexFilename);
+
+	private:
+		/** Gets the key of an entry in a fixed-size index
+		 * @param i: the position of the entry
+		 * @return: returns the zip code stored in the entry */
+		int keyAt (int i) const;
+
+		/** Gets the record offset of an entry
+		 * @param i: the position of the entry
+		 * @return: returns the record offset stored in the entry */
+		long long positionAt (int i) const;
+
+		bool keyFixed; //!< Whether the keys are fixed-size binary numbers instead of delimited text
+		char keyDelim; //!< The character that ends each key when the keys are delimited
+		int keySize; //!< The size of each key when the keys are fixed-size
+		int posSize; //!< The size of each record offset
+		MappedFile indexFile; //!< The mapped index file
+		int count; //!< The number of entries in the index
+		vector<int> keys; //!< The decoded keys when the keys are delimited
+		vector<long long> positions; //!< The decoded record offsets when the keys are delimited
+		string error; //!< Why the last build or open failed
+};
+
+#include "PostalCodeIndex.cpp"
+#endif
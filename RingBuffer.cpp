@@ -0,0 +1,77 @@
+#include "RingBuffer.h"
+
+	// CONSTRUCTORS
+template <class T>
+RingBuffer<T>::RingBuffer (size_t capacity) : head (0), tail (0), closed (false) {
+	size_t size = 1;
+
+	while (size < capacity)
+		size *= 2;
+
+	slots.resize (size);
+	mask = size - 1;
+}
+
+
+	// MODIFICATION METHODS
+template <class T>
+bool RingBuffer<T>::tryPush (T& item) {
+	size_t position = tail.load (memory_order_relaxed);
+
+	if (position - head.load (memory_order_acquire) > mask)
+		return false;
+
+	slots[position & mask] = move (item);
+
+	// Publishes the item. The consumer's acquire load of the tail makes the slot's contents visible to it
+	tail.store (position + 1, memory_order_release);
+
+	return true;
+}
+
+template <class T>
+void RingBuffer<T>::push (T& item) {
+	// The consumer is a thread of its own, so waiting gives up the processor instead of spinning on it
+	while (tryPush (item) == false)
+		this_thread::yield ();
+}
+
+template <class T>
+bool RingBuffer<T>::tryPop (T& item) {
+	size_t position = head.load (memory_order_relaxed);
+
+	if (position == tail.load (memory_order_acquire))
+		return false;
+
+	item = move (slots[position & mask]);
+
+	// Frees the slot. The producer won't reuse it until it sees the new head
+	head.store (position + 1, memory_order_release);
+
+	return true;
+}
+
+template <class T>
+bool RingBuffer<T>::pop (T& item) {
+	while (tryPop (item) == false) {
+		// Items pushed before close are still removed, so the queue is checked once more after seeing it closed
+		if (closed.load (memory_order_acquire))
+			return tryPop (item);
+
+		this_thread::yield ();
+	}
+
+	return true;
+}
+
+template <class T>
+void RingBuffer<T>::close () {
+	closed.store (true, memory_order_release);
+}
+
+
+	// CONSTANT METHODS
+template <class T>
+size_t RingBuffer<T>::capacity () const {
+	return slots.size ();
+}
@@ -0,0 +1,72 @@
+#ifndef RingBuffer_
+#define RingBuffer_
+
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+
+using namespace std;
+
+// A bounded queue between exactly one producer thread and one consumer thread
+// The slots are a fixed array used in a circle. The producer only moves the tail and the consumer only moves the head,
+// so neither side ever takes a lock. A full queue makes push wait, which keeps a fast stage from running ahead of a slow one
+// The head and tail are kept on separate cache lines so the two threads don't keep taking the line from each other
+
+/** Used to pass items from one stage of the reading pipeline to the next
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+template <class T>
+class RingBuffer {
+	public:
+			// CONSTRUCTORS
+		/** Constructor
+		 * @param capacity: the most items the queue can hold, rounded up to a power of 2
+		 * @post: creates an empty, open queue */
+		RingBuffer (size_t capacity);
+
+		RingBuffer (const RingBuffer&) = delete;
+		RingBuffer& operator = (const RingBuffer&) = delete;
+
+			// MODIFICATION METHODS
+		/** Adds an item if there is room. Only called by the producer
+		 * @param item: the item to add
+		 * @post: the item is moved into the queue if it was added
+		 * @return: returns true if the item was added, or false if the queue is full */
+		bool tryPush (T& item);
+
+		/** Adds an item, waiting for room if the queue is full. Only called by the producer
+		 * @param item: the item to add
+		 * @post: the item is moved into the queue */
+		void push (T& item);
+
+		/** Removes the oldest item if there is one. Only called by the consumer
+		 * @param item: the variable that will receive the item
+		 * @return: returns true if an item was removed, or false if the queue is empty */
+		bool tryPop (T& item);
+
+		/** Removes the oldest item, waiting for one if the queue is empty. Only called by the consumer
+		 * @param item: the variable that will receive the item
+		 * @return: returns true if an item was removed, or false if the queue is empty and closed */
+		bool pop (T& item);
+
+		/** Marks the end of the items. Only called by the producer
+		 * @post: pop returns false once the items already pushed are removed */
+		void close ();
+
+			// CONSTANT METHODS
+		/** Gets the number of slots
+		 * @return: returns the most items the queue can hold */
+		size_t capacity () const;
+
+	private:
+		vector<T> slots; //!< The items, used in a circle
+		size_t mask; //!< The number of slots minus 1, for finding an item's slot
+		alignas (64) atomic<size_t> head; //!< The number of items removed. Only changed by the consumer
+		alignas (64) atomic<size_t> tail; //!< The number of items added. Only changed by the producer
+		atomic<bool> closed; //!< Whether the producer is done
+};
+
+#include "RingBuffer.cpp"
+#endif
@@ -0,0 +1,298 @@
+#include "RoaringBitmap.h"
+
+	// CONSTRUCTORS
+RoaringBitmap::RoaringBitmap () {}
+
+
+	// MODIFICATION METHODS
+void RoaringBitmap::add (unsigned int n) {
+	unsigned short key = n >> 16;
+	unsigned short low = n & 0xFFFF;
+
+	// Numbers are usually added in order, so the last container is checked first
+	size_t i = containers.size ();
+	if (containers.empty () or containers.back ().key != key) {
+		auto it = lower_bound (containers.begin (), containers.end (), key, [](const Container& c, unsigned short k) {
+			return c.key < k;
+		});
+		i = it - containers.begin ();
+
+		if (it == containers.end () or it->key != key) {
+			Container c;
+			c.key = key;
+			c.count = 0;
+			containers.insert (it, c);
+		}
+	}
+	else
+		i = containers.size () - 1;
+
+	Container& c = containers[i];
+
+	if (c.isBitmap ()) {
+		uint64_t bit = (uint64_t)1 << (low & 63);
+
+		if ((c.bits[low >> 6] & bit) == 0) {
+			c.bits[low >> 6] |= bit;
+			c.count += 1;
+		}
+
+		return;
+	}
+
+	if (c.array.empty () or c.array.back () < low)
+		c.array.push_back (low);
+	else {
+		auto it = lower_bound (c.array.begin (), c.array.end (), low);
+		if (*it == low)
+			return;
+		c.array.insert (it, low);
+	}
+	c.count += 1;
+
+	if (c.count > arrayMax)
+		toBitmap (c);
+}
+
+bool RoaringBitmap::read (const char*& data, const char* end) {
+	unsigned int size;
+
+	containers.clear ();
+
+	if (end - data < 4)
+		return false;
+	memcpy (&size, data, 4);
+	data += 4;
+
+	for (unsigned int i = 0; i < size; ++i) {
+		Container c;
+
+		if (end - data < 6)
+			return false;
+		memcpy (&c.key, data, 2);
+		memcpy (&c.count, data + 2, 4);
+		data += 6;
+
+		if (c.count == 0 or c.count > 65536 or (containers.empty () == false and c.key <= containers.back ().key))
+			return false;
+
+		if (c.count > arrayMax) {
+			if (end - data < bitmapWords * 8)
+				return false;
+			c.bits.resize (bitmapWords);
+			memcpy (c.bits.data (), data, bitmapWords * 8);
+			data += bitmapWords * 8;
+		}
+		else {
+			if (end - data < (long long)c.count * 2)
+				return false;
+			c.array.resize (c.count);
+			memcpy (c.array.data (), data, c.count * 2);
+			data += c.count * 2;
+		}
+
+		containers.push_back (move (c));
+	}
+
+	return true;
+}
+
+
+	// CONSTANT METHODS
+bool RoaringBitmap::contains (unsigned int n) const {
+	unsigned short key = n >> 16;
+	unsigned short low = n & 0xFFFF;
+	auto it = lower_bound (containers.begin (), containers.end (), key, [](const Container& c, unsigned short k) {
+		return c.key < k;
+	});
+
+	if (it == containers.end () or it->key != key)
+		return false;
+
+	if (it->isBitmap ())
+		return (it->bits[low >> 6] >> (low & 63)) & 1;
+
+	return binary_search (it->array.begin (), it->array.end (), low);
+}
+
+unsigned long long RoaringBitmap::cardinality () const {
+	unsigned long long total = 0;
+
+	for (size_t i = 0; i < containers.size (); ++i)
+		total += containers[i].count;
+
+	return total;
+}
+
+RoaringBitmap RoaringBitmap::intersection (const RoaringBitmap& other) const {
+	RoaringBitmap result;
+	size_t i = 0;
+	size_t j = 0;
+
+	// Only containers with the same key can share numbers
+	while (i < containers.size () and j < other.containers.size ()) {
+		if (containers[i].key < other.containers[j].key)
+			i += 1;
+		else if (containers[i].key > other.containers[j].key)
+			j += 1;
+		else {
+			Container c = intersect (containers[i++], other.containers[j++]);
+
+			if (c.count > 0)
+				result.containers.push_back (move (c));
+		}
+	}
+
+	return result;
+}
+
+RoaringBitmap RoaringBitmap::unionWith (const RoaringBitmap& other) const {
+	RoaringBitmap result;
+	size_t i = 0;
+	size_t j = 0;
+
+	// Containers only one side has are copied as they are
+	while (i < containers.size () or j < other.containers.size ()) {
+		if (j == other.containers.size () or (i < containers.size () and containers[i].key < other.containers[j].key))
+			result.containers.push_back (containers[i++]);
+		else if (i == containers.size () or containers[i].key > other.containers[j].key)
+			result.containers.push_back (other.containers[j++]);
+		else
+			result.containers.push_back (unite (containers[i++], other.containers[j++]));
+	}
+
+	return result;
+}
+
+vector<unsigned int> RoaringBitmap::toVector () const {
+	vector<unsigned int> numbers;
+
+	numbers.reserve (cardinality ());
+
+	for (size_t i = 0; i < containers.size (); ++i) {
+		const Container& c = containers[i];
+		unsigned int high = (unsigned int)c.key << 16;
+
+		if (c.isBitmap () == false) {
+			for (size_t k = 0; k < c.array.size (); ++k)
+				numbers.push_back (high | c.array[k]);
+			continue;
+		}
+
+		// Visits only the set bits of each word
+		for (int w = 0; w < bitmapWords; ++w) {
+			for (uint64_t word = c.bits[w]; word != 0; word &= word - 1)
+				numbers.push_back (high | (w << 6) | __builtin_ctzll (word));
+		}
+	}
+
+	return numbers;
+}
+
+void RoaringBitmap::write (string& out) const {
+	unsigned int size = containers.size ();
+
+	out.append ((const char*)&size, 4);
+
+	for (size_t i = 0; i < containers.size (); ++i) {
+		const Container& c = containers[i];
+
+		out.append ((const char*)&c.key, 2);
+		out.append ((const char*)&c.count, 4);
+		if (c.isBitmap ())
+			out.append ((const char*)c.bits.data (), bitmapWords * 8);
+		else
+			out.append ((const char*)c.array.data (), c.array.size () * 2);
+	}
+}
+
+
+	// HELPER FUNCTIONS
+void RoaringBitmap::toBitmap (Container& c) {
+	c.bits.assign (bitmapWords, 0);
+
+	for (size_t k = 0; k < c.array.size (); ++k)
+		c.bits[c.array[k] >> 6] |= (uint64_t)1 << (c.array[k] & 63);
+
+	vector<unsigned short> ().swap (c.array);
+}
+
+void RoaringBitmap::toArray (Container& c) {
+	c.array.clear ();
+	c.array.reserve (c.count);
+
+	for (int w = 0; w < bitmapWords; ++w) {
+		for (uint64_t word = c.bits[w]; word != 0; word &= word - 1)
+			c.array.push_back ((w << 6) | __builtin_ctzll (word));
+	}
+
+	vector<uint64_t> ().swap (c.bits);
+}
+
+RoaringBitmap::Container RoaringBitmap::intersect (const Container& a, const Container& b) {
+	Container c;
+	c.key = a.key;
+	c.count = 0;
+
+	if (a.isBitmap () and b.isBitmap ()) {
+		c.bits.resize (bitmapWords);
+		for (int w = 0; w < bitmapWords; ++w) {
+			c.bits[w] = a.bits[w] & b.bits[w];
+			c.count += __builtin_popcountll (c.bits[w]);
+		}
+
+		if (c.count <= arrayMax)
+			toArray (c);
+	}
+	else if (a.isBitmap () or b.isBitmap ()) {
+		// Keeps the numbers of the array that are set in the bitmap
+		const Container& array = a.isBitmap () ? b : a;
+		const Container& bitmap = a.isBitmap () ? a : b;
+
+		for (size_t k = 0; k < array.array.size (); ++k) {
+			unsigned short low = array.array[k];
+
+			if ((bitmap.bits[low >> 6] >> (low & 63)) & 1)
+				c.array.push_back (low);
+		}
+		c.count = c.array.size ();
+	}
+	else {
+		set_intersection (a.array.begin (), a.array.end (), b.array.begin (), b.array.end (), back_inserter (c.array));
+		c.count = c.array.size ();
+	}
+
+	return c;
+}
+
+RoaringBitmap::Container RoaringBitmap::unite (const Container& a, const Container& b) {
+	Container c;
+	c.key = a.key;
+	c.count = 0;
+
+	if (a.isBitmap () or b.isBitmap ()) {
+		c.bits = a.isBitmap () ? a.bits : b.bits;
+
+		const Container& other = a.isBitmap () ? b : a;
+		if (other.isBitmap ()) {
+			for (int w = 0; w < bitmapWords; ++w)
+				c.bits[w] |= other.bits[w];
+		}
+		else {
+			for (size_t k = 0; k < other.array.size (); ++k)
+				c.bits[other.array[k] >> 6] |= (uint64_t)1 << (other.array[k] & 63);
+		}
+
+		for (int w = 0; w < bitmapWords; ++w)
+			c.count += __builtin_popcountll (c.bits[w]);
+	}
+	else {
+		set_union (a.array.begin (), a.array.end (), b.array.begin (), b.array.end (), back_inserter (c.array));
+		c.count = c.array.size ();
+
+		if (c.count > arrayMax)
+			toBitmap (c);
+	}
+
+	return c;
+}
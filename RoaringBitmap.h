@@ -0,0 +1,110 @@
+#ifndef RoaringBitmap_
+#define RoaringBitmap_
+
+#include <iostream>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace std;
+
+// A compressed set of 32-bit numbers, split into containers by the upper 16 bits of each number
+// A container with up to 4096 numbers stores their lower 16 bits in a sorted array. A fuller container stores a 65536-bit bitmap,
+// which is never bigger than 8 KiB. Intersections and unions work one container at a time, so containers that only one side has
+// are skipped or copied without looking at their numbers
+// When written, a bitmap is its container count (4 bytes) followed by each container: its upper 16 bits (2 bytes),
+// its number count (4 bytes) and then either the 2-byte numbers or the 8 KiB bitmap. Numbers are in the machine's byte order
+
+/** Used to store the record numbers that match a value
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class RoaringBitmap {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an empty set */
+		RoaringBitmap ();
+
+			// MODIFICATION METHODS
+		/** Adds a number to the set
+		 * @param n: the number to add
+		 * @post: the set contains the number. Adding numbers in increasing order is fastest */
+		void add (unsigned int n);
+
+		/** Reads a set written by write
+		 * @param data: the first byte to read. It's moved past the set
+		 * @param end: the byte after the last byte that can be read
+		 * @post: the set holds the numbers that were read
+		 * @return: returns true if a whole set was read, otherwise false */
+		bool read (const char*& data, const char* end);
+
+			// CONSTANT METHODS
+		/** Determines if a number is in the set
+		 * @param n: the number to find
+		 * @return: returns true if the set contains the number */
+		bool contains (unsigned int n) const;
+
+		/** Gets the number of numbers in the set
+		 * @return: returns the number of numbers */
+		unsigned long long cardinality () const;
+
+		/** Finds the numbers in both sets
+		 * @param other: the other set
+		 * @return: returns the intersection of the sets */
+		RoaringBitmap intersection (const RoaringBitmap& other) const;
+
+		/** Finds the numbers in either set
+		 * @param other: the other set
+		 * @return: returns the union of the sets */
+		RoaringBitmap unionWith (const RoaringBitmap& other) const;
+
+		/** Lists the numbers in the set
+		 * @return: returns the numbers in increasing order */
+		vector<unsigned int> toVector () const;
+
+		/** Writes the set
+		 * @param out: the string the set will be appended to */
+		void write (string& out) const;
+
+	private:
+		/** The numbers that share their upper 16 bits */
+		struct Container {
+			unsigned short key; //!< The upper 16 bits of the numbers
+			unsigned int count; //!< The number of numbers
+			vector<unsigned short> array; //!< The lower 16 bits of the numbers when there are few of them
+			vector<uint64_t> bits; //!< A bit for each possible lower 16 bits when there are many of them
+
+			bool isBitmap () const { return bits.empty () == false; }
+		};
+
+		/** Switches a container from an array to a bitmap
+		 * @param c: the container */
+		static void toBitmap (Container& c);
+
+		/** Switches a container from a bitmap to an array
+		 * @param c: the container */
+		static void toArray (Container& c);
+
+		/** Finds the numbers in both containers
+		 * @param a: the first container
+		 * @param b: the second container, which has the same key
+		 * @return: returns the intersection, which may be empty */
+		static Container intersect (const Container& a, const Container& b);
+
+		/** Finds the numbers in either container
+		 * @param a: the first container
+		 * @param b: the second container, which has the same key
+		 * @return: returns the union */
+		static Container unite (const Container& a, const Container& b);
+
+		static const unsigned int arrayMax = 4096; //!< The most numbers an array container holds
+		static const int bitmapWords = 1024; //!< The number of 64-bit words in a bitmap container
+
+		vector<Container> containers; //!< The containers, sorted by key
+};
+
+#include "RoaringBitmap.cpp"
+#endif
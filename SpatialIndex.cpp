@@ -0,0 +1,208 @@
+#include "SpatialIndex.h"
+
+	// CONSTRUCTORS
+SpatialIndex::SpatialIndex () {}
+
+
+	// MODIFICATION METHODS
+int SpatialIndex::build (vector<PostalCode> pcs) {
+	postalCodes.clear ();
+	points.clear ();
+
+	for (size_t i = 0; i < pcs.size (); ++i) {
+		if (pcs[i].getLat () < -90 or pcs[i].getLat () > 90 or isfinite (pcs[i].getLong ()) == false)
+			continue;
+
+		Point p;
+		toPoint (pcs[i].getLat (), pcs[i].getLong (), p.coord);
+		p.index = postalCodes.size ();
+		points.push_back (p);
+		postalCodes.push_back (move (pcs[i]));
+	}
+
+	axes.assign (points.size (), 0);
+	buildRange (0, points.size ());
+
+	return points.size ();
+}
+
+
+	// CONSTANT METHODS
+vector<SpatialMatch> SpatialIndex::nearest (double lat, double lng, int k) const {
+	vector<SpatialMatch> matches;
+
+	if (k <= 0 or points.empty ())
+		return matches;
+
+	double q[3];
+	priority_queue<pair<double, int> > best;
+
+	toPoint (lat, lng, q);
+	searchNearest (0, points.size (), q, k, best);
+
+	for (; best.empty () == false; best.pop ()) {
+		const PostalCode& pc = postalCodes[best.top ().second];
+		matches.push_back ({best.top ().second, haversine (lat, lng, pc.getLat (), pc.getLong ())});
+	}
+	sortMatches (matches);
+
+	return matches;
+}
+
+vector<SpatialMatch> SpatialIndex::withinRadius (double lat, double lng, double km) const {
+	vector<SpatialMatch> matches;
+
+	if (km < 0 or points.empty ())
+		return matches;
+
+	// The chord across an arc of km kilometers. The limit is padded a little, since the exact check is done with haversine
+	double angle = min (km / earthRadius, M_PI);
+	double chord = 2 * sin (angle / 2);
+	double q[3];
+	vector<int> found;
+
+	toPoint (lat, lng, q);
+	searchRadius (0, points.size (), q, chord * chord * (1 + 1e-9) + 1e-15, found);
+
+	for (size_t i = 0; i < found.size (); ++i) {
+		const PostalCode& pc = postalCodes[found[i]];
+		double distance = haversine (lat, lng, pc.getLat (), pc.getLong ());
+
+		if (distance <= km)
+			matches.push_back ({found[i], distance});
+	}
+	sortMatches (matches);
+
+	return matches;
+}
+
+const PostalCode& SpatialIndex::getPostalCode (int index) const {
+	return postalCodes[index];
+}
+
+int SpatialIndex::size () const {
+	return postalCodes.size ();
+}
+
+double SpatialIndex::haversine (double lat1, double lng1, double lat2, double lng2) {
+	const double toRadians = M_PI / 180;
+	double dLat = (lat2 - lat1) * toRadians;
+	double dLng = (lng2 - lng1) * toRadians;
+	double a = sin (dLat / 2) * sin (dLat / 2) + cos (lat1 * toRadians) * cos (lat2 * toRadians) * sin (dLng / 2) * sin (dLng / 2);
+
+	return 2 * earthRadius * asin (min (1.0, sqrt (a)));
+}
+
+
+	// HELPER FUNCTIONS
+void SpatialIndex::toPoint (double lat, double lng, double coord[3]) {
+	const double toRadians = M_PI / 180;
+	double cosLat = cos (lat * toRadians);
+
+	coord[0] = cosLat * cos (lng * toRadians);
+	coord[1] = cosLat * sin (lng * toRadians);
+	coord[2] = sin (lat * toRadians);
+}
+
+void SpatialIndex::buildRange (int lo, int hi) {
+	if (hi - lo <= 1)
+		return;
+
+	// Splits on the axis the points are most spread out on
+	double low[3] = {2, 2, 2};
+	double high[3] = {-2, -2, -2};
+	for (int i = lo; i < hi; ++i) {
+		for (int a = 0; a < 3; ++a) {
+			low[a] = min (low[a], points[i].coord[a]);
+			high[a] = max (high[a], points[i].coord[a]);
+		}
+	}
+
+	int axis = 0;
+	for (int a = 1; a < 3; ++a) {
+		if (high[a] - low[a] > high[axis] - low[axis])
+			axis = a;
+	}
+
+	int mid = lo + (hi - lo) / 2;
+	nth_element (points.begin () + lo, points.begin () + mid, points.begin () + hi, [axis] (const Point& a, const Point& b) {
+		return a.coord[axis] < b.coord[axis];
+	});
+	axes[mid] = axis;
+
+	buildRange (lo, mid);
+	buildRange (mid + 1, hi);
+}
+
+void SpatialIndex::searchNearest (int lo, int hi, const double q[3], size_t k, priority_queue<pair<double, int> >& best) const {
+	if (lo >= hi)
+		return;
+
+	int mid = lo + (hi - lo) / 2;
+	const Point& p = points[mid];
+	double d = chordSquared (p, q);
+
+	if (best.size () < k)
+		best.push (make_pair (d, p.index));
+	else if (d < best.top ().first) {
+		best.pop ();
+		best.push (make_pair (d, p.index));
+	}
+
+	if (hi - lo == 1)
+		return;
+
+	// Searches the side of the split q is on first, then the other side if it could hold a nearer point
+	double diff = q[axes[mid]] - p.coord[axes[mid]];
+	bool left = diff < 0;
+
+	if (left)
+		searchNearest (lo, mid, q, k, best);
+	else
+		searchNearest (mid + 1, hi, q, k, best);
+
+	if (best.size () < k or diff * diff < best.top ().first) {
+		if (left)
+			searchNearest (mid + 1, hi, q, k, best);
+		else
+			searchNearest (lo, mid, q, k, best);
+	}
+}
+
+void SpatialIndex::searchRadius (int lo, int hi, const double q[3], double limit, vector<int>& found) const {
+	if (lo >= hi)
+		return;
+
+	int mid = lo + (hi - lo) / 2;
+	const Point& p = points[mid];
+
+	if (chordSquared (p, q) <= limit)
+		found.push_back (p.index);
+
+	if (hi - lo == 1)
+		return;
+
+	double diff = q[axes[mid]] - p.coord[axes[mid]];
+
+	if (diff < 0 or diff * diff <= limit)
+		searchRadius (lo, mid, q, limit, found);
+	if (diff >= 0 or diff * diff <= limit)
+		searchRadius (mid + 1, hi, q, limit, found);
+}
+
+double SpatialIndex::chordSquared (const Point& p, const double q[3]) {
+	double dx = p.coord[0] - q[0];
+	double dy = p.coord[1] - q[1];
+	double dz = p.coord[2] - q[2];
+
+	return dx * dx + dy * dy + dz * dz;
+}
+
+void SpatialIndex::sortMatches (vector<SpatialMatch>& matches) const {
+	sort (matches.begin (), matches.end (), [this] (const SpatialMatch& a, const SpatialMatch& b) {
+		if (a.distance != b.distance)
+			return a.distance < b.distance;
+
+		return postalCodes[a.index].getZipCode () < postalCodes[b.index].getZipCode ();
+	});
+}
@@ -0,0 +1,133 @@
+#ifndef SpatialIndex_
+#define SpatialIndex_
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <algorithm>
+#include <cmath>
+#include "PostalCode.h"
+
+using namespace std;
+
+// Finds the postal codes nearest to a coordinate, or within a distance of it, without scanning every postal code
+// Each coordinate is turned into a point on the unit sphere, and the points are stored in a k-d tree. The straight-line (chord) distance
+// between two points on the sphere grows with the distance along its surface, so the nearest points by chord are the nearest by haversine,
+// and the tree can prune with plain x, y and z comparisons. There are no problems at the poles or where the longitude wraps around
+// The tree is implicit: the points are reordered so the middle point of each range splits it, and only the split axis is stored for each point
+
+/** A postal code found by a spatial query
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+struct SpatialMatch {
+	int index; //!< The position of the postal code in the index, for getPostalCode
+	double distance; //!< The haversine distance to the postal code in kilometers
+};
+
+/** Used to find postal codes by location
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class SpatialIndex {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an empty index */
+		SpatialIndex ();
+
+			// MODIFICATION METHODS
+		/** Builds the index
+		 * @param pcs: the postal codes to index. Postal codes with a latitude outside of -90 to 90 are left out
+		 * @post: the index holds the postal codes and any postal codes it held before are removed
+		 * @return: returns the number of postal codes indexed */
+		int build (vector<PostalCode> pcs);
+
+			// CONSTANT METHODS
+		/** Finds the nearest postal codes to a coordinate
+		 * @param lat: the latitude of the coordinate
+		 * @param lng: the longitude of the coordinate
+		 * @param k: the number of postal codes to find
+		 * @return: returns up to k postal codes, nearest first */
+		vector<SpatialMatch> nearest (double lat, double lng, int k) const;
+
+		/** Finds every postal code within a distance of a coordinate
+		 * @param lat: the latitude of the coordinate
+		 * @param lng: the longitude of the coordinate
+		 * @param km: the distance in kilometers
+		 * @return: returns the postal codes, nearest first */
+		vector<SpatialMatch> withinRadius (double lat, double lng, double km) const;
+
+		/** Gets an indexed postal code
+		 * @param index: the index from a SpatialMatch
+		 * @return: returns the postal code */
+		const PostalCode& getPostalCode (int index) const;
+
+		/** Gets the number of indexed postal codes
+		 * @return: returns the number of postal codes */
+		int size () const;
+
+		/** Finds the distance between two coordinates along the surface of the earth
+		 * @param lat1: the latitude of the first coordinate
+		 * @param lng1: the longitude of the first coordinate
+		 * @param lat2: the latitude of the second coordinate
+		 * @param lng2: the longitude of the second coordinate
+		 * @return: returns the distance in kilometers */
+		static double haversine (double lat1, double lng1, double lat2, double lng2);
+
+		static constexpr double earthRadius = 6371.0088; //!< The mean radius of the earth in kilometers
+
+	private:
+		/** A postal code's position on the unit sphere */
+		struct Point {
+			double coord[3]; //!< The x, y and z of the point
+			int index; //!< The position of the postal code in postalCodes
+		};
+
+		/** Turns a coordinate into a point on the unit sphere
+		 * @param lat: the latitude
+		 * @param lng: the longitude
+		 * @param coord: the array that will receive the x, y and z of the point */
+		static void toPoint (double lat, double lng, double coord[3]);
+
+		/** Arranges a range of points into a subtree
+		 * @param lo: the first point of the range
+		 * @param hi: the point after the last point of the range
+		 * @post: the middle point splits the range along the axis the points are most spread out on, and both halves are arranged the same way */
+		void buildRange (int lo, int hi);
+
+		/** Searches a subtree for the nearest points
+		 * @param lo: the first point of the subtree
+		 * @param hi: the point after the last point of the subtree
+		 * @param q: the point being searched for
+		 * @param k: the number of points to find
+		 * @param best: the nearest points found so far by squared chord distance, farthest on top
+		 * @post: best holds the nearest points of the subtree and the points it held before */
+		void searchNearest (int lo, int hi, const double q[3], size_t k, priority_queue<pair<double, int> >& best) const;
+
+		/** Searches a subtree for the points within a chord distance
+		 * @param lo: the first point of the subtree
+		 * @param hi: the point after the last point of the subtree
+		 * @param q: the point being searched for
+		 * @param limit: the largest squared chord distance to find
+		 * @param found: the vector that will receive the positions of the points that were found */
+		void searchRadius (int lo, int hi, const double q[3], double limit, vector<int>& found) const;
+
+		/** Gets the squared chord distance between a point and q
+		 * @param p: the point
+		 * @param q: the other point's x, y and z
+		 * @return: returns the squared distance */
+		static double chordSquared (const Point& p, const double q[3]);
+
+		/** Sorts matches by distance, breaking ties by zip code
+		 * @param matches: the matches to sort
+		 * @post: the matches are sorted nearest first */
+		void sortMatches (vector<SpatialMatch>& matches) const;
+
+		vector<PostalCode> postalCodes; //!< The indexed postal codes
+		vector<Point> points; //!< The points in tree order
+		vector<unsigned char> axes; //!< The split axis of each point's subtree
+};
+
+#include "SpatialIndex.cpp"
+#endif
@@ -0,0 +1,100 @@
+#include "StateExtremes.h"
+
+	// CONSTRUCTORS
+StateExtremes::StateExtremes () : eastZip (-1), westZip (-1), northZip (-1), southZip (-1), eastLng (0), westLng (0), northLat (0), southLat (0), count (0) {}
+
+StateExtremes::StateExtremes (int eastZip, double eastLng, int westZip, double westLng, int northZip, double northLat, int southZip, double southLat, long long count) :
+	eastZip (eastZip), westZip (westZip), northZip (northZip), southZip (southZip), eastLng (eastLng), westLng (westLng), northLat (northLat), southLat (southLat), count (count) {}
+
+
+	// MODIFICATION METHODS
+void StateExtremes::update (int zipCode, double lat, double lng) {
+	// The first postal code is every extreme
+	if (count == 0) {
+		eastZip = westZip = northZip = southZip = zipCode;
+		eastLng = westLng = lng;
+		northLat = southLat = lat;
+	}
+	else {
+		if (lng < eastLng or (lng == eastLng and zipCode < eastZip)) {
+			eastZip = zipCode;
+			eastLng = lng;
+		}
+
+		if (lng > westLng or (lng == westLng and zipCode > westZip)) {
+			westZip = zipCode;
+			westLng = lng;
+		}
+
+		if (lat > northLat or (lat == northLat and zipCode < northZip)) {
+			northZip = zipCode;
+			northLat = lat;
+		}
+
+		if (lat < southLat or (lat == southLat and zipCode > southZip)) {
+			southZip = zipCode;
+			southLat = lat;
+		}
+	}
+
+	count += 1;
+}
+
+void StateExtremes::update (const PostalCode& pc) {
+	update (pc.getZipCode (), pc.getLat (), pc.getLong ());
+}
+
+void StateExtremes::merge (const StateExtremes& other) {
+	if (other.count == 0)
+		return;
+
+	if (count == 0) {
+		*this = other;
+		return;
+	}
+
+	// Each extreme is only compared with the same extreme of the other object
+	if (other.eastLng < eastLng or (other.eastLng == eastLng and other.eastZip < eastZip)) {
+		eastZip = other.eastZip;
+		eastLng = other.eastLng;
+	}
+
+	if (other.westLng > westLng or (other.westLng == westLng and other.westZip > westZip)) {
+		westZip = other.westZip;
+		westLng = other.westLng;
+	}
+
+	if (other.northLat > northLat or (other.northLat == northLat and other.northZip < northZip)) {
+		northZip = other.northZip;
+		northLat = other.northLat;
+	}
+
+	if (other.southLat < southLat or (other.southLat == southLat and other.southZip > southZip)) {
+		southZip = other.southZip;
+		southLat = other.southLat;
+	}
+
+	count += other.count;
+}
+
+
+	// CONSTANT METHODS
+int StateExtremes::getEasternmost () const {
+	return eastZip;
+}
+
+int StateExtremes::getWesternmost () const {
+	return westZip;
+}
+
+int StateExtremes::getNorthernmost () const {
+	return northZip;
+}
+
+int StateExtremes::getSouthernmost () const {
+	return southZip;
+}
+
+long long StateExtremes::getCount () const {
+	return count;
+}
@@ -0,0 +1,90 @@
+#ifndef StateExtremes_
+#define StateExtremes_
+
+#include <iostream>
+#include "PostalCode.h"
+
+using namespace std;
+
+// Keeps track of the farthest postal code in each compass direction for one state
+// Postal codes are added one at a time, so only four postal codes are ever stored no matter how many are added
+// Ties are broken by zip code the same way the sorted table is:
+//	northernmost and easternmost keep the lowest zip code, southernmost and westernmost keep the highest
+
+/** Used to find the farthest postal codes of a state without storing them all
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class StateExtremes {
+	public:
+			// CONSTRUCTORS
+		/** Default constructor
+		 * @post: creates an object that hasn't seen any postal codes */
+		StateExtremes ();
+
+		/** Constructor that sets every extreme
+		 * @param eastZip: the zip code of the easternmost postal code
+		 * @param eastLng: the longitude of the easternmost postal code
+		 * @param westZip: the zip code of the westernmost postal code
+		 * @param westLng: the longitude of the westernmost postal code
+		 * @param northZip: the zip code of the northernmost postal code
+		 * @param northLat: the latitude of the northernmost postal code
+		 * @param southZip: the zip code of the southernmost postal code
+		 * @param southLat: the latitude of the southernmost postal code
+		 * @param count: the number of postal codes the extremes were found from
+		 * @post: creates an object that can be merged with others, for example the partial results of a vectorized search */
+		StateExtremes (int eastZip, double eastLng, int westZip, double westLng, int northZip, double northLat, int southZip, double southLat, long long count);
+
+			// MODIFICATION METHODS
+		/** Compares a postal code with the current extremes
+		 * @param zipCode: the zip code of the postal code
+		 * @param lat: the latitude of the postal code
+		 * @param lng: the longitude of the postal code
+		 * @post: the postal code replaces any extremes it's farther than */
+		void update (int zipCode, double lat, double lng);
+
+		/** Compares a postal code with the current extremes
+		 * @param pc: the postal code to compare
+		 * @post: the postal code replaces any extremes it's farther than */
+		void update (const PostalCode& pc);
+
+		/** Combines the extremes of two sets of postal codes from the same state
+		 * @param other: the extremes of the other set
+		 * @post: this object holds the extremes of both sets */
+		void merge (const StateExtremes& other);
+
+			// CONSTANT METHODS
+		/** Gets the zip code with the lowest longitude
+		 * @return: returns the zip code or -1 if no postal codes were added */
+		int getEasternmost () const;
+
+		/** Gets the zip code with the highest longitude
+		 * @return: returns the zip code or -1 if no postal codes were added */
+		int getWesternmost () const;
+
+		/** Gets the zip code with the highest latitude
+		 * @return: returns the zip code or -1 if no postal codes were added */
+		int getNorthernmost () const;
+
+		/** Gets the zip code with the lowest latitude
+		 * @return: returns the zip code or -1 if no postal codes were added */
+		int getSouthernmost () const;
+
+		/** Gets the number of postal codes that were added
+		 * @return: returns the number of postal codes */
+		long long getCount () const;
+
+	private:
+		int eastZip; //!< The zip code of the easternmost postal code
+		int westZip; //!< The zip code of the westernmost postal code
+		int northZip; //!< The zip code of the northernmost postal code
+		int southZip; //!< The zip code of the southernmost postal code
+		double eastLng; //!< The longitude of the easternmost postal code
+		double westLng; //!< The longitude of the westernmost postal code
+		double northLat; //!< The latitude of the northernmost postal code
+		double southLat; //!< The latitude of the southernmost postal code
+		long long count; //!< The number of postal codes that were added
+};
+
+#include "StateExtremes.cpp"
+#endif
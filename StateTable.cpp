@@ -0,0 +1,808 @@
+#include "StateTable.h"
+
+// Unpacks every record of a batch and passes the valid ones to add
+// Buffer is the static type of the buffer. When it's NewPostalCodeBuffer the unpack calls aren't virtual, since it doesn't let them be overridden
+template <class Buffer, class Add>
+int unpackBatchAs (const PostalCodeBatch& batch, Buffer& buff, Add add) {
+	string_view city, state, county; // Point into the batch, so nothing is copied until they're stored
+	int zipCode;
+	double lat, lng;
+	int valid = 0;
+
+	for (int i = 0; i < batch.size (); ++i) {
+		buff.select (batch, i);
+
+		if (buff.unpackRecord (zipCode, city, state, county, lat, lng) != -1) {
+			add (zipCode, city, state, county, lat, lng);
+			valid += 1;
+		}
+	}
+
+	return valid;
+}
+
+// Prints how many times a DAT file skipped past a damaged record or block, if it did
+static void displaySkipped (PostalCodeBuffer* buffer) {
+	NewPostalCodeBuffer* dat = dynamic_cast<NewPostalCodeBuffer*> (buffer);
+
+	if (dat != NULL and dat->getResyncCount () > 0)
+		cout << "Number of damaged blocks skipped: " << dat->getResyncCount () << endl;
+}
+
+// Prints why a DAT file wasn't read when its header is damaged or from a version the buffers can't read
+static void displayUnsupported () {
+	cerr << "Error: the header of the input file is damaged or from an unsupported version" << endl;
+}
+
+// Skips past the header in the file. A DAT header the buffer can't read fails the same way for every reader
+static bool skipHeader (PostalCodeBuffer* buffer, istream& file) {
+	NewPostalCodeBuffer* dat = dynamic_cast<NewPostalCodeBuffer*> (buffer);
+
+	buffer->readHeader (file, "", "");
+	if (dat != NULL and dat->isSupported () == false) {
+		displayUnsupported ();
+		return false;
+	}
+
+	return true;
+}
+
+// Reads the next batch of records, timing the read for --stats
+static int readBatchTimed (PostalCodeBuffer* buffer, istream& file, PostalCodeBatch& batch) {
+	STATS_TIME (statsRead);
+
+	return buffer->readBatch (file, batch, batchSize);
+}
+
+// Unpacks the buffer's contents into a postal code object
+int unpackPostalCode (PostalCode& pc, PostalCodeBuffer* buff) {
+	STATS_SAMPLE (statsUnpack);
+	string_view city, state, county; // Point into the buffer's record, so nothing is copied until the strings are set
+	int zipCode;
+	double lat, lng;
+	int result = buff->unpackRecord (zipCode, city, state, county, lat, lng);
+
+	if (result == -1)
+		return -1;
+
+	pc.setZipCode (zipCode);
+	pc.setCity (city);
+	pc.setState (state);
+	pc.setCounty (county);
+	pc.setLat (lat);
+	pc.setLong (lng);
+	
+	return result;
+}
+
+int unpackBatch (const PostalCodeBatch& batch, PostalCodeBuffer* buff, vector<PostalCode>& postalCodes) {
+	STATS_TIME (statsUnpack);
+	NewPostalCodeBuffer* dat = dynamic_cast<NewPostalCodeBuffer*> (buff);
+	auto add = [&postalCodes] (int zipCode, string_view city, string_view state, string_view county, double lat, double lng) {
+		postalCodes.emplace_back ();
+		PostalCode& pc = postalCodes.back ();
+		pc.setZipCode (zipCode);
+		pc.setCity (city);
+		pc.setState (state);
+		pc.setCounty (county);
+		pc.setLat (lat);
+		pc.setLong (lng);
+	};
+
+	postalCodes.clear ();
+
+	return dat != NULL ? unpackBatchAs (batch, *dat, add) : unpackBatchAs (batch, *buff, add);
+}
+
+int unpackBatch (const PostalCodeBatch& batch, PostalCodeBuffer* buff, PostalCodeColumns& columns) {
+	STATS_TIME (statsUnpack);
+	NewPostalCodeBuffer* dat = dynamic_cast<NewPostalCodeBuffer*> (buff);
+	auto add = [&columns] (int zipCode, string_view city, string_view state, string_view county, double lat, double lng) {
+		columns.add (zipCode, city, state, county, lat, lng);
+	};
+
+	return dat != NULL ? unpackBatchAs (batch, *dat, add) : unpackBatchAs (batch, *buff, add);
+}
+
+int packPostalCode (const PostalCode& pc, PostalCodeBuffer* buff) {
+	buff->clear ();
+
+	if (buff->packInt (pc.getZipCode ()) == -1
+		or buff->pack (pc.getCity ().data ()) == -1
+		or buff->pack (pc.getState ().data ()) == -1
+		or buff->pack (pc.getCounty ().data ()) == -1
+		or buff->packCoordinate (pc.getLat ()) == -1
+		or buff->packCoordinate (pc.getLong ()) == -1)
+		return -1;
+
+	return buff->getLength ();
+}
+
+bool fillTable (map<string, vector<PostalCode> >& stateMap, const char* filename, PostalCodeBuffer* buffer, string fileFormat) {
+	// Open the CSV data file
+    ifstream infile(filename);
+    if (!infile.is_open()) {
+        cerr << "Error: could not open input file" << endl;
+        return false;
+    }
+
+    // Skip past the header in the file
+    if (!skipHeader (buffer, infile))
+		return false;
+	
+	int records = 0;
+	int successes = 0;
+
+	PostalCodeBatch batch;
+	vector<PostalCode> postalCodes;
+
+    // Read the file a batch at a time and store PostalCode objects in the map
+    while (readBatchTimed (buffer, infile, batch) > 0) {
+        records += batch.size ();
+
+        // Unpack the data from the batch into PostalCode objects
+		int valid = unpackBatch (batch, buffer, postalCodes);
+		
+		for (int i = valid; i < batch.size (); ++i)
+            cout << "Invalid record: " << endl;
+		
+        // Add each PostalCode object to the appropriate state vector in the map
+		STATS_TIME (statsInsert);
+		for (size_t i = 0; i < postalCodes.size (); ++i)
+			stateMap[string (postalCodes[i].getState ())].push_back (move (postalCodes[i]));
+		
+		successes += valid;
+    }
+	
+	cout << "Number of records read: " << records << endl;
+	cout << "Number of valid records read: " << successes << endl;
+	displaySkipped (buffer);
+	STATS_COUNT (statsRecordsRead, records);
+	STATS_COUNT (statsRecordsRejected, records - successes);
+
+	if (successes <= 0)
+		cout << "No records were read... Make sure you selected the correct file format and that the file isn't corrupt" << endl;
+
+    // Close the input file
+    infile.close();
+	
+	return true;
+}
+
+bool fillExtremes (map<string, StateExtremes>& extremesMap, const char* filename, PostalCodeBuffer* buffer) {
+	// Open the data file
+    ifstream infile(filename);
+    if (!infile.is_open()) {
+        cerr << "Error: could not open input file" << endl;
+        return false;
+    }
+
+    // Skip past the header in the file
+    if (!skipHeader (buffer, infile))
+		return false;
+	
+	int records = 0;
+	int successes = 0;
+	PostalCodeBatch batch; // Reused for every batch, so memory use doesn't depend on the size of the file
+	vector<PostalCode> postalCodes;
+
+    // Read the file and only keep the farthest postal codes of each state
+    while (readBatchTimed (buffer, infile, batch) > 0) {
+        records += batch.size ();
+
+		// The extremes only keep numbers, so each batch's strings are dropped along with the batch
+		unique_ptr<StringPool> pool = PostalCode::createPool ();
+		StringPool* previous = StringPool::setCurrent (pool.get ());
+		int valid = unpackBatch (batch, buffer, postalCodes);
+
+		for (int i = valid; i < batch.size (); ++i)
+            cout << "Invalid record: " << endl;
+
+		STATS_TIME (statsInsert);
+		for (size_t i = 0; i < postalCodes.size (); ++i)
+			extremesMap[string (postalCodes[i].getState ())].update (postalCodes[i]);
+
+		postalCodes.clear ();
+		StringPool::setCurrent (previous);
+		
+		successes += valid;
+    }
+	
+	cout << "Number of records read: " << records << endl;
+	cout << "Number of valid records read: " << successes << endl;
+	displaySkipped (buffer);
+	STATS_COUNT (statsRecordsRead, records);
+	STATS_COUNT (statsRecordsRejected, records - successes);
+
+	if (successes <= 0)
+		cout << "No records were read... Make sure you selected the correct file format and that the file isn't corrupt" << endl;
+
+    infile.close();
+	
+	return true;
+}
+
+bool fillColumns (PostalCodeColumns& columns, const char* filename, PostalCodeBuffer* buffer) {
+	// Open the data file
+    ifstream infile(filename);
+    if (!infile.is_open()) {
+        cerr << "Error: could not open input file" << endl;
+        return false;
+    }
+
+    // Skip past the header in the file
+    if (!skipHeader (buffer, infile))
+		return false;
+	
+	int records = 0;
+	int successes = 0;
+	PostalCodeBatch batch;
+
+    // Read the file and append each postal code to the columns
+    while (readBatchTimed (buffer, infile, batch) > 0) {
+        records += batch.size ();
+
+		// The fields go straight from the batch into the columns
+		int valid = unpackBatch (batch, buffer, columns);
+
+		for (int i = valid; i < batch.size (); ++i)
+            cout << "Invalid record: " << endl;
+		
+		successes += valid;
+    }
+	
+	cout << "Number of records read: " << records << endl;
+	cout << "Number of valid records read: " << successes << endl;
+	displaySkipped (buffer);
+	STATS_COUNT (statsRecordsRead, records);
+	STATS_COUNT (statsRecordsRejected, records - successes);
+
+	if (successes <= 0)
+		cout << "No records were read... Make sure you selected the correct file format and that the file isn't corrupt" << endl;
+
+    infile.close();
+
+	// Makes each state's rows contiguous for the report
+	columns.groupByState ();
+	
+	return true;
+}
+
+bool fillTableParallel (map<string, vector<PostalCode> >& stateMap, const char* filename, int threads, string fileFormat) {
+	bool csv = fileFormat == "-old" or fileFormat == "-csv";
+
+	// The file is shared by every thread through a single mapping
+	MappedFile file (filename);
+	if (!file.isOpen ()) {
+		cerr << "Error: could not open input file" << endl;
+		return false;
+	}
+
+	// Skips past the header in the file
+	size_t begin = file.size ();
+	size_t end = file.size ();
+	bool binary = false;
+	bool fixed = false;
+	bool blocked = false;
+	unsigned short version = 1;
+	string indexFilename, indexSchema;
+	ChecksumDirectory checksums;
+	if (csv) {
+		STATS_TIME (statsHeader);
+		CsvPostalCodeBuffer header;
+		int headerSize = header.parse (file.data (), file.size (), true);
+		begin = headerSize == -1 ? file.size () : headerSize;
+		STATS_COUNT (statsBytesRead, begin);
+	}
+	else {
+		unsigned int headerSize;
+		int prefix = PostalCodeHeader::decodeHeaderLength (file.data (), file.size (), headerSize);
+		if (prefix != -1)
+			begin = prefix + headerSize;
+
+		// Every thread decodes the fields the way the header describes them
+		// A damaged header fails before the file is split, just like it does for the serial readers
+		ifstream infile (filename, ios::binary);
+		PostalCodeHeader header;
+		if (header.readHeader (infile) == -1 or header.isSupported () == false) {
+			displayUnsupported ();
+			return false;
+		}
+		binary = header.getStructure () == "LENGTH/BINARY";
+		fixed = header.getStructure () == "FIXED/FIXED";
+		blocked = header.getStructure () == "BLOCK/BINARY";
+		version = header.getVersion ();
+		indexFilename = header.getIndexFilename ();
+		indexSchema = header.getIndexSchema ();
+
+		// Files with checksums end at their checksum directory
+		if (blocked == false and checksums.read (file.data (), file.size (), begin))
+			end = checksums.getDataEnd ();
+	}
+
+	// Compressed files are split on block boundaries from the block directory instead of record boundaries
+	vector<size_t> bounds;
+	if (blocked) {
+		ifstream infile (filename, ios::binary);
+		BlockPostalCodeBuffer buffer;
+		buffer.readHeader (infile, indexFilename, indexSchema);
+		for (int t = 0; t <= threads; ++t)
+			bounds.push_back ((size_t) buffer.getBlockCount () * t / threads);
+	}
+	else if (csv)
+		bounds = splitCsvRecords (file.data (), begin, file.size (), threads);
+	// Checksum blocks start on record boundaries, so the ranges are rounded to them without reading any records
+	else if (checksums.empty () == false) {
+		bounds.push_back (begin);
+		for (int t = 1; t < threads; ++t)
+			bounds.push_back (checksums.nextCheckpoint (begin + (end - begin) * t / threads - 1));
+		bounds.push_back (end);
+	}
+	else if (fixed)
+		bounds = splitFixedRecords (begin, end, NewPostalCodeBuffer::fixedRecordSize, threads);
+	else
+		bounds = splitRecords (file.data (), begin, end, threads, version, binary);
+	vector<map<string, vector<PostalCode> > > tables (threads);
+	vector<int> records (threads, 0);
+	vector<int> invalid (threads, 0);
+	vector<int> resyncs (threads, 0);
+	vector<unique_ptr<StringPool> > pools;
+	vector<thread> workers;
+
+	// Each thread fills its own table from its own range of records, with its own strings so the threads don't share a lock
+	for (int t = 0; t < threads; ++t)
+		pools.push_back (PostalCode::createPool ());
+	for (int t = 0; t < threads; ++t) {
+		workers.push_back (thread ([&, t] () {
+			StringPool::setCurrent (pools[t].get ());
+			PostalCode postalCode;
+			auto insert = [&] () {
+				STATS_SAMPLE (statsInsert);
+				tables[t][string (postalCode.getState ())].push_back (postalCode);
+			};
+
+			if (csv) {
+				CsvPostalCodeBuffer buffer;
+				size_t pos = bounds[t];
+				int consumed;
+				auto parse = [&] () {
+					STATS_SAMPLE (statsRead);
+					return buffer.parse (file.data () + pos, bounds[t + 1] - pos, true);
+				};
+
+				// Every range ends on a record boundary, so the end of the range is treated like the end of the file
+				while (pos < bounds[t + 1] and (consumed = parse ()) > 0) {
+					pos += consumed;
+					records[t] += 1;
+
+					if (unpackPostalCode (postalCode, &buffer) == -1)
+						invalid[t] += 1;
+					else
+						insert ();
+				}
+				STATS_COUNT (statsBytesRead, pos - bounds[t]);
+			}
+			else if (blocked) {
+				// Each thread decompresses its own blocks through its own stream
+				ifstream infile (filename, ios::binary);
+				BlockPostalCodeBuffer buffer;
+				long long recaddr;
+				auto read = [&] () {
+					STATS_SAMPLE (statsRead);
+					return buffer.read (infile);
+				};
+
+				if (buffer.readHeader (infile, indexFilename, indexSchema) == -1 or buffer.seekBlock (bounds[t]) == false)
+					return;
+
+				while ((size_t) (recaddr = read ()) >> 16 < bounds[t + 1] and recaddr != -1) {
+					records[t] += 1;
+
+					if (unpackPostalCode (postalCode, &buffer) == -1)
+						invalid[t] += 1;
+					else
+						insert ();
+				}
+				resyncs[t] = buffer.getResyncCount ();
+			}
+			else {
+				MappedPostalCodeBuffer buffer (file.data (), bounds[t], bounds[t + 1]);
+				buffer.setVersion (version);
+				buffer.setBinary (binary);
+				buffer.setFixed (fixed);
+				buffer.setChecksums (checksums);
+				auto next = [&buffer] () {
+					STATS_SAMPLE (statsRead);
+					return buffer.next ();
+				};
+
+				while (next () != -1) {
+					records[t] += 1;
+
+					if (unpackPostalCode (postalCode, &buffer) == -1)
+						invalid[t] += 1;
+					else
+						insert ();
+				}
+				STATS_COUNT (statsBytesRead, bounds[t + 1] - bounds[t]);
+				resyncs[t] = buffer.getResyncCount ();
+			}
+		}));
+	}
+
+	int totalRecords = 0;
+	int successes = 0;
+	int skipped = 0;
+
+	// The tables are merged in file order so each state's postal codes stay in the order fillTable would read them
+	for (int t = 0; t < threads; ++t) {
+		workers[t].join ();
+		mergeTables (stateMap, tables[t], *pools[t]);
+		pools[t].reset ();
+
+		for (int i = 0; i < invalid[t]; ++i)
+			cout << "Invalid record: " << endl;
+
+		totalRecords += records[t];
+		successes += records[t] - invalid[t];
+		skipped += resyncs[t];
+	}
+
+	cout << "Number of records read: " << totalRecords << endl;
+	cout << "Number of valid records read: " << successes << endl;
+	if (skipped > 0)
+		cout << "Number of damaged blocks skipped: " << skipped << endl;
+	STATS_COUNT (statsRecordsRead, totalRecords);
+	STATS_COUNT (statsRecordsRejected, totalRecords - successes);
+
+	if (successes <= 0)
+		cout << "No records were read... Make sure you selected the correct file format and that the file isn't corrupt" << endl;
+
+	return true;
+}
+
+// Creates a buffer that unpacks the records of a file format the same way the buffer main reads it with does
+static PostalCodeBuffer* createDecoder (const string& fileFormat) {
+	if (fileFormat == "-old")
+		return new PostalCodeBuffer (1000);
+	else if (fileFormat == "-csv")
+		return new CsvPostalCodeBuffer (1000);
+	else if (fileFormat == "-block")
+		return new BlockPostalCodeBuffer (1000);
+
+	// Memory-mapped files hold the same records, and the batches are already in memory
+	return new NewPostalCodeBuffer (1000);
+}
+
+bool fillTablePipeline (map<string, vector<PostalCode> >& stateMap, const char* filename, PostalCodeBuffer* buffer, string fileFormat, int parsers) {
+	// The records of a batch after they're unpacked
+	struct ParsedBatch {
+		int records = 0; //!< The number of records in the batch
+		vector<PostalCode> postalCodes; //!< The valid records
+	};
+
+	// The stream reads through a large buffer, so the batches are filled from a few big reads instead of many small ones
+	vector<char> streamBuffer (pipelineReadSize);
+	ifstream infile;
+	infile.rdbuf ()->pubsetbuf (streamBuffer.data (), streamBuffer.size ());
+	infile.open (filename, ios::binary);
+	if (!infile.is_open ()) {
+		cerr << "Error: could not open input file" << endl;
+		return false;
+	}
+
+	// Skip past the header in the file
+	if (!skipHeader (buffer, infile))
+		return false;
+
+	// Each parser has its own buffer, which learns the field encoding from the header the same way
+	vector<unique_ptr<PostalCodeBuffer> > decoders;
+	for (int p = 0; p < parsers; ++p) {
+		ifstream header (filename, ios::binary);
+
+		decoders.emplace_back (createDecoder (fileFormat));
+		decoders[p]->readHeader (header, "", "");
+	}
+
+	// Batch i goes to parser i % parsers and comes back the same way, so the batches are stored in file order
+	// without sorting them. Every queue has one thread on each end. Used batches go back to the reader to be refilled
+	vector<unique_ptr<RingBuffer<PostalCodeBatch> > > toParser, toReader;
+	vector<unique_ptr<RingBuffer<ParsedBatch> > > toAggregator;
+	for (int p = 0; p < parsers; ++p) {
+		toParser.emplace_back (new RingBuffer<PostalCodeBatch> (pipelineDepth));
+		toReader.emplace_back (new RingBuffer<PostalCodeBatch> (pipelineDepth));
+		toAggregator.emplace_back (new RingBuffer<ParsedBatch> (pipelineDepth));
+	}
+
+	thread reader ([&] () {
+		// A second descriptor for the same file, used only for the readahead hints
+		int fd = ::open (filename, O_RDONLY);
+		long long hinted = 0; // The end of the part of the file the operating system was asked to read
+
+		for (long long i = 0; ; ++i) {
+			PostalCodeBatch batch;
+			toReader[i % parsers]->tryPop (batch);
+
+			// Asks for the next part of the file before the stream gets there, once the reader is halfway through the last part
+			long long position = infile.tellg ();
+			if (fd != -1 and position >= 0 and position + pipelineReadahead / 2 >= hinted) {
+				posix_fadvise (fd, position, pipelineReadahead, POSIX_FADV_WILLNEED);
+				hinted = position + pipelineReadahead;
+			}
+
+			if (readBatchTimed (buffer, infile, batch) <= 0)
+				break;
+
+			// Waits while the parser is pipelineDepth batches behind
+			toParser[i % parsers]->push (batch);
+		}
+
+		for (int p = 0; p < parsers; ++p)
+			toParser[p]->close ();
+		if (fd != -1)
+			::close (fd);
+	});
+
+	// Each parser interns into its own pool. The aggregator moves the strings to the global pool as it adds the postal codes
+	vector<unique_ptr<StringPool> > pools;
+	vector<vector<unsigned int> > ids (parsers);
+	for (int p = 0; p < parsers; ++p)
+		pools.push_back (PostalCode::createPool ());
+
+	vector<thread> workers;
+	for (int p = 0; p < parsers; ++p) {
+		workers.push_back (thread ([&, p] () {
+			StringPool::setCurrent (pools[p].get ());
+			PostalCodeBatch batch;
+
+			while (toParser[p]->pop (batch)) {
+				ParsedBatch parsed;
+
+				parsed.records = batch.size ();
+				unpackBatch (batch, decoders[p].get (), parsed.postalCodes);
+
+				// The postal codes don't point into the batch, so it can be refilled. It's dropped if the reader has enough
+				toReader[p]->tryPush (batch);
+				toAggregator[p]->push (parsed);
+			}
+
+			toAggregator[p]->close ();
+		}));
+	}
+
+	int records = 0;
+	int successes = 0;
+	ParsedBatch parsed;
+
+	// The first queue that ends is the one the batch after the last would have gone to
+	for (long long i = 0; toAggregator[i % parsers]->pop (parsed); ++i) {
+		int valid = parsed.postalCodes.size ();
+		records += parsed.records;
+
+		for (int r = valid; r < parsed.records; ++r)
+			cout << "Invalid record: " << endl;
+
+		STATS_TIME (statsInsert);
+		StringPool::global ().merge (*pools[i % parsers], ids[i % parsers]);
+		for (size_t r = 0; r < parsed.postalCodes.size (); ++r) {
+			parsed.postalCodes[r].moveStrings (ids[i % parsers], StringPool::global ());
+			stateMap[string (parsed.postalCodes[r].getState ())].push_back (move (parsed.postalCodes[r]));
+		}
+
+		successes += valid;
+	}
+
+	reader.join ();
+	for (int p = 0; p < parsers; ++p)
+		workers[p].join ();
+
+	cout << "Number of records read: " << records << endl;
+	cout << "Number of valid records read: " << successes << endl;
+	displaySkipped (buffer);
+	STATS_COUNT (statsRecordsRead, records);
+	STATS_COUNT (statsRecordsRejected, records - successes);
+
+	if (successes <= 0)
+		cout << "No records were read... Make sure you selected the correct file format and that the file isn't corrupt" << endl;
+
+	return true;
+}
+
+vector<size_t> splitRecords (const char* data, size_t begin, size_t end, int parts, unsigned short version, bool binary) {
+	MappedPostalCodeBuffer buffer (data, begin, end);
+	buffer.setVersion (version);
+	buffer.setBinary (binary);
+	vector<size_t> bounds (1, begin);
+	size_t last = begin; // The end of the last readable record
+	long long recaddr;
+
+	// Walks the length indicators, starting a new range at the first record past each split point
+	while ((recaddr = buffer.next ()) != -1) {
+		if ((int)bounds.size () < parts and (size_t)recaddr >= begin + (end - begin) * bounds.size () / parts)
+			bounds.push_back (recaddr);
+
+		last = buffer.getRecord ().data () - data + buffer.getRecord ().size ();
+	}
+
+	// Ranges past the last record are empty
+	while ((int)bounds.size () <= parts)
+		bounds.push_back (last);
+	bounds[parts] = last;
+
+	return bounds;
+}
+
+vector<size_t> splitFixedRecords (size_t begin, size_t end, size_t recordSize, int parts) {
+	size_t count = (end - begin) / recordSize; // A partial record at the end can't be read
+	vector<size_t> bounds;
+
+	// Every range gets the same number of whole records, give or take one
+	for (int i = 0; i <= parts; ++i)
+		bounds.push_back (begin + count * i / parts * recordSize);
+
+	return bounds;
+}
+
+vector<size_t> splitCsvRecords (const char* data, size_t begin, size_t end, int parts) {
+	const size_t none = (size_t)-1;
+	vector<size_t> starts (parts + 1);
+	vector<int> quoteParity (parts, 0);
+	vector<size_t> firstBreak[2] = {vector<size_t> (parts, none), vector<size_t> (parts, none)};
+	vector<thread> scanners;
+
+	for (int i = 0; i <= parts; ++i)
+		starts[i] = begin + (end - begin) * i / parts;
+
+	// First pass: each part is scanned without knowing whether it starts inside a quoted field.
+	// "" inside a quoted field flips the state twice, so counting quotes is enough to track it.
+	// firstBreak[s][i] is the first line break in part i that ends a record if the part starts in state s (1 = inside quotes)
+	for (int i = 0; i < parts; ++i) {
+		scanners.push_back (thread ([&, i] () {
+			int parity = 0;
+
+			for (size_t pos = starts[i]; pos < starts[i + 1]; ++pos) {
+				if (data[pos] == '"')
+					parity ^= 1;
+				else if (data[pos] == '\n' and firstBreak[parity][i] == none)
+					firstBreak[parity][i] = pos;
+			}
+
+			quoteParity[i] = parity;
+		}));
+	}
+
+	for (size_t i = 0; i < scanners.size (); ++i)
+		scanners[i].join ();
+
+	// Second step: the real state at each split point follows from the state and quote parity of the part before it
+	vector<size_t> bounds (1, begin);
+	int state = 0; // The first record starts outside of quotes
+	for (int i = 1; i < parts; ++i) {
+		state ^= quoteParity[i - 1];
+
+		// A part with no record boundary is left empty and the record is read by the part before it
+		size_t found = firstBreak[state][i];
+		bounds.push_back (found == none ? bounds.back () : found + 1);
+	}
+	bounds.push_back (end);
+
+	return bounds;
+}
+
+void mergeTables (map<string, vector<PostalCode> >& stateMap, map<string, vector<PostalCode> >& part, const StringPool& pool) {
+	STATS_TIME (statsInsert);
+	vector<unsigned int> ids;
+
+	// Each distinct string is looked up once, and then the postal codes only need their IDs replaced
+	StringPool::global ().merge (pool, ids);
+	for (auto it = part.begin (); it != part.end (); ++it) {
+		for (size_t i = 0; i < it->second.size (); ++i)
+			it->second[i].moveStrings (ids, StringPool::global ());
+
+		vector<PostalCode>& postalCodes = stateMap[it->first];
+
+		if (postalCodes.empty ())
+			postalCodes.swap (it->second);
+		else
+			postalCodes.insert (postalCodes.end (), make_move_iterator (it->second.begin ()), make_move_iterator (it->second.end ()));
+	}
+
+	part.clear ();
+}
+
+void displayHeader () {
+	// Print the table header
+    cout << left << setw(12) << "State ID";
+	cout << left << setw(15) << "Easternmost";
+	cout << left << setw(15) << "Westernmost";
+	cout << left << setw(15) << "Northernmost";
+	cout << left << setw(15) << "Southernmost";
+	cout << endl;
+	
+	return;
+}
+
+void displayTable (const map<string, vector<PostalCode> >& stateMap) {
+	STATS_TIME (statsReport);
+	// Iterate over the stateMap and print the data for each state
+	// This will display the map in the correct order
+    for (auto it = stateMap.begin(); it != stateMap.end(); ++it) {
+        // Finds the farthest postal codes in one pass instead of sorting a copy of the vector
+        StateExtremes extremes;
+        for (size_t i = 0; i < it->second.size (); ++i)
+            extremes.update (it->second[i]);
+
+        displayRow (it->first, extremes);
+    }
+	
+	return;
+}
+
+void displayStringMemory (const map<string, vector<PostalCode> >& stateMap) {
+	size_t postalCodes = 0;
+	size_t separate = 0; // The bytes the strings would use if each postal code held its own copies
+
+	for (auto it = stateMap.begin (); it != stateMap.end (); ++it) {
+		for (size_t i = 0; i < it->second.size (); ++i) {
+			string_view fields[] = {it->second[i].getCity (), it->second[i].getState (), it->second[i].getCounty ()};
+
+			// Strings that don't fit in a string's own storage allocate their characters on the heap
+			for (int f = 0; f < 3; ++f) {
+				separate += sizeof (string);
+				if (fields[f].size () >= sizeof (string) - sizeof (size_t))
+					separate += fields[f].size () + 1;
+			}
+		}
+
+		postalCodes += it->second.size ();
+	}
+
+	StringPool& pool = StringPool::global ();
+	size_t interned = postalCodes * (3 * sizeof (unsigned int) + sizeof (StringPool*)) + pool.getMemoryUsed ();
+
+	cout << "Postal codes: " << postalCodes << endl;
+	cout << "Distinct strings: " << pool.size () << endl;
+	cout << "String memory as separate strings: " << separate << " bytes" << endl;
+	cout << "String memory as interned IDs: " << interned << " bytes" << endl;
+	if (separate > 0)
+		cout << "Saved: " << (long long)separate - (long long)interned << " bytes (" << fixed << setprecision (1) << 100.0 * ((double)separate - interned) / separate << "%)" << defaultfloat << endl;
+
+	return;
+}
+
+void displayExtremes (const map<string, StateExtremes>& extremesMap) {
+	STATS_TIME (statsReport);
+	for (auto it = extremesMap.begin(); it != extremesMap.end(); ++it)
+		displayRow (it->first, it->second);
+
+	return;
+}
+
+void displayColumns (const PostalCodeColumns& columns) {
+	STATS_TIME (statsReport);
+	const int32_t* zipCodes = columns.zipCodes ();
+	const double* lats = columns.lats ();
+	const double* lngs = columns.lngs ();
+
+	// States are numbered alphabetically, which is the order of the map used by displayTable
+	for (int s = 0; s < columns.stateCount (); ++s) {
+		int begin = columns.stateBegin (s);
+		StateExtremes extremes = findExtremes (zipCodes + begin, lats + begin, lngs + begin, columns.stateEnd (s) - begin);
+
+		displayRow (string (columns.getStateName (s)), extremes);
+	}
+
+	return;
+}
+
+void displayRow (const string& stateId, const StateExtremes& extremes) {
+	// Print the data for this state
+	cout << left << setw(12) << stateId;
+	cout << left << setw(15) << extremes.getEasternmost ();
+	cout << left << setw(15) << extremes.getWesternmost ();
+	cout << left << setw(15) << extremes.getNorthernmost ();
+	cout << left << setw(15) << extremes.getSouthernmost ();
+	cout << endl;
+
+	return;
+}
@@ -0,0 +1,181 @@
+#ifndef StateTable_
+#define StateTable_
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <thread>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
+#include "PostalCodeBuffer.h"
+#include "PostalCodeBatch.h"
+#include "MappedPostalCodeBuffer.h"
+#include "BlockPostalCodeBuffer.h"
+#include "CsvPostalCodeBuffer.h"
+#include "PostalCode.h"
+#include "FieldParser.h"
+#include "StateExtremes.h"
+#include "PostalCodeColumns.h"
+#include "ExtremesKernel.h"
+#include "IngestStats.h"
+#include "RingBuffer.h"
+
+using namespace std;
+
+// Functions for building and displaying the table of postal codes for each state
+// The table maps each state ID to the postal codes within that state, in the order they were read
+
+const int batchSize = 4096; //!< The number of records read at a time
+const int pipelineDepth = 4; //!< The number of batches waiting between each pair of fillTablePipeline stages
+const int pipelineReadSize = 1 << 20; //!< The size of each read fillTablePipeline asks the operating system for
+const long long pipelineReadahead = 8 << 20; //!< How far ahead of the reader fillTablePipeline asks the operating system to read
+
+/** Unpacks postal code information from a buffer into an object
+ * @param file: the file to read data from
+ * @param pc: The PostalCode object that will be filled
+ * @param buff: The buffer containing the postal code data
+ * @post: the PostalCode object will be filled with data. Text numbers are parsed without copying or using the locale, binary numbers aren't parsed at all
+ * @return: returns -1 if an error occured */
+int unpackPostalCode (PostalCode& pc, PostalCodeBuffer* buff);
+
+/** Unpacks every record of a batch into postal code objects
+ * @param batch: the batch of records, read with buff's readBatch
+ * @param buff: the buffer that reads the records
+ * @param postalCodes: set to the valid records, in batch order
+ * @post: new DAT buffers unpack without virtual calls for each field
+ * @return: returns the number of valid records */
+int unpackBatch (const PostalCodeBatch& batch, PostalCodeBuffer* buff, vector<PostalCode>& postalCodes);
+
+/** Unpacks every record of a batch into columns
+ * @param batch: the batch of records, read with buff's readBatch
+ * @param buff: the buffer that reads the records
+ * @param columns: the columns the valid records will be added to
+ * @post: the strings are copied straight from the batch into the columns, without PostalCode objects
+ * @return: returns the number of valid records */
+int unpackBatch (const PostalCodeBatch& batch, PostalCodeBuffer* buff, PostalCodeColumns& columns);
+
+/** Packs a postal code object into a buffer, using the buffer's field encoding
+ * @param pc: The PostalCode object to pack
+ * @param buff: The buffer the postal code data will be packed into
+ * @post: the buffer will be cleared and filled with the postal code's fields
+ * @return: returns the length of the record or -1 if it doesn't fit in the buffer */
+int packPostalCode (const PostalCode& pc, PostalCodeBuffer* buff);
+
+/** Fills a map with postal code data for each state
+ * @param stateMap: the map that will be filled with postal code information
+ * @param filename: the name of the file containing postal code data
+ * @param buff: the buffer that will be used to extract the data
+ * @param fileFormat: the format of the postal code file (new or old)
+ * @post: the stateMap will be filled with postal code data for each state
+ * @return: returns true if the operation was successful, otherwise false */
+bool fillTable (map<string, vector<PostalCode> >& stateMap, const char* filename, PostalCodeBuffer* buff, string fileFormat);
+
+/** Finds the farthest postal codes of each state while reading a file, without storing the postal codes
+ * @param extremesMap: the map that will be filled with the farthest postal codes of each state
+ * @param filename: the name of the file containing postal code data
+ * @param buff: the buffer that will be used to extract the data
+ * @post: the extremesMap will hold the same farthest postal codes as displayTable would find in the table filled by fillTable
+ * @return: returns true if the operation was successful, otherwise false */
+bool fillExtremes (map<string, StateExtremes>& extremesMap, const char* filename, PostalCodeBuffer* buff);
+
+/** Fills a columnar store with postal code data
+ * @param columns: the store that will be filled with postal code information
+ * @param filename: the name of the file containing postal code data
+ * @param buff: the buffer that will be used to extract the data
+ * @post: the store will hold every valid record, grouped by state
+ * @return: returns true if the operation was successful, otherwise false */
+bool fillColumns (PostalCodeColumns& columns, const char* filename, PostalCodeBuffer* buff);
+
+/** Fills a map with postal code data for each state by reading parts of a file on several threads
+ * @param stateMap: the map that will be filled with postal code information
+ * @param filename: the name of the file containing postal code data
+ * @param threads: the number of threads that will read the file
+ * @param fileFormat: the format of the postal code file. '-old' and '-csv' files are read as CSV, anything else as a new DAT file
+ * @post: the stateMap will be filled with the same data, in the same order, as fillTable would fill it
+ * @return: returns true if the operation was successful, otherwise false */
+bool fillTableParallel (map<string, vector<PostalCode> >& stateMap, const char* filename, int threads, string fileFormat);
+
+/** Fills a map with postal code data for each state, reading, unpacking and storing the records on different threads
+ * @param stateMap: the map that will be filled with postal code information
+ * @param filename: the name of the file containing postal code data
+ * @param buff: the buffer that will be used to read the records
+ * @param fileFormat: the format of the postal code file, which decides how the parser threads unpack the records
+ * @param parsers: the number of threads that unpack the records
+ * @post: a reader thread reads batches with large reads, ahead of which the operating system is asked to read the file.
+ *        The batches are unpacked on the parser threads in turn and stored in file order on the calling thread.
+ *        The stateMap will be filled with the same data, in the same order, as fillTable would fill it
+ * @return: returns true if the operation was successful, otherwise false */
+bool fillTablePipeline (map<string, vector<PostalCode> >& stateMap, const char* filename, PostalCodeBuffer* buff, string fileFormat, int parsers);
+
+/** Splits the records of a mapped DAT file into ranges with about the same number of bytes
+ * @param data: the first byte of the mapped file
+ * @param begin: the position of the first record
+ * @param end: the size of the file
+ * @param parts: the number of ranges to create
+ * @param version: the version of the file, which decides how the length indicators are stored
+ * @param binary: true if the file uses binary fields, which decides how records are checked when scanning past damage
+ * @post: only the length indicators are read, so the fields aren't checked unless a length indicator is damaged
+ * @return: returns parts + 1 positions. Range i starts at position i and ends at position i + 1. The last position is the end of the last readable record */
+vector<size_t> splitRecords (const char* data, size_t begin, size_t end, int parts, unsigned short version = 1, bool binary = false);
+
+/** Splits the fixed-length records of a file into ranges without reading them
+ * @param begin: the position of the first record
+ * @param end: the end of the file
+ * @param recordSize: the size of every record
+ * @param parts: the number of ranges to create
+ * @return: returns parts + 1 positions. Range i starts at position i and ends at position i + 1. The last position is the end of the last whole record */
+vector<size_t> splitFixedRecords (size_t begin, size_t end, size_t recordSize, int parts);
+
+/** Splits the records of a mapped CSV file into ranges with about the same number of bytes
+ * @param data: the first byte of the mapped file
+ * @param begin: the position of the first record
+ * @param end: the size of the file
+ * @param parts: the number of ranges to create
+ * @post: the file is scanned on parts threads. Each thread works out where the first record in its part would start
+ *        both inside and outside of a quoted field. The real quote state at each split point is then chained from the start of the file
+ * @return: returns parts + 1 positions. Range i starts at position i and ends at position i + 1 */
+vector<size_t> splitCsvRecords (const char* data, size_t begin, size_t end, int parts);
+
+/** Moves the postal codes from one table to the end of another
+ * @param stateMap: the table that will receive the postal codes
+ * @param part: the table whose postal codes will be moved
+ * @param pool: the pool part's postal codes were filled from, whose strings are merged into the global pool
+ * @post: each state in stateMap will have the postal codes from part added after its own, with their strings in the global pool, and part will be empty */
+void mergeTables (map<string, vector<PostalCode> >& stateMap, map<string, vector<PostalCode> >& part, const StringPool& pool);
+
+/** Shows the table header
+ * @post: prints the table header to the console */
+void displayHeader ();
+
+/** Shows the postal code table data
+ * @param stateMap: contains the postal code data for each state
+ * @post: prints the farthest zip codes for each state in each compass directon */
+void displayTable (const map<string, vector<PostalCode> >& stateMap);
+
+/** Shows how much memory interning saved on the postal codes' strings
+ * @param stateMap: contains the postal code data for each state
+ * @post: prints the estimated size of the strings if each postal code held its own copies, next to the size of the IDs and the string pool */
+void displayStringMemory (const map<string, vector<PostalCode> >& stateMap);
+
+/** Shows the farthest postal codes found by fillExtremes
+ * @param extremesMap: contains the farthest postal codes of each state
+ * @post: prints the same table as displayTable */
+void displayExtremes (const map<string, StateExtremes>& extremesMap);
+
+/** Shows the postal code table data from a columnar store
+ * @param columns: contains the postal code data, grouped by state
+ * @post: prints the same table as displayTable, only reading the zip code and coordinate columns with findExtremes */
+void displayColumns (const PostalCodeColumns& columns);
+
+/** Shows a single row of the table
+ * @param stateId: the state shown in the row
+ * @param extremes: the farthest postal codes of the state
+ * @post: prints the farthest zip codes of the state in each compass direction */
+void displayRow (const string& stateId, const StateExtremes& extremes);
+
+#include "StateTable.cpp"
+#endif
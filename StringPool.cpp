@@ -0,0 +1,112 @@
+#include "StringPool.h"
+
+thread_local StringPool* StringPool::currentPool = NULL;
+
+	// CONSTRUCTORS
+StringPool::StringPool (size_t bs) : blockSize (bs), blockUsed (bs), blockBytes (0), chunks (new atomic<string_view*>[maxChunks] ()), chunkCount (0), count (0) {}
+
+StringPool::~StringPool () {
+	for (size_t c = 0; c < chunkCount; ++c)
+		delete[] chunks[c].load (memory_order_relaxed);
+}
+
+
+	// MODIFICATION METHODS
+unsigned int StringPool::intern (string_view s) {
+	// Most strings are already in the pool, so they're found without blocking other threads
+	{
+		shared_lock<shared_mutex> reading (lock);
+		auto it = lookup.find (s);
+
+		if (it != lookup.end ())
+			return it->second;
+	}
+
+	unique_lock<shared_mutex> writing (lock);
+
+	// Another thread may have added the string while the lock was free
+	auto it = lookup.find (s);
+	if (it != lookup.end ())
+		return it->second;
+
+	unsigned int id = count.load (memory_order_relaxed);
+
+	// Starts a new chunk of views when the last one is full
+	if ((id >> chunkBits) >= chunkCount) {
+		if (chunkCount >= maxChunks)
+			throw length_error ("StringPool is full");
+
+		chunks[chunkCount].store (new string_view[(size_t)1 << chunkBits], memory_order_release);
+		chunkCount += 1;
+	}
+
+	string_view stored = store (s);
+
+	// The view is stored before the count is, so a thread that sees the new count also sees the view
+	chunks[id >> chunkBits].load (memory_order_relaxed)[id & ((1 << chunkBits) - 1)] = stored;
+	lookup.emplace (stored, id);
+	count.store (id + 1, memory_order_release);
+
+	return id;
+}
+
+void StringPool::merge (const StringPool& other, vector<unsigned int>& ids) {
+	// The other pool's strings never move, so the ones already there can be read while its thread adds more
+	for (size_t id = ids.size (), count = other.size (); id < count; ++id)
+		ids.push_back (intern (other.get (id)));
+}
+
+
+	// CONSTANT METHODS
+string_view StringPool::get (unsigned int id) const {
+	return chunks[id >> chunkBits].load (memory_order_acquire)[id & ((1 << chunkBits) - 1)];
+}
+
+size_t StringPool::size () const {
+	return count.load (memory_order_acquire);
+}
+
+size_t StringPool::getMemoryUsed () const {
+	shared_lock<shared_mutex> reading (lock);
+
+	// Each lookup entry is a node holding the view, the ID and a hash chain pointer, plus a bucket pointer
+	size_t lookupBytes = lookup.size () * (sizeof (string_view) + sizeof (unsigned int) + 2 * sizeof (void*)) + lookup.bucket_count () * sizeof (void*);
+
+	return blockBytes + maxChunks * sizeof (chunks[0]) + chunkCount * (sizeof (string_view) << chunkBits) + lookupBytes;
+}
+
+StringPool& StringPool::global () {
+	static StringPool pool;
+
+	return pool;
+}
+
+StringPool& StringPool::current () {
+	return currentPool != NULL ? *currentPool : global ();
+}
+
+StringPool* StringPool::setCurrent (StringPool* pool) {
+	StringPool* previous = currentPool;
+	currentPool = pool;
+
+	return previous;
+}
+
+
+	// HELPER FUNCTIONS
+string_view StringPool::store (string_view s) {
+	// Strings longer than a block get a block of their own
+	if (blockUsed + s.size () + 1 > blockSize) {
+		size_t size = max (blockSize, s.size () + 1);
+		blocks.push_back (unique_ptr<char[]> (new char[size]));
+		blockUsed = 0;
+		blockBytes += size;
+	}
+
+	char* copy = blocks.back ().get () + blockUsed;
+	memcpy (copy, s.data (), s.size ());
+	copy[s.size ()] = 0;
+	blockUsed += s.size () + 1;
+
+	return string_view (copy, s.size ());
+}
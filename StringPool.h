@@ -0,0 +1,111 @@
+#ifndef StringPool_
+#define StringPool_
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+
+using namespace std;
+
+// Stores each distinct string once and hands out a small ID for it
+// The characters are copied into large blocks that are never moved or freed, so a string's view stays valid for the life of the pool
+// and storing a string doesn't need its own heap allocation. Each string is followed by a 0, so its view can be used as a C string
+// The views are kept in chunks that never move either, and the table of chunks is allocated in full up front, so get doesn't need a lock
+// even while another thread adds strings. A view is stored before the count that makes its ID valid is published
+// intern takes a shared lock to look a string up and only takes the lock for itself when it has to add one, so several threads can fill the same pool
+// Threads that fill many postal codes at once give each thread a pool of its own with setCurrent instead, so they never wait on each other,
+// and the strings are added to the global pool with merge when the postal codes are
+
+/** Used to share the strings of many postal codes
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+class StringPool {
+	public:
+			// CONSTRUCTORS
+		/** Constructor with default parameters
+		 * @param bs: the size of each block of characters
+		 * @post: creates an empty pool */
+		StringPool (size_t bs = 1 << 16);
+
+		/** Destructor
+		 * @post: frees the chunks of views. The blocks free themselves */
+		~StringPool ();
+
+		StringPool (const StringPool&) = delete;
+		StringPool& operator = (const StringPool&) = delete;
+
+			// MODIFICATION METHODS
+		/** Finds a string in the pool, adding it if it isn't there yet
+		 * @param s: the string to find
+		 * @post: the string is stored in the pool
+		 * @return: returns the string's ID, which is the same every time the string is interned */
+		unsigned int intern (string_view s);
+
+		/** Adds the strings of another pool that haven't been merged yet
+		 * @param other: the pool whose strings are added
+		 * @param ids: the ID in this pool of each string of other, by its ID in other
+		 * @post: the strings added to other since the last merge are interned and their IDs are added to the end of ids */
+		void merge (const StringPool& other, vector<unsigned int>& ids);
+
+			// CONSTANT METHODS
+		/** Gets an interned string
+		 * @param id: the ID returned by intern
+		 * @pre: the ID was returned by intern, or is below a size the calling thread has seen
+		 * @return: returns the string's characters within the pool */
+		string_view get (unsigned int id) const;
+
+		/** Gets the number of distinct strings
+		 * @return: returns the number of strings in the pool */
+		size_t size () const;
+
+		/** Gets the memory used by the pool
+		 * @return: returns the number of bytes used by the blocks, the views and an estimate of the lookup table */
+		size_t getMemoryUsed () const;
+
+		/** Gets the pool shared by every postal code
+		 * @return: returns the pool */
+		static StringPool& global ();
+
+		/** Gets the pool the calling thread's postal codes use
+		 * @return: returns the pool set by setCurrent, or the global pool if there isn't one */
+		static StringPool& current ();
+
+		/** Sets the pool the calling thread's postal codes use
+		 * @param pool: the pool, or NULL for the global pool
+		 * @post: other threads keep their own pools
+		 * @return: returns the pool that was set before, or NULL if it was the global pool */
+		static StringPool* setCurrent (StringPool* pool);
+
+	private:
+		/** Copies a string into the current block, starting a new block if it doesn't fit
+		 * @param s: the string to copy
+		 * @pre: the caller holds the lock for itself
+		 * @return: returns the copy within the block */
+		string_view store (string_view s);
+
+		static const size_t chunkBits = 12; //!< Each chunk holds 2^chunkBits views
+		static const size_t maxChunks = 1 << 12; //!< The number of chunks, which is enough for 16 million strings
+
+		size_t blockSize; //!< The size of each block of characters
+		vector<unique_ptr<char[]> > blocks; //!< The blocks holding the characters of every string
+		size_t blockUsed; //!< The number of characters used in the last block
+		size_t blockBytes; //!< The total size of the blocks
+		unique_ptr<atomic<string_view*>[]> chunks; //!< The view of each string, by ID, in chunks that are allocated as they're needed
+		size_t chunkCount; //!< The number of chunks allocated
+		atomic<size_t> count; //!< The number of strings. Each string's view is stored before the count includes it
+		unordered_map<string_view, unsigned int> lookup; //!< Finds the ID of a string
+		mutable shared_mutex lock; //!< Lets many threads look up strings while only one adds them
+
+		static thread_local StringPool* currentPool; //!< The pool set by setCurrent on each thread
+};
+
+#include "StringPool.cpp"
+#endif
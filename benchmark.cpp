@@ -0,0 +1,814 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include "StateTable.h"
+#include "CsvPostalCodeBuffer.h"
+#include "NewPostalCodeBuffer.h"
+#include "MappedPostalCodeBuffer.h"
+#include "BlockPostalCodeBuffer.h"
+#include "ChecksumDirectory.h"
+#include "PostalCodeHeader.h"
+#include "PostalCode.h"
+
+using namespace std;
+
+// Measures each stage of reading and reporting a postal code file and writes the results as JSON
+// The stages are run on the files in 'Test Files' and on synthetic files of any number of records, which are made by
+// repeating the records of a CSV file and written as both a CSV file and a version 2 DAT file with checksums
+// Every stage is run several times to measure its throughput, then once more with a clock read around a sample of its
+// operations to measure their latencies, so the timed runs don't pay for the extra clock reads
+// Each stage only times its own work. Reading the batches that unpacking works on, for example, isn't timed
+//	readHeader - one readHeader call on an open file
+//	read - one read call, from the first record to the end of the file, for each buffer that reads the file
+//	unpackPostalCode - unpacking one record of a batch into a PostalCode object
+//	fillTable insert - adding one PostalCode object to the state map, the way fillTable does
+//	displayTable - one displayTable call on the filled state map, written to a stream that discards the output
+
+typedef chrono::steady_clock Clock;
+
+/** The measurements of one stage on one file
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+struct StageResult {
+	string stage; //!< The name of the stage
+	string buffer; //!< The buffer class that ran the stage
+	long long operations = 0; //!< The number of operations in each run
+	long long records = 0; //!< The number of records handled in each run
+	long long bytes = 0; //!< The number of bytes of records handled in each run
+	vector<double> seconds; //!< The time of each timed run
+	vector<double> latencies; //!< The times of the sampled operations, in nanoseconds
+};
+
+/** The measurements of every stage on one file
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+struct FileResult {
+	string filename; //!< The name of the file
+	string format; //!< "csv", "dat" or "block"
+	long long records = 0; //!< The number of records in the file
+	long long synthetic = 0; //!< The number of records the file was generated with, or 0 for existing files
+	long long size = 0; //!< The size of the file
+	string error; //!< Why the file couldn't be measured, or "" if it was
+	vector<StageResult> stages; //!< The results of each stage
+};
+
+/** Discards everything written to it, so displayTable can be timed without a terminal */
+class NullBuffer : public streambuf {
+	protected:
+		int overflow (int c) { return c; }
+		streamsize xsputn (const char*, streamsize n) { return n; }
+};
+
+/** Runs an operation, timing it if it was sampled
+ * @param sample: true to time the operation
+ * @param latencies: the operation's time is added to it if it was sampled
+ * @param operation: the operation to run
+ * @return: returns the operation's result */
+template <class Operation>
+auto timed (bool sample, vector<double>& latencies, Operation operation) -> decltype (operation ());
+
+/** Measures every stage on a file
+ * @param filename: the file to measure
+ * @param runs: the number of timed runs of each stage
+ * @param samples: the most operations of each stage whose latencies are sampled
+ * @param headerCalls: the number of readHeader calls in each run
+ * @param displayCalls: the number of displayTable calls in each run
+ * @return: returns the results, with an error if the file couldn't be read */
+FileResult measureFile (const string& filename, int runs, int samples, int headerCalls, int displayCalls);
+
+/** Measures readHeader
+ * @param buff: the buffer to measure
+ * @param name: the name of the buffer's class
+ * @param filename: the file to read
+ * @param indexFilename: the index file named in the file's header
+ * @param indexSchema: the index schema in the file's header
+ * @param runs: the number of timed runs
+ * @param samples: the most latencies to sample
+ * @param calls: the number of calls in each run
+ * @return: returns the results */
+StageResult measureHeader (PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples, int calls);
+
+/** Measures read from the first record to the end of the file
+ * @param buff: the buffer to measure
+ * @param name: the name of the buffer's class
+ * @param filename: the file to read
+ * @param indexFilename: the index file named in the file's header
+ * @param indexSchema: the index schema in the file's header
+ * @param runs: the number of timed runs
+ * @param samples: the most latencies to sample
+ * @return: returns the results */
+StageResult measureRead (PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples);
+
+/** Measures unpackPostalCode on every record of the file
+ * @param buff: the buffer that reads the records
+ * @param name: the name of the buffer's class
+ * @param filename: the file to read
+ * @param indexFilename: the index file named in the file's header
+ * @param indexSchema: the index schema in the file's header
+ * @param runs: the number of timed runs
+ * @param samples: the most latencies to sample
+ * @return: returns the results */
+StageResult measureUnpack (PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples);
+
+/** Measures adding every record of the file to a state map
+ * @param stateMap: filled with the file's postal codes by the last run
+ * @param buff: the buffer that reads the records
+ * @param name: the name of the buffer's class
+ * @param filename: the file to read
+ * @param indexFilename: the index file named in the file's header
+ * @param indexSchema: the index schema in the file's header
+ * @param runs: the number of timed runs
+ * @param samples: the most latencies to sample
+ * @return: returns the results */
+StageResult measureInsert (map<string, vector<PostalCode> >& stateMap, PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples);
+
+/** Measures displayTable
+ * @param stateMap: the state map to display
+ * @param bytes: the number of bytes of records the postal codes in the map were read from
+ * @param runs: the number of timed runs
+ * @param samples: the most latencies to sample
+ * @param calls: the number of calls in each run
+ * @return: returns the results */
+StageResult measureDisplay (const map<string, vector<PostalCode> >& stateMap, long long bytes, int runs, int samples, int calls);
+
+/** Makes a CSV file and a DAT file by repeating the valid records of a CSV file
+ * @param sourceFilename: the CSV file whose records are repeated
+ * @param records: the number of records to write
+ * @param csvFilename: the CSV file to write. Its records are copied from the source byte for byte
+ * @param datFilename: the version 2 DAT file to write, with text fields and a checksum directory like the converter writes
+ * @return: returns true if both files were written, otherwise false */
+bool generateFiles (const string& sourceFilename, long long records, const string& csvFilename, const string& datFilename);
+
+/** Writes the results as JSON
+ * @param out: the stream to write to
+ * @param files: the results of every file
+ * @param runs: the number of timed runs of each stage
+ * @param samples: the most latencies sampled for each stage */
+void writeJson (ostream& out, const vector<FileResult>& files, int runs, int samples);
+
+/** Writes a short table of the results
+ * @param out: the stream to write to
+ * @param files: the results of every file */
+void displaySummary (ostream& out, const vector<FileResult>& files);
+
+/** Quotes a string for JSON
+ * @param text: the string to quote
+ * @return: returns the string in quotes, with quotes, backslashes and control characters escaped */
+string jsonString (const string& text);
+
+/** Finds a percentile of sorted latencies
+ * @param sorted: the latencies, in increasing order
+ * @param fraction: the percentile as a fraction, like 0.99
+ * @return: returns the smallest latency that at least that fraction of the latencies are less than or equal to, or 0 if there are none */
+double percentile (const vector<double>& sorted, double fraction);
+
+/** Finds the median of the run times
+ * @param seconds: the time of each run
+ * @return: returns the median, or 0 if there were no runs */
+double median (vector<double> seconds);
+
+// argv[1] = JSON output file, argv[2...] = options
+int main (int argc, char* argv[]) {
+	cout << endl; // CentOS formatting
+
+	// Checks if the number of arguments is correct
+	if (argc < 2) {
+		cout << "Enter './[program name] [JSON file name] [options]'" << endl;
+		cout << "For example, './benchmark results.json --records 1000000 --records 10000000'" << endl;
+		cout << "The JSON file name can be '-' to write the results to the standard output" << endl;
+		cout << "Options:" << endl;
+		cout << "  --file [file name]         Measures a CSV, DAT or compressed DAT file. Defaults to the CSV and DAT files in 'Test Files'" << endl;
+		cout << "  --records [record count]   Also measures a synthetic CSV file and DAT file with this many records, like 1000000 to 50000000" << endl;
+		cout << "  --source [CSV file name]   The CSV file whose records are repeated in the synthetic files. Defaults to 'Test Files/postal_codes.csv'" << endl;
+		cout << "  --work-dir [directory]     The directory the synthetic files are written to. Defaults to the current directory" << endl;
+		cout << "  --keep                     Keeps the synthetic files instead of deleting them afterwards" << endl;
+		cout << "  --runs [run count]         The number of timed runs of each stage. Defaults to 3" << endl;
+		cout << "  --samples [count]          The most latencies sampled for each stage. Defaults to 100000" << endl;
+		cout << "  --header-calls [count]     The number of readHeader calls in each run. Defaults to 1000" << endl;
+		cout << "  --display-calls [count]    The number of displayTable calls in each run. Defaults to 10" << endl;
+		return 1;
+	}
+
+	// Places the CLI arguments into variables
+	string outputFilename = argv[1];
+	vector<string> filenames;
+	vector<long long> syntheticSizes;
+	string sourceFilename = "Test Files/postal_codes.csv";
+	string workDir = ".";
+	bool keep = false;
+	int runs = 3;
+	int samples = 100000;
+	int headerCalls = 1000;
+	int displayCalls = 10;
+
+	for (int i = 2; i < argc; ++i) {
+		string option = argv[i];
+
+		if (option == "--file" and i + 1 < argc)
+			filenames.push_back (argv[++i]);
+		else if (option == "--records" and i + 1 < argc and atoll (argv[i + 1]) > 0)
+			syntheticSizes.push_back (atoll (argv[++i]));
+		else if (option == "--source" and i + 1 < argc)
+			sourceFilename = argv[++i];
+		else if (option == "--work-dir" and i + 1 < argc)
+			workDir = argv[++i];
+		else if (option == "--keep")
+			keep = true;
+		else if (option == "--runs" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			runs = atoi (argv[++i]);
+		else if (option == "--samples" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			samples = atoi (argv[++i]);
+		else if (option == "--header-calls" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			headerCalls = atoi (argv[++i]);
+		else if (option == "--display-calls" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			displayCalls = atoi (argv[++i]);
+		else {
+			cerr << "Invalid option '" << option << "'" << endl;
+			return 1;
+		}
+	}
+
+	if (filenames.empty ()) {
+		filenames.push_back ("Test Files/postal_codes.csv");
+		filenames.push_back ("Test Files/postal_codes_random.csv");
+		filenames.push_back ("Test Files/new_postal_codes.dat");
+		filenames.push_back ("Test Files/new_postal_codes_random.dat");
+	}
+
+	vector<FileResult> results;
+	for (size_t i = 0; i < filenames.size (); ++i) {
+		cerr << "Measuring " << filenames[i] << endl;
+		results.push_back (measureFile (filenames[i], runs, samples, headerCalls, displayCalls));
+	}
+
+	// Each synthetic size is written, measured and deleted before the next one, so only one size is on disk at a time
+	for (size_t i = 0; i < syntheticSizes.size (); ++i) {
+		string name = workDir + "/synthetic_" + to_string (syntheticSizes[i]);
+		string csvFilename = name + ".csv";
+		string datFilename = name + ".dat";
+
+		cerr << "Generating " << syntheticSizes[i] << " records" << endl;
+		if (generateFiles (sourceFilename, syntheticSizes[i], csvFilename, datFilename) == false) {
+			FileResult failed;
+			failed.filename = name;
+			failed.synthetic = syntheticSizes[i];
+			failed.error = "could not generate the synthetic files from '" + sourceFilename + "'";
+			results.push_back (failed);
+			continue;
+		}
+
+		cerr << "Measuring " << csvFilename << endl;
+		results.push_back (measureFile (csvFilename, runs, samples, headerCalls, displayCalls));
+		results.back ().synthetic = syntheticSizes[i];
+		cerr << "Measuring " << datFilename << endl;
+		results.push_back (measureFile (datFilename, runs, samples, headerCalls, displayCalls));
+		results.back ().synthetic = syntheticSizes[i];
+
+		if (keep == false) {
+			remove (csvFilename.c_str ());
+			remove (datFilename.c_str ());
+		}
+	}
+
+	if (outputFilename == "-")
+		writeJson (cout, results, runs, samples);
+	else {
+		ofstream outfile (outputFilename.c_str (), ios::trunc);
+		writeJson (outfile, results, runs, samples);
+		if (outfile.good () == false) {
+			cerr << "Error: could not write the output file" << endl;
+			return 1;
+		}
+
+		displaySummary (cout, results);
+		cout << endl << "Results written to " << outputFilename << endl;
+	}
+
+	cout << endl << endl; // CentOS formatting
+
+	return 0;
+}
+
+template <class Operation>
+auto timed (bool sample, vector<double>& latencies, Operation operation) -> decltype (operation ()) {
+	if (sample == false)
+		return operation ();
+
+	Clock::time_point start = Clock::now ();
+	auto result = operation ();
+	latencies.push_back (chrono::duration<double, nano> (Clock::now () - start).count ());
+
+	return result;
+}
+
+FileResult measureFile (const string& filename, int runs, int samples, int headerCalls, int displayCalls) {
+	FileResult result;
+	result.filename = filename;
+
+	ifstream infile (filename.c_str (), ios::binary);
+	if (!infile.is_open ()) {
+		result.error = "could not open the file";
+		return result;
+	}
+	infile.seekg (0, ios::end);
+	result.size = infile.tellg ();
+	infile.seekg (0, ios::beg);
+
+	// CSV files are read with the original buffer and the CSV buffer, DAT files with the stream and mapped buffers
+	vector<PostalCodeBuffer*> buffers;
+	vector<string> names;
+	string indexFilename, indexSchema;
+	bool csv = filename.size () >= 4 and filename.compare (filename.size () - 4, 4, ".csv") == 0;
+	if (csv) {
+		result.format = "csv";
+		buffers.push_back (new PostalCodeBuffer (1000));
+		names.push_back ("PostalCodeBuffer");
+		buffers.push_back (new CsvPostalCodeBuffer (1000));
+		names.push_back ("CsvPostalCodeBuffer");
+	}
+	else {
+		// DAT buffers only accept the header if they're given its index file and schema
+		PostalCodeHeader header;
+		if (header.readHeader (infile) == -1 or header.isSupported () == false) {
+			result.error = "the file doesn't have a valid DAT header";
+			return result;
+		}
+		indexFilename = header.getIndexFilename ();
+		indexSchema = header.getIndexSchema ();
+
+		if (header.getStructure () == "BLOCK/BINARY") {
+			result.format = "block";
+			buffers.push_back (new BlockPostalCodeBuffer (1000));
+			names.push_back ("BlockPostalCodeBuffer");
+		}
+		else {
+			result.format = "dat";
+			buffers.push_back (new NewPostalCodeBuffer (1000));
+			names.push_back ("NewPostalCodeBuffer");
+			buffers.push_back (new MappedPostalCodeBuffer (filename));
+			names.push_back ("MappedPostalCodeBuffer");
+		}
+	}
+	infile.close ();
+
+	// The first buffer is used for the stages that come after reading
+	for (size_t i = 0; i < buffers.size (); ++i)
+		result.stages.push_back (measureHeader (buffers[i], names[i], filename, indexFilename, indexSchema, runs, samples, headerCalls));
+
+	// The other stages aren't measured on files whose header or records can't be read, since they would only time the failure
+	if (result.stages.back ().bytes == 0)
+		result.error = "the header couldn't be read";
+	else {
+		for (size_t i = 0; i < buffers.size (); ++i)
+			result.stages.push_back (measureRead (buffers[i], names[i], filename, indexFilename, indexSchema, runs, samples));
+		result.records = result.stages.back ().records;
+	}
+
+	if (result.error == "" and result.records == 0)
+		result.error = "no records were read";
+	else if (result.error == "") {
+		map<string, vector<PostalCode> > stateMap;
+
+		result.stages.push_back (measureUnpack (buffers[0], names[0], filename, indexFilename, indexSchema, runs, samples));
+		result.stages.push_back (measureInsert (stateMap, buffers[0], names[0], filename, indexFilename, indexSchema, runs, samples));
+		result.stages.push_back (measureDisplay (stateMap, result.stages.back ().bytes, runs, samples, displayCalls));
+	}
+
+	for (size_t i = 0; i < buffers.size (); ++i)
+		delete buffers[i];
+
+	return result;
+}
+
+StageResult measureHeader (PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples, int calls) {
+	StageResult result;
+	result.stage = "readHeader";
+	result.buffer = name;
+	result.operations = calls;
+
+	long long stride = max (1, calls / samples);
+	ifstream infile (filename.c_str (), ios::binary);
+	int headerSize = 0;
+
+	// The file is only opened once. CSV buffers read the header from the read pointer, so it's put back at the start before each call
+	for (int run = 0; run <= runs; ++run) {
+		bool sampling = run == runs;
+		Clock::time_point start = Clock::now ();
+
+		for (int i = 0; i < calls and headerSize != -1; ++i) {
+			headerSize = timed (sampling and i % stride == 0, result.latencies, [&] () {
+				infile.clear ();
+				infile.seekg (0, ios::beg);
+				return buff->readHeader (infile, indexFilename, indexSchema);
+			});
+		}
+
+		if (sampling == false)
+			result.seconds.push_back (chrono::duration<double> (Clock::now () - start).count ());
+	}
+
+	result.bytes = headerSize > 0 ? (long long)headerSize * calls : 0;
+
+	return result;
+}
+
+StageResult measureRead (PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples) {
+	StageResult result;
+	result.stage = "read";
+	result.buffer = name;
+
+	long long stride = 1;
+
+	// The first run counts the records, which sets how often the last run samples a latency
+	for (int run = 0; run <= runs; ++run) {
+		bool sampling = run == runs;
+		ifstream infile (filename.c_str (), ios::binary);
+		long long records = 0;
+		long long start = max (0, buff->readHeader (infile, indexFilename, indexSchema));
+
+		Clock::time_point begin = Clock::now ();
+		while (timed (sampling and records % stride == 0, result.latencies, [&] () { return buff->read (infile); }) != -1)
+			records += 1;
+
+		if (sampling == false)
+			result.seconds.push_back (chrono::duration<double> (Clock::now () - begin).count ());
+
+		// The bytes of records run from the end of the header to the checksum directory or the end of the file
+		if (run == 0) {
+			NewPostalCodeBuffer* dat = dynamic_cast<NewPostalCodeBuffer*> (buff);
+			long long end = dat != NULL and dat->getChecksums ().getDataEnd () != -1 ? dat->getChecksums ().getDataEnd () : 0;
+
+			if (end == 0) {
+				infile.clear ();
+				infile.seekg (0, ios::end);
+				end = infile.tellg ();
+			}
+
+			result.operations = result.records = records;
+			result.bytes = max (0LL, end - start);
+			stride = max (1LL, records / samples);
+		}
+	}
+
+	return result;
+}
+
+StageResult measureUnpack (PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples) {
+	StageResult result;
+	result.stage = "unpackPostalCode";
+	result.buffer = name;
+
+	long long stride = 1;
+
+	for (int run = 0; run <= runs; ++run) {
+		bool sampling = run == runs;
+		ifstream infile (filename.c_str (), ios::binary);
+		PostalCodeBatch batch;
+		PostalCode postalCode;
+		long long records = 0;
+		long long bytes = 0;
+		double seconds = 0;
+
+		buff->readHeader (infile, indexFilename, indexSchema);
+
+		// Only the unpacking is timed, not reading the batches
+		while (buff->readBatch (infile, batch, batchSize) > 0) {
+			Clock::time_point start = Clock::now ();
+
+			for (int i = 0; i < batch.size (); ++i, ++records) {
+				buff->select (batch, i);
+				timed (sampling and records % stride == 0, result.latencies, [&] () { return unpackPostalCode (postalCode, buff); });
+			}
+
+			seconds += chrono::duration<double> (Clock::now () - start).count ();
+			for (int i = 0; i < batch.size (); ++i)
+				bytes += batch.getRecord (i).size ();
+		}
+
+		if (sampling == false)
+			result.seconds.push_back (seconds);
+
+		if (run == 0) {
+			result.operations = result.records = records;
+			result.bytes = bytes;
+			stride = max (1LL, records / samples);
+		}
+	}
+
+	return result;
+}
+
+StageResult measureInsert (map<string, vector<PostalCode> >& stateMap, PostalCodeBuffer* buff, const string& name, const string& filename, const string& indexFilename, const string& indexSchema, int runs, int samples) {
+	StageResult result;
+	result.stage = "fillTable insert";
+	result.buffer = name;
+
+	long long stride = 1;
+
+	for (int run = 0; run <= runs; ++run) {
+		bool sampling = run == runs;
+		ifstream infile (filename.c_str (), ios::binary);
+		PostalCodeBatch batch;
+		vector<PostalCode> postalCodes;
+		long long records = 0;
+		long long bytes = 0;
+		double seconds = 0;
+
+		stateMap.clear ();
+		buff->readHeader (infile, indexFilename, indexSchema);
+
+		// Only adding the postal codes to the map is timed, not reading and unpacking them
+		while (buff->readBatch (infile, batch, batchSize) > 0) {
+			unpackBatch (batch, buff, postalCodes);
+			for (int i = 0; i < batch.size (); ++i)
+				bytes += batch.getRecord (i).size ();
+
+			Clock::time_point start = Clock::now ();
+
+			for (size_t i = 0; i < postalCodes.size (); ++i, ++records) {
+				timed (sampling and records % stride == 0, result.latencies, [&] () {
+					vector<PostalCode>& state = stateMap[string (postalCodes[i].getState ())];
+					state.push_back (move (postalCodes[i]));
+					return state.size ();
+				});
+			}
+
+			seconds += chrono::duration<double> (Clock::now () - start).count ();
+		}
+
+		if (sampling == false)
+			result.seconds.push_back (seconds);
+
+		if (run == 0) {
+			result.operations = result.records = records;
+			result.bytes = bytes;
+			stride = max (1LL, records / samples);
+		}
+	}
+
+	return result;
+}
+
+StageResult measureDisplay (const map<string, vector<PostalCode> >& stateMap, long long bytes, int runs, int samples, int calls) {
+	StageResult result;
+	result.stage = "displayTable";
+	result.buffer = "";
+	result.operations = calls;
+
+	long long postalCodes = 0;
+	for (auto it = stateMap.begin (); it != stateMap.end (); ++it)
+		postalCodes += it->second.size ();
+	result.records = postalCodes * calls;
+	result.bytes = bytes * calls;
+
+	// The table is written to a stream that discards it, so the terminal's speed isn't measured
+	NullBuffer discard;
+	streambuf* original = cout.rdbuf (&discard);
+
+	long long stride = max (1, calls / samples);
+	for (int run = 0; run <= runs; ++run) {
+		bool sampling = run == runs;
+		Clock::time_point start = Clock::now ();
+
+		for (int i = 0; i < calls; ++i)
+			timed (sampling and i % stride == 0, result.latencies, [&] () { displayTable (stateMap); return 0; });
+
+		if (sampling == false)
+			result.seconds.push_back (chrono::duration<double> (Clock::now () - start).count ());
+	}
+
+	cout.rdbuf (original);
+
+	return result;
+}
+
+bool generateFiles (const string& sourceFilename, long long records, const string& csvFilename, const string& datFilename) {
+	ifstream infile (sourceFilename.c_str (), ios::binary);
+	CsvPostalCodeBuffer reader;
+	int headerSize = infile.is_open () ? reader.readHeader (infile, "", "") : -1;
+	if (headerSize == -1)
+		return false;
+
+	// Keeps the text of each valid record along with its postal code
+	string header (headerSize, 0);
+	vector<string> texts;
+	vector<PostalCode> postalCodes;
+	PostalCodeBatch batch;
+	PostalCode postalCode;
+
+	while (reader.readBatch (infile, batch, batchSize) > 0) {
+		for (int i = 0; i < batch.size (); ++i) {
+			reader.select (batch, i);
+			if (unpackPostalCode (postalCode, &reader) == -1)
+				continue;
+
+			texts.push_back (string (batch.getRecord (i)));
+			if (texts.back ().empty () or texts.back ().back () != '\n')
+				texts.back () += '\n';
+			postalCodes.push_back (postalCode);
+		}
+	}
+
+	infile.clear ();
+	infile.seekg (0, ios::beg);
+	infile.read (&header[0], header.size ());
+	if (texts.empty () or (size_t)infile.gcount () != header.size ())
+		return false;
+
+	// The CSV file repeats the records byte for byte after the source's header
+	ofstream csvFile (csvFilename.c_str (), ios::binary | ios::trunc);
+	string out = header;
+	for (long long i = 0; i < records; ++i) {
+		out += texts[i % texts.size ()];
+
+		if (out.size () >= (1 << 20)) {
+			csvFile.write (out.data (), out.size ());
+			out.clear ();
+		}
+	}
+	csvFile.write (out.data (), out.size ());
+	if (csvFile.good () == false)
+		return false;
+	csvFile.close ();
+
+	// The DAT file is written like the converter writes it with -v2, with the record count back-patched into the header
+	size_t slash = datFilename.find_last_of ('/');
+	size_t nameStart = slash == string::npos ? 0 : slash + 1;
+	string indexFilename = datFilename.substr (0, nameStart) + "index_" + datFilename.substr (nameStart);
+	string indexSchema = "key/FIXED/4/pos/FIXED/8";
+
+	ofstream datFile (datFilename.c_str (), ios::binary | ios::trunc);
+	NewPostalCodeBuffer writer (1000);
+	ChecksumDirectory checksums;
+	unsigned int blockRecords = 0;
+	long long written = 0;
+
+	writer.setVersion (2);
+	if (writer.writeHeader (datFile, 0, indexFilename, indexSchema) == -1)
+		return false;
+
+	out.clear ();
+	for (long long i = 0; i < records; ++i) {
+		if (packPostalCode (postalCodes[i % postalCodes.size ()], &writer) == -1 or writer.append (out) == -1)
+			continue;
+		blockRecords += 1;
+		written += 1;
+
+		// Closes the checksum block once it reaches the block size
+		if (out.size () >= (size_t)ChecksumDirectory::defaultBlockSize) {
+			checksums.add (datFile.tellp (), blockRecords, crc32c (out.data (), out.size ()));
+			datFile.write (out.data (), out.size ());
+			out.clear ();
+			blockRecords = 0;
+		}
+	}
+
+	// The last block holds the records after the last full block
+	if (blockRecords > 0) {
+		checksums.add (datFile.tellp (), blockRecords, crc32c (out.data (), out.size ()));
+		datFile.write (out.data (), out.size ());
+	}
+
+	if (checksums.write (datFile) == -1 or writer.writeHeader (datFile, written, indexFilename, indexSchema) == -1 or datFile.good () == false)
+		return false;
+
+	return true;
+}
+
+void writeJson (ostream& out, const vector<FileResult>& files, int runs, int samples) {
+	out << fixed << setprecision (3);
+	out << "{" << endl;
+	out << "  \"benchmark\": \"postal codes\"," << endl;
+	out << "  \"compiler\": " << jsonString (__VERSION__) << "," << endl;
+	out << "  \"runs\": " << runs << "," << endl;
+	out << "  \"samples\": " << samples << "," << endl;
+	out << "  \"crc32cKernel\": " << jsonString (getCrc32cKernel ()) << "," << endl;
+	out << "  \"files\": [";
+
+	for (size_t f = 0; f < files.size (); ++f) {
+		const FileResult& file = files[f];
+
+		out << (f > 0 ? "," : "") << endl << "    {" << endl;
+		out << "      \"file\": " << jsonString (file.filename) << "," << endl;
+		out << "      \"format\": " << jsonString (file.format) << "," << endl;
+		out << "      \"synthetic\": " << (file.synthetic > 0 ? "true" : "false") << "," << endl;
+		out << "      \"bytes\": " << file.size << "," << endl;
+		out << "      \"records\": " << file.records << "," << endl;
+		if (file.error != "")
+			out << "      \"error\": " << jsonString (file.error) << "," << endl;
+		out << "      \"stages\": [";
+
+		for (size_t s = 0; s < file.stages.size (); ++s) {
+			const StageResult& stage = file.stages[s];
+			vector<double> sorted = stage.latencies;
+			double seconds = median (stage.seconds);
+			double best = stage.seconds.empty () ? 0 : *min_element (stage.seconds.begin (), stage.seconds.end ());
+			double mean = 0;
+
+			sort (sorted.begin (), sorted.end ());
+			for (size_t i = 0; i < sorted.size (); ++i)
+				mean += sorted[i] / sorted.size ();
+
+			// Throughput is based on the median run, so one slow or fast run doesn't move it
+			out << (s > 0 ? "," : "") << endl << "        {" << endl;
+			out << "          \"stage\": " << jsonString (stage.stage) << "," << endl;
+			out << "          \"buffer\": " << jsonString (stage.buffer) << "," << endl;
+			out << "          \"operations\": " << stage.operations << "," << endl;
+			out << "          \"records\": " << stage.records << "," << endl;
+			out << "          \"bytes\": " << stage.bytes << "," << endl;
+			out << "          \"medianSeconds\": " << setprecision (9) << seconds << "," << endl;
+			out << "          \"bestSeconds\": " << best << setprecision (3) << "," << endl;
+			out << "          \"megabytesPerSecond\": " << (seconds > 0 ? stage.bytes / seconds / 1e6 : 0) << "," << endl;
+			out << "          \"recordsPerSecond\": " << (seconds > 0 ? stage.records / seconds : 0) << "," << endl;
+			out << "          \"operationsPerSecond\": " << (seconds > 0 ? stage.operations / seconds : 0) << "," << endl;
+			out << "          \"latencyNanoseconds\": {" << endl;
+			out << "            \"samples\": " << sorted.size () << "," << endl;
+			out << "            \"mean\": " << mean << "," << endl;
+			out << "            \"p50\": " << percentile (sorted, 0.5) << "," << endl;
+			out << "            \"p90\": " << percentile (sorted, 0.9) << "," << endl;
+			out << "            \"p99\": " << percentile (sorted, 0.99) << "," << endl;
+			out << "            \"p999\": " << percentile (sorted, 0.999) << "," << endl;
+			out << "            \"max\": " << (sorted.empty () ? 0 : sorted.back ()) << endl;
+			out << "          }" << endl;
+			out << "        }";
+		}
+
+		out << (file.stages.empty () ? "" : "\n      ") << "]" << endl;
+		out << "    }";
+	}
+
+	out << (files.empty () ? "" : "\n  ") << "]" << endl;
+	out << "}" << endl;
+}
+
+void displaySummary (ostream& out, const vector<FileResult>& files) {
+	for (size_t f = 0; f < files.size (); ++f) {
+		out << files[f].filename << " (" << files[f].records << " records, " << files[f].size << " bytes)" << endl;
+		if (files[f].error != "")
+			out << "  Error: " << files[f].error << endl;
+
+		for (size_t s = 0; s < files[f].stages.size (); ++s) {
+			const StageResult& stage = files[f].stages[s];
+			vector<double> sorted = stage.latencies;
+			double seconds = median (stage.seconds);
+
+			sort (sorted.begin (), sorted.end ());
+			out << "  " << left << setw (18) << stage.stage << setw (24) << stage.buffer << right << fixed << setprecision (1);
+			out << setw (10) << (seconds > 0 ? stage.bytes / seconds / 1e6 : 0) << " MB/s";
+			out << setw (14) << setprecision (0) << (seconds > 0 ? stage.records / seconds : 0) << " records/s";
+			out << "   p50 " << setw (9) << percentile (sorted, 0.5) << " ns";
+			out << "   p99 " << setw (9) << percentile (sorted, 0.99) << " ns" << endl;
+		}
+	}
+}
+
+string jsonString (const string& text) {
+	string quoted = "\"";
+
+	for (size_t i = 0; i < text.size (); ++i) {
+		char c = text[i];
+
+		if (c == '"' or c == '\\')
+			quoted += string ("\\") + c;
+		else if (c == '\n')
+			quoted += "\\n";
+		else if ((unsigned char)c < 0x20) {
+			char escaped[8];
+			snprintf (escaped, sizeof (escaped), "\\u%04x", c);
+			quoted += escaped;
+		}
+		else
+			quoted += c;
+	}
+
+	return quoted + "\"";
+}
+
+double percentile (const vector<double>& sorted, double fraction) {
+	if (sorted.empty ())
+		return 0;
+
+	// Nearest rank
+	size_t rank = (size_t)ceil (fraction * sorted.size ());
+
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+double median (vector<double> seconds) {
+	if (seconds.empty ())
+		return 0;
+
+	sort (seconds.begin (), seconds.end ());
+	size_t middle = seconds.size () / 2;
+
+	return seconds.size () % 2 == 1 ? seconds[middle] : (seconds[middle - 1] + seconds[middle]) / 2;
+}
@@ -0,0 +1,314 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include "StateTable.h"
+#include "CsvPostalCodeBuffer.h"
+#include "NewPostalCodeBuffer.h"
+#include "BlockPostalCodeBuffer.h"
+#include "ChecksumDirectory.h"
+#include "PostalCode.h"
+
+using namespace std;
+
+// Converts an old CSV postal code file into a new DAT file in a single pass
+// The CSV file is read in batches of records. Each batch is split between the threads, which encode their records
+// into their own output strings, and the strings are written to the file in order with one write each
+// Only one batch is held in memory at a time, so any number of records can be converted
+// The record count isn't known until the end, so the header is written first with a count of 0 and rewritten afterwards
+// Compressed files are split into blocks of about the block size. Each thread compresses its own blocks and the blocks are written in order
+// Other files are split into checksum blocks of about 64 KiB on record boundaries. Each thread checksums the blocks of its own records,
+// and the ChecksumDirectory is written after the last record
+
+/** Encodes a range of postal codes the way NewPostalCodeBuffer::write would write them
+ * @param postalCodes: the postal codes to encode
+ * @param begin: the first postal code to encode
+ * @param end: the postal code after the last one to encode
+ * @param format: a buffer with the version, field encoding and record layout to use
+ * @param out: the string the records will be appended to
+ * @param checksums: the checksum blocks of out are appended to it, with offsets from the start of out. Unused if NULL
+ * @post: out will hold the encoded records, split into checksum blocks of about ChecksumDirectory::defaultBlockSize bytes
+ * @return: returns the number of postal codes that couldn't be encoded */
+int encodeRange (const vector<PostalCode>& postalCodes, size_t begin, size_t end, const NewPostalCodeBuffer& format, string& out, vector<ChecksumDirectory::Entry>* checksums);
+
+/** Compresses a batch of postal codes into blocks and writes them
+ * @param postalCodes: the postal codes to write
+ * @param writer: the buffer that keeps the dictionaries and block directory
+ * @param blockSize: the decoded size each block is filled to
+ * @param threads: the number of threads that compress the blocks
+ * @param outfile: the file to write the blocks to
+ * @post: the blocks are written in order and added to the writer's block directory
+ * @return: returns true if the blocks were written, otherwise false */
+bool writeBlocks (const vector<PostalCode>& postalCodes, BlockPostalCodeBuffer& writer, int blockSize, int threads, ostream& outfile);
+
+// argv[1] = CSV input file, argv[2] = DAT output file, argv[3...] = options
+int main (int argc, char* argv[]) {
+	cout << endl; // CentOS formatting
+
+	// Checks if the number of arguments is correct
+	if (argc < 3) {
+		cout << "Enter './[program name] [CSV file name] [DAT file name] [options]'" << endl;
+		cout << "For example, './converter postal_codes.csv new_postal_codes.dat -binary'" << endl;
+		cout << "Options:" << endl;
+		cout << "  -new                       Writes delimited text fields (default)" << endl;
+		cout << "  -binary                    Writes binary numbers and length-indicated strings" << endl;
+		cout << "  -fixed                     Writes fixed-length records" << endl;
+		cout << "  -compressed                Writes compressed blocks with a block directory, read with '-block'. Always version 2" << endl;
+		cout << "  --block-size [bytes]       The decoded size of each compressed block. Defaults to 65536" << endl;
+		cout << "  -v2                        Writes a version 2 file, which has no 16-bit limits on the record count and record length" << endl;
+		cout << "  --no-checksums             Doesn't write the checksum directory after the records of an uncompressed file" << endl;
+		cout << "  -j [thread count]          Encodes the records on several threads" << endl;
+		cout << "  --batch [record count]     The number of records held in memory at a time" << endl;
+		cout << "  --index [index file name]  The index file named in the header. Defaults to 'index_' and the DAT file name" << endl;
+		cout << "  --schema [index schema]    The index schema written to the header. Defaults to 'key/FIXED/4/pos/FIXED/8', which is searched without loading the index" << endl;
+		return 1;
+	}
+
+	// Places the CLI arguments into variables
+	string inputFilename = argv[1];
+	string outputFilename = argv[2];
+	string indexFilename = "";
+	string indexSchema = "key/FIXED/4/pos/FIXED/8";
+	bool binary = false;
+	bool fixed = false;
+	bool compressed = false;
+	bool checksummed = true;
+	int blockSize = BlockPostalCodeBuffer::defaultBlockSize;
+	unsigned short version = 1;
+	int threads = thread::hardware_concurrency () > 0 ? thread::hardware_concurrency () : 1;
+	int batchSize = 1 << 16;
+
+	for (int i = 3; i < argc; ++i) {
+		string option = argv[i];
+
+		if (option == "-new")
+			binary = fixed = compressed = false;
+		else if (option == "-binary") {
+			binary = true;
+			fixed = compressed = false;
+		}
+		else if (option == "-fixed") {
+			binary = fixed = true;
+			compressed = false;
+		}
+		else if (option == "-compressed")
+			compressed = true;
+		else if (option == "--block-size" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			blockSize = atoi (argv[++i]);
+		else if (option == "-v2")
+			version = 2;
+		else if (option == "--no-checksums")
+			checksummed = false;
+		else if (option == "-j" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			threads = atoi (argv[++i]);
+		else if (option == "--batch" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			batchSize = atoi (argv[++i]);
+		else if (option == "--index" and i + 1 < argc)
+			indexFilename = argv[++i];
+		else if (option == "--schema" and i + 1 < argc)
+			indexSchema = argv[++i];
+		else {
+			cerr << "Invalid option '" << option << "'" << endl;
+			return 1;
+		}
+	}
+
+	// Names the index after the DAT file, keeping the DAT file's directory
+	if (indexFilename == "") {
+		size_t slash = outputFilename.find_last_of ('/');
+		size_t nameStart = slash == string::npos ? 0 : slash + 1;
+		indexFilename = outputFilename.substr (0, nameStart) + "index_" + outputFilename.substr (nameStart);
+	}
+
+	ifstream infile (inputFilename.c_str (), ios::binary);
+	if (!infile.is_open ()) {
+		cerr << "Error: could not open input file" << endl;
+		return 1;
+	}
+
+	CsvPostalCodeBuffer reader;
+	if (reader.readHeader (infile, "", "") == -1) {
+		cerr << "Error: the input file doesn't have a postal code CSV header" << endl;
+		return 1;
+	}
+
+	ofstream outfile (outputFilename.c_str (), ios::binary | ios::trunc);
+	NewPostalCodeBuffer writer (1000, binary);
+	BlockPostalCodeBuffer blockWriter;
+	writer.setFixed (fixed);
+	writer.setVersion (version);
+	if (compressed)
+		version = 2;
+
+	// Reserves room for the header, which is the same size no matter the record count
+	if (!outfile.is_open () or (compressed ? blockWriter.writeHeader (outfile, 0, indexFilename, indexSchema) : writer.writeHeader (outfile, 0, indexFilename, indexSchema)) == -1) {
+		cerr << "Error: could not write the output file" << endl;
+		return 1;
+	}
+	long long headerEnd = outfile.tellp ();
+
+	vector<PostalCode> batch;
+	vector<string> outputs (threads);
+	vector<vector<ChecksumDirectory::Entry> > blockChecksums (threads);
+	ChecksumDirectory checksums;
+	long long records = 0;
+	long long invalid = 0;
+	bool done = false;
+
+	batch.reserve (batchSize);
+
+	while (done == false) {
+		PostalCode postalCode;
+
+		// Reads the next batch
+		batch.clear ();
+		while ((int)batch.size () < batchSize and (done = reader.read (infile) == -1) == false) {
+			if (unpackPostalCode (postalCode, &reader) == -1 or (compressed and BlockPostalCodeBuffer::canEncode (postalCode) == false))
+				invalid += 1;
+			else
+				batch.push_back (postalCode);
+		}
+
+		if (compressed) {
+			if (writeBlocks (batch, blockWriter, blockSize, threads, outfile) == false) {
+				cerr << "Error: could not write the output file" << endl;
+				return 1;
+			}
+
+			records += batch.size ();
+			continue;
+		}
+
+		// Each thread encodes an equal share of the batch
+		vector<thread> workers;
+		vector<int> failed (threads, 0);
+		for (int t = 0; t < threads; ++t) {
+			workers.push_back (thread ([&, t] () {
+				outputs[t].clear ();
+				blockChecksums[t].clear ();
+				failed[t] = encodeRange (batch, batch.size () * t / threads, batch.size () * (t + 1) / threads, writer, outputs[t], checksummed ? &blockChecksums[t] : NULL);
+			}));
+		}
+
+		// Writes the encoded records in file order
+		for (int t = 0; t < threads; ++t) {
+			workers[t].join ();
+
+			long long position = outfile.tellp ();
+			for (size_t i = 0; i < blockChecksums[t].size (); ++i)
+				checksums.add (position + blockChecksums[t][i].offset, blockChecksums[t][i].records, blockChecksums[t][i].checksum);
+
+			outfile.write (outputs[t].data (), outputs[t].size ());
+			records += (batch.size () * (t + 1) / threads - batch.size () * t / threads) - failed[t];
+			invalid += failed[t];
+		}
+
+		// Gives the memory back instead of keeping the biggest batch's strings around
+		if (done)
+			outputs.assign (threads, string ());
+	}
+
+	// Version 1 headers only have room for a 2-byte record count
+	unsigned long long headerCount = records;
+	if (version < 2 and records > 0xFFFF) {
+		cerr << "A version 1 header can't hold " << records << " records, so its record count is set to " << 0xFFFF << ". Use -v2 to store the real count" << endl;
+		headerCount = 0xFFFF;
+	}
+
+	// The block directory or checksum directory goes after the last record
+	if ((compressed and blockWriter.writeFooter (outfile) == -1) or (compressed == false and checksummed and checksums.write (outfile) == -1)) {
+		cerr << "Error: could not write the output file" << endl;
+		return 1;
+	}
+	long long fileSize = outfile.tellp ();
+
+	// Back-patches the header with the real record count
+	if (outfile.good () == false or (compressed ? blockWriter.writeHeader (outfile, headerCount, indexFilename, indexSchema) : writer.writeHeader (outfile, headerCount, indexFilename, indexSchema)) == -1 or outfile.tellp () != headerEnd) {
+		cerr << "Error: could not write the output file" << endl;
+		return 1;
+	}
+	outfile.close ();
+
+	cout << "Number of records converted: " << records << endl;
+	cout << "Number of invalid records skipped: " << invalid << endl;
+	if (compressed)
+		cout << "Number of blocks written: " << blockWriter.getBlockCount () << " (" << fileSize << " bytes)" << endl;
+	else if (checksummed)
+		cout << "Number of checksum blocks written: " << checksums.size () << " (" << fileSize << " bytes)" << endl;
+
+	cout << endl << endl; // CentOS formatting
+
+	return 0;
+}
+
+int encodeRange (const vector<PostalCode>& postalCodes, size_t begin, size_t end, const NewPostalCodeBuffer& format, string& out, vector<ChecksumDirectory::Entry>* checksums) {
+	NewPostalCodeBuffer buffer (1000, format.isBinary ());
+	size_t blockStart = out.size ();
+	unsigned int blockRecords = 0;
+	int failed = 0;
+
+	buffer.setFixed (format.isFixed ());
+	buffer.setVersion (format.getVersion ());
+
+	for (size_t i = begin; i < end; ++i) {
+		// Closes the block before the record that would take it past the block size
+		if (checksums != NULL and blockRecords > 0 and out.size () - blockStart >= (size_t)ChecksumDirectory::defaultBlockSize) {
+			checksums->push_back ({(long long)blockStart, blockRecords, crc32c (out.data () + blockStart, out.size () - blockStart)});
+			blockStart = out.size ();
+			blockRecords = 0;
+		}
+
+		if (packPostalCode (postalCodes[i], &buffer) == -1 or buffer.append (out) == -1)
+			failed += 1;
+		else
+			blockRecords += 1;
+	}
+
+	if (checksums != NULL and blockRecords > 0)
+		checksums->push_back ({(long long)blockStart, blockRecords, crc32c (out.data () + blockStart, out.size () - blockStart)});
+
+	return failed;
+}
+
+bool writeBlocks (const vector<PostalCode>& postalCodes, BlockPostalCodeBuffer& writer, int blockSize, int threads, ostream& outfile) {
+	vector<unsigned int> stateIds (postalCodes.size ());
+	vector<unsigned int> countyIds (postalCodes.size ());
+	vector<size_t> bounds (1, 0);
+	size_t filled = 0;
+
+	// The dictionaries and block boundaries are decided in file order, which only needs the sizes of the strings
+	for (size_t i = 0; i < postalCodes.size (); ++i) {
+		int size = BlockPostalCodeBuffer::decodedSize (postalCodes[i]);
+
+		if (i > bounds.back () and (filled + size > (size_t)blockSize or i - bounds.back () == (size_t)BlockPostalCodeBuffer::maxBlockRecords)) {
+			bounds.push_back (i);
+			filled = 0;
+		}
+		filled += size;
+
+		writer.addToDictionaries (postalCodes[i], stateIds[i], countyIds[i]);
+	}
+	if (postalCodes.empty () == false)
+		bounds.push_back (postalCodes.size ());
+
+	// Each thread compresses every threads-th block
+	int blocks = bounds.size () - 1;
+	vector<string> encoded (blocks);
+	vector<thread> workers;
+	for (int t = 0; t < threads and t < blocks; ++t) {
+		workers.push_back (thread ([&, t] () {
+			for (int b = t; b < blocks; b += threads)
+				BlockPostalCodeBuffer::encodeBlock (postalCodes, bounds[b], bounds[b + 1], stateIds, countyIds, encoded[b]);
+		}));
+	}
+	for (size_t t = 0; t < workers.size (); ++t)
+		workers[t].join ();
+
+	for (int b = 0; b < blocks; ++b) {
+		if (writer.writeBlock (outfile, encoded[b], bounds[b + 1] - bounds[b], postalCodes[bounds[b]].getZipCode ()) == -1)
+			return false;
+	}
+
+	return true;
+}
\ No newline at end of file
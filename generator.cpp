@@ -0,0 +1,433 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
+#include "StateTable.h"
+#include "CsvPostalCodeBuffer.h"
+#include "NewPostalCodeBuffer.h"
+#include "ChecksumDirectory.h"
+#include "PostalCode.h"
+
+using namespace std;
+
+// Generates old CSV files and new DAT files of any size for testing and benchmarking
+// Each record is based on a record of a source CSV file, so the states, counties and places are spread the way they
+// are in real postal code data. Its coordinates are moved a little from the source record's, by up to jitter degrees
+// Sorted files go through the source records in zip code order like postal_codes.csv, repeating each one about
+// records / sources times. Random files pick a source record for each record, like postal_codes_random.csv
+// Every choice is made from the seed and the record's number alone, so the records are the same no matter how many threads made them
+// The records are made in rounds. Each thread makes its share of a round into its own string, and while the next
+// round is made the strings of the last one are written in order, so only two rounds are held in memory at a time
+// Corrupted CSV records are cut short before their last field. Corrupted DAT records have one byte changed after the
+// records are checksummed, so --verify finds the damage
+
+/** The options that decide what the records look like
+ * @author CSCI 331 Group 4
+ * @date 2026-10-17
+ */
+struct GeneratorOptions {
+	unsigned long long seed = 331; //!< The seed every choice is made from
+	long long records = 0; //!< The number of records in the file
+	bool random = false; //!< True to pick the records in random order instead of zip code order
+	double jitter = 0.05; //!< The most degrees a coordinate is moved from its source record
+	double corruption = 0; //!< The fraction of records that are corrupted
+	bool trailingDelimiter = false; //!< True to end every CSV line with a delimiter, like postal_codes_random.csv
+};
+
+/** Mixes a number into a random-looking number (SplitMix64)
+ * @param x: the number to mix
+ * @return: returns the mixed number. Different numbers always give different results */
+uint64_t mix (uint64_t x);
+
+/** Makes a random number for one of a record's choices
+ * @param seed: the seed of the file
+ * @param record: the number of the record
+ * @param choice: which of the record's choices the number is for
+ * @return: returns a number between 0 (inclusive) and 1 (exclusive) */
+double choose (unsigned long long seed, long long record, int choice);
+
+/** Makes the postal code of a record
+ * @param sources: the source postal codes, in zip code order
+ * @param record: the number of the record
+ * @param options: the options of the file
+ * @return: returns the postal code */
+PostalCode makePostalCode (const vector<PostalCode>& sources, long long record, const GeneratorOptions& options);
+
+/** Generates a range of records as CSV lines
+ * @param sources: the source postal codes, in zip code order
+ * @param begin: the first record to generate
+ * @param end: the record after the last one to generate
+ * @param options: the options of the file
+ * @param out: the lines are appended to it
+ * @return: returns the number of corrupted records */
+long long generateCsv (const vector<PostalCode>& sources, long long begin, long long end, const GeneratorOptions& options, string& out);
+
+/** Generates a range of records the way NewPostalCodeBuffer::write would write them
+ * @param sources: the source postal codes, in zip code order
+ * @param begin: the first record to generate
+ * @param end: the record after the last one to generate
+ * @param options: the options of the file
+ * @param format: a buffer with the version, field encoding and record layout to use
+ * @param out: the records are appended to it
+ * @param checksums: the checksum blocks of out are appended to it, with offsets from the start of out. Unused if NULL
+ * @param failed: set to the number of records that couldn't be encoded
+ * @return: returns the number of corrupted records */
+long long generateDat (const vector<PostalCode>& sources, long long begin, long long end, const GeneratorOptions& options, const NewPostalCodeBuffer& format, string& out, vector<ChecksumDirectory::Entry>* checksums, long long& failed);
+
+/** Appends a coordinate the way the CSV files write them, with up to 4 decimal places and no trailing zeros
+ * @param value: the coordinate
+ * @param out: the coordinate is appended to it */
+void appendCoordinate (double value, string& out);
+
+// argv[1] = output file, argv[2] = record count, argv[3...] = options
+int main (int argc, char* argv[]) {
+	cout << endl; // CentOS formatting
+
+	// Checks if the number of arguments is correct
+	if (argc < 3 or atoll (argv[2]) < 0) {
+		cout << "Enter './[program name] [output file name] [record count] [options]'" << endl;
+		cout << "For example, './generator big_postal_codes.csv 100000000 -csv --random --seed 7'" << endl;
+		cout << "Options:" << endl;
+		cout << "  -csv                       Writes an old CSV file. The default for file names ending in '.csv'" << endl;
+		cout << "  -new                       Writes a DAT file with delimited text fields. The default for other file names" << endl;
+		cout << "  -binary                    Writes a DAT file with binary numbers and length-indicated strings" << endl;
+		cout << "  -fixed                     Writes a DAT file with fixed-length records" << endl;
+		cout << "  -v2                        Writes a version 2 DAT file. Always used for more than 65535 records" << endl;
+		cout << "  --no-checksums             Doesn't write the checksum directory after the records of a DAT file" << endl;
+		cout << "  --source [CSV file name]   The CSV file the records are based on. Defaults to 'Test Files/postal_codes.csv'" << endl;
+		cout << "  --seed [number]            The seed every choice is made from. Defaults to 331" << endl;
+		cout << "  --random                   Writes the records in random order instead of zip code order" << endl;
+		cout << "  --jitter [degrees]         The most a coordinate is moved from its source record. Defaults to 0.05" << endl;
+		cout << "  --corrupt [fraction]       Corrupts this fraction of the records, like 0.001" << endl;
+		cout << "  --trailing-delimiter       Ends every CSV line with a delimiter, like postal_codes_random.csv" << endl;
+		cout << "  -j [thread count]          Generates the records on several threads" << endl;
+		cout << "  --batch [record count]     The number of records each thread makes at a time" << endl;
+		return 1;
+	}
+
+	// Places the CLI arguments into variables
+	string outputFilename = argv[1];
+	string sourceFilename = "Test Files/postal_codes.csv";
+	GeneratorOptions options;
+	bool csv = outputFilename.size () >= 4 and outputFilename.compare (outputFilename.size () - 4, 4, ".csv") == 0;
+	bool binary = false;
+	bool fixed = false;
+	bool checksummed = true;
+	unsigned short version = 1;
+	int threads = thread::hardware_concurrency () > 0 ? thread::hardware_concurrency () : 1;
+	int batchSize = 1 << 16;
+
+	options.records = atoll (argv[2]);
+
+	for (int i = 3; i < argc; ++i) {
+		string option = argv[i];
+
+		if (option == "-csv")
+			csv = true;
+		else if (option == "-new")
+			csv = binary = fixed = false;
+		else if (option == "-binary") {
+			binary = true;
+			csv = fixed = false;
+		}
+		else if (option == "-fixed") {
+			binary = fixed = true;
+			csv = false;
+		}
+		else if (option == "-v2")
+			version = 2;
+		else if (option == "--no-checksums")
+			checksummed = false;
+		else if (option == "--source" and i + 1 < argc)
+			sourceFilename = argv[++i];
+		else if (option == "--seed" and i + 1 < argc)
+			options.seed = strtoull (argv[++i], NULL, 10);
+		else if (option == "--random")
+			options.random = true;
+		else if (option == "--jitter" and i + 1 < argc and atof (argv[i + 1]) >= 0)
+			options.jitter = atof (argv[++i]);
+		else if (option == "--corrupt" and i + 1 < argc and atof (argv[i + 1]) >= 0 and atof (argv[i + 1]) <= 1)
+			options.corruption = atof (argv[++i]);
+		else if (option == "--trailing-delimiter")
+			options.trailingDelimiter = true;
+		else if (option == "-j" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			threads = atoi (argv[++i]);
+		else if (option == "--batch" and i + 1 < argc and atoi (argv[i + 1]) > 0)
+			batchSize = atoi (argv[++i]);
+		else {
+			cerr << "Invalid option '" << option << "'" << endl;
+			return 1;
+		}
+	}
+
+	// Reads the source records, keeping the valid ones in zip code order
+	ifstream infile (sourceFilename.c_str (), ios::binary);
+	CsvPostalCodeBuffer reader;
+	if (!infile.is_open () or reader.readHeader (infile, "", "") == -1) {
+		cerr << "Error: could not read the source file" << endl;
+		return 1;
+	}
+
+	vector<PostalCode> sources;
+	PostalCode postalCode;
+	while (reader.read (infile) != -1) {
+		if (unpackPostalCode (postalCode, &reader) != -1)
+			sources.push_back (postalCode);
+	}
+	infile.close ();
+
+	if (sources.empty ()) {
+		cerr << "Error: the source file doesn't have any valid records" << endl;
+		return 1;
+	}
+	stable_sort (sources.begin (), sources.end (), [] (const PostalCode& a, const PostalCode& b) { return a.getZipCode () < b.getZipCode (); });
+
+	// Version 1 headers only have room for a 2-byte record count
+	if (csv == false and version < 2 and options.records > 0xFFFF) {
+		cout << "A version 1 header can't hold " << options.records << " records, so a version 2 file is written" << endl;
+		version = 2;
+	}
+
+	// Names the index after the DAT file, keeping the DAT file's directory
+	size_t slash = outputFilename.find_last_of ('/');
+	size_t nameStart = slash == string::npos ? 0 : slash + 1;
+	string indexFilename = outputFilename.substr (0, nameStart) + "index_" + outputFilename.substr (nameStart);
+	string indexSchema = "key/FIXED/4/pos/FIXED/8";
+
+	ofstream outfile (outputFilename.c_str (), ios::binary | ios::trunc);
+	NewPostalCodeBuffer writer (1000, binary);
+	writer.setFixed (fixed);
+	writer.setVersion (version);
+
+	// The header is the same size no matter the record count, so it's rewritten with the real count at the end
+	bool opened = outfile.is_open ();
+	if (opened and csv) {
+		string header = "\"Zip\nCode\",\"Place\nName\",State,County,Lat,Long";
+		header += options.trailingDelimiter ? ",\r\n" : "\r\n";
+		outfile.write (header.data (), header.size ());
+	}
+	else if (opened)
+		opened = writer.writeHeader (outfile, options.records, indexFilename, indexSchema) != -1;
+	if (opened == false or outfile.good () == false) {
+		cerr << "Error: could not write the output file" << endl;
+		return 1;
+	}
+
+	chrono::steady_clock::time_point start = chrono::steady_clock::now ();
+	long long roundSize = (long long)threads * batchSize;
+	long long rounds = (options.records + roundSize - 1) / roundSize;
+	vector<vector<string> > outputs (2, vector<string> (threads));
+	vector<vector<vector<ChecksumDirectory::Entry> > > blockChecksums (2, vector<vector<ChecksumDirectory::Entry> > (threads));
+	vector<vector<long long> > corrupted (2, vector<long long> (threads, 0));
+	vector<vector<long long> > failed (2, vector<long long> (threads, 0));
+	ChecksumDirectory checksums;
+	long long totalCorrupted = 0;
+	long long totalFailed = 0;
+	vector<thread> workers;
+
+	// Starts the threads that make a round into one of the two sets of strings
+	auto startRound = [&] (long long round) {
+		int set = round % 2;
+
+		workers.clear ();
+		for (int t = 0; t < threads; ++t) {
+			workers.push_back (thread ([&, t, round, set] () {
+				long long begin = min (options.records, round * roundSize + (long long)t * batchSize);
+				long long end = min (options.records, begin + batchSize);
+
+				outputs[set][t].clear ();
+				blockChecksums[set][t].clear ();
+				if (csv)
+					corrupted[set][t] = generateCsv (sources, begin, end, options, outputs[set][t]);
+				else
+					corrupted[set][t] = generateDat (sources, begin, end, options, writer, outputs[set][t], checksummed ? &blockChecksums[set][t] : NULL, failed[set][t]);
+			}));
+		}
+	};
+
+	if (rounds > 0)
+		startRound (0);
+
+	for (long long round = 0; round < rounds; ++round) {
+		int set = round % 2;
+
+		for (size_t t = 0; t < workers.size (); ++t)
+			workers[t].join ();
+
+		// The next round is made while this one is written
+		if (round + 1 < rounds)
+			startRound (round + 1);
+
+		for (int t = 0; t < threads; ++t) {
+			long long position = outfile.tellp ();
+			for (size_t i = 0; i < blockChecksums[set][t].size (); ++i)
+				checksums.add (position + blockChecksums[set][t][i].offset, blockChecksums[set][t][i].records, blockChecksums[set][t][i].checksum);
+
+			outfile.write (outputs[set][t].data (), outputs[set][t].size ());
+			totalCorrupted += corrupted[set][t];
+			totalFailed += failed[set][t];
+		}
+
+		if (outfile.good () == false) {
+			for (size_t t = 0; t < workers.size () and round + 1 < rounds; ++t)
+				workers[t].join ();
+
+			cerr << "Error: could not write the output file" << endl;
+			return 1;
+		}
+	}
+
+	// The checksum directory goes after the last record
+	if (csv == false and checksummed and checksums.write (outfile) == -1) {
+		cerr << "Error: could not write the output file" << endl;
+		return 1;
+	}
+	long long fileSize = outfile.tellp ();
+
+	// Back-patches the header if some records couldn't be encoded
+	if (csv == false and totalFailed > 0 and writer.writeHeader (outfile, options.records - totalFailed, indexFilename, indexSchema) == -1) {
+		cerr << "Error: could not write the output file" << endl;
+		return 1;
+	}
+	outfile.close ();
+
+	double seconds = chrono::duration<double> (chrono::steady_clock::now () - start).count ();
+
+	cout << "Number of records generated: " << options.records - totalFailed << " (" << fileSize << " bytes)" << endl;
+	if (totalFailed > 0)
+		cout << "Number of records that couldn't be encoded: " << totalFailed << endl;
+	cout << "Number of corrupted records: " << totalCorrupted << endl;
+	if (csv == false and checksummed)
+		cout << "Number of checksum blocks written: " << checksums.size () << endl;
+	cout << "Generated in " << (long long)(seconds * 1000) << " ms (" << (seconds > 0 ? (long long)(fileSize / seconds / 1e6) : 0) << " MB/s) on " << threads << " threads" << endl;
+
+	cout << endl << endl; // CentOS formatting
+
+	return 0;
+}
+
+uint64_t mix (uint64_t x) {
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+
+	return x ^ (x >> 31);
+}
+
+double choose (unsigned long long seed, long long record, int choice) {
+	uint64_t x = mix (mix (seed) ^ ((uint64_t)record * 8 + choice));
+
+	// The top 53 bits fill a double's fraction exactly
+	return (x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+PostalCode makePostalCode (const vector<PostalCode>& sources, long long record, const GeneratorOptions& options) {
+	size_t source;
+	if (options.random)
+		source = choose (options.seed, record, 0) * sources.size ();
+	else
+		source = (size_t)((double)record * sources.size () / options.records);
+	source = min (source, sources.size () - 1);
+
+	PostalCode pc = sources[source];
+	double lat = pc.getLat () + (choose (options.seed, record, 1) * 2 - 1) * options.jitter;
+	double lng = pc.getLong () + (choose (options.seed, record, 2) * 2 - 1) * options.jitter;
+
+	pc.setLat (max (-90.0, min (90.0, lat)));
+	pc.setLong (max (-180.0, min (180.0, lng)));
+
+	return pc;
+}
+
+long long generateCsv (const vector<PostalCode>& sources, long long begin, long long end, const GeneratorOptions& options, string& out) {
+	long long corrupted = 0;
+
+	for (long long i = begin; i < end; ++i) {
+		PostalCode pc = makePostalCode (sources, i, options);
+		size_t start = out.size ();
+		char zip[16];
+
+		// The fields of the source files don't need quotes, so none are written
+		out.append (zip, to_chars (zip, zip + sizeof (zip), pc.getZipCode ()).ptr - zip);
+		out += ',';
+		out += pc.getCity ();
+		out += ',';
+		out += pc.getState ();
+		out += ',';
+		out += pc.getCounty ();
+		out += ',';
+		appendCoordinate (pc.getLat (), out);
+		out += ',';
+		size_t lastField = out.size ();
+		appendCoordinate (pc.getLong (), out);
+		if (options.trailingDelimiter)
+			out += ',';
+
+		// Cuts the line short before its last field, like a record that was only partly written
+		if (options.corruption > 0 and choose (options.seed, i, 3) < options.corruption) {
+			out.resize (start + (size_t)(choose (options.seed, i, 4) * (lastField - start)));
+			corrupted += 1;
+		}
+
+		out += "\r\n";
+	}
+
+	return corrupted;
+}
+
+long long generateDat (const vector<PostalCode>& sources, long long begin, long long end, const GeneratorOptions& options, const NewPostalCodeBuffer& format, string& out, vector<ChecksumDirectory::Entry>* checksums, long long& failed) {
+	NewPostalCodeBuffer buffer (1000, format.isBinary ());
+	vector<pair<long long, size_t> > damage; // The number of each corrupted record and the position of its replaced byte
+	size_t blockStart = out.size ();
+	unsigned int blockRecords = 0;
+
+	failed = 0;
+	buffer.setFixed (format.isFixed ());
+	buffer.setVersion (format.getVersion ());
+
+	for (long long i = begin; i < end; ++i) {
+		// Closes the block before the record that would take it past the block size
+		if (checksums != NULL and blockRecords > 0 and out.size () - blockStart >= (size_t)ChecksumDirectory::defaultBlockSize) {
+			checksums->push_back ({(long long)blockStart, blockRecords, crc32c (out.data () + blockStart, out.size () - blockStart)});
+			blockStart = out.size ();
+			blockRecords = 0;
+		}
+
+		size_t start = out.size ();
+		if (packPostalCode (makePostalCode (sources, i, options), &buffer) == -1 or buffer.append (out) == -1) {
+			failed += 1;
+			continue;
+		}
+		blockRecords += 1;
+
+		if (options.corruption > 0 and choose (options.seed, i, 3) < options.corruption)
+			damage.push_back ({i, start + (size_t)(choose (options.seed, i, 4) * (out.size () - start))});
+	}
+
+	if (checksums != NULL and blockRecords > 0)
+		checksums->push_back ({(long long)blockStart, blockRecords, crc32c (out.data () + blockStart, out.size () - blockStart)});
+
+	// The bytes are replaced after the checksums are computed, like damage that happens on disk
+	for (size_t i = 0; i < damage.size (); ++i)
+		out[damage[i].second] ^= (char)(1 + (int)(choose (options.seed, damage[i].first, 5) * 255));
+
+	return damage.size ();
+}
+
+void appendCoordinate (double value, string& out) {
+	char text[32];
+	char* end = to_chars (text, text + sizeof (text), value, chars_format::fixed, 4).ptr;
+
+	// Drops the trailing zeros and a trailing decimal point
+	while (end > text and end[-1] == '0')
+		--end;
+	if (end > text and end[-1] == '.')
+		--end;
+
+	out.append (text, end - text);
+}
@@ -4,39 +4,139 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <chrono>
+#include <thread>
+#include <climits>
+#include <limits>
+#include <cmath>
+#include "StateTable.h"
 #include "PostalCodeBuffer.h"
 #include "NewPostalCodeBuffer.h"
+#include "MappedPostalCodeBuffer.h"
+#include "BlockPostalCodeBuffer.h"
+#include "ChecksumDirectory.h"
+#include "MappedFile.h"
+#include "CsvPostalCodeBuffer.h"
+#include "PostalCodeIndex.h"
+#include "PostalCodeBTree.h"
+#include "BitmapIndex.h"
+#include "SpatialIndex.h"
 #include "PostalCode.h"
+#include "IngestStats.h"
 
 using namespace std;
 
-/** Unpacks postal code information from a buffer into an object
- * @param file: the file to read data from
- * @param pc: The PostalCode object that will be filled
- * @param buff: The buffer containing the postal code data
- * @post: the PostalCode object will be filled with data
- * @return: returns -1 if an error occured */
-int unpackPostalCode (PostalCode& pc, PostalCodeBuffer* buff);
+/** Builds the primary key index for a new DAT file
+ * @param filename: the name of the DAT file
+ * @param indexFilename: the name of the index file to create. If empty, the name in the DAT header is used
+ * @param buff: the buffer that will be used to read the records
+ * @post: writes the index file and prints the number of indexed records
+ * @return: returns true if the operation was successful, otherwise false */
+bool buildIndex (const char* filename, const string& indexFilename, NewPostalCodeBuffer* buff);
 
-/** Fills a map with postal code data for each state
- * @param stateMap: the map that will be filled with postal code information
- * @param filename: the name of the file containing postal code data
- * @param buff: the buffer that will be used to extract the data
- * @param fileFormat: the format of the postal code file (new or old)
- * @post: the stateMap will be filled with postal code data for each state
+/** Finds a single postal code in a new DAT file using its primary key index
+ * @param filename: the name of the DAT file
+ * @param indexFilename: the name of the index file. If empty, the name in the DAT header is used
+ * @param zipCode: the zip code to find
+ * @param buff: the buffer that will be used to read the record
+ * @post: prints the postal code if it was found
+ * @return: returns true if the postal code was found, otherwise false */
+bool findPostalCode (const char* filename, const string& indexFilename, int zipCode, PostalCodeBuffer* buff);
+
+/** Builds the zip code B+-tree for a new DAT file
+ * @param filename: the name of the DAT file
+ * @param btreeFilename: the name of the B+-tree file to create
+ * @param buff: the buffer that will be used to read the records
+ * @post: writes the B+-tree file and prints the number of entries and its height
+ * @return: returns true if the operation was successful, otherwise false */
+bool buildBTree (const char* filename, const string& btreeFilename, NewPostalCodeBuffer* buff);
+
+/** Prints every postal code in a range of zip codes using the B+-tree
+ * @param filename: the name of the DAT file
+ * @param btreeFilename: the name of the B+-tree file
+ * @param low: the lowest zip code to print
+ * @param high: the highest zip code to print
+ * @param buff: the buffer that will be used to read the records
+ * @post: prints the postal codes in zip code order and the number of tree pages that were read
+ * @return: returns true if the records were read, otherwise false */
+bool printRange (const char* filename, const string& btreeFilename, int low, int high, PostalCodeBuffer* buff);
+
+/** Builds the state and county bitmap indexes for a new DAT file
+ * @param filename: the name of the DAT file
+ * @param bitmapFilename: the name of the bitmap index file to create
+ * @param buff: the buffer that will be used to read the records
+ * @post: writes the bitmap index file and prints the number of indexed records
  * @return: returns true if the operation was successful, otherwise false */
-bool fillTable (map<string, vector<PostalCode> >& stateMap, const char* filename, PostalCodeBuffer* buff, string fileFormat);
+bool buildBitmaps (const char* filename, const string& bitmapFilename, NewPostalCodeBuffer* buff);
+
+/** Fills the map with only the records in some states and counties, using the bitmap indexes
+ * @param stateMap: the map that will be filled with postal code information
+ * @param filename: the name of the DAT file
+ * @param bitmapFilename: the name of the bitmap index file
+ * @param states: the states to keep. If empty, every state is kept
+ * @param counties: the county names to keep. If empty, every county is kept
+ * @param buff: the buffer that will be used to read the records
+ * @post: the stateMap will hold the records in any of the states and any of the counties
+ * @return: returns true if the records were read, otherwise false */
+bool fillTableFiltered (map<string, vector<PostalCode> >& stateMap, const char* filename, const string& bitmapFilename, const vector<string>& states, const vector<string>& counties, PostalCodeBuffer* buff);
+
+/** Names a file that belongs to a DAT file, keeping the DAT file's directory
+ * @param filename: the name of the DAT file
+ * @param prefix: the prefix added to the DAT file's name (ex: 'btree_')
+ * @return: returns the name of the file */
+string companionFilename (const string& filename, const string& prefix);
+
+/** Splits a comma separated list
+ * @param list: the list
+ * @return: returns the values of the list */
+vector<string> splitList (const string& list);
+
+/** Reads the number given to an option
+ * @param option: the option, which is named in the error message
+ * @param text: the argument after the option
+ * @param low: the smallest number allowed
+ * @param high: the largest number allowed
+ * @param value: set to the number if it's valid
+ * @post: prints an error if the argument isn't a number from low to high
+ * @return: returns true if the number is valid, otherwise false */
+bool readNumber (const string& option, const char* text, long long low, long long high, long long& value);
+bool readNumber (const string& option, const char* text, int low, int high, int& value);
+bool readNumber (const string& option, const char* text, double low, double high, double& value);
 
-/** Shows the table header
- * @post: prints the table header to the console */
-void displayHeader ();
+/** Reads a single record from a fixed-length DAT file by its record number
+ * @param filename: the name of the DAT file
+ * @param recordNumber: the number of the record, starting at 0
+ * @param buff: the buffer that will be used to read the record
+ * @post: prints the postal code if it was read
+ * @return: returns true if the record was read, otherwise false */
+bool printRecord (const char* filename, long long recordNumber, NewPostalCodeBuffer* buff);
 
-/** Shows the postal code table data
- * @param stateMap: contains the postal code data for each state
- * @post: prints the farthest zip codes for each state in each compass directon */
-void displayTable (const map<string, vector<PostalCode> >& stateMap);
+/** Checks a DAT file for damage. The blocks of a file with checksums are checked on several threads,
+ * and a file without checksums is scanned record by record, resyncing after each damaged record
+ * @param filename: the name of the DAT file
+ * @param threads: the number of threads that check the blocks
+ * @param buff: the buffer that will be used to read the header and checksums
+ * @post: prints each damaged block or range of bytes and how long checking took
+ * @return: returns true if no damage was found, otherwise false */
+bool verifyFile (const char* filename, int threads, NewPostalCodeBuffer* buff);
 
-// argv[1] = input file, argv[2] = file format
+/** Runs a nearest or radius query and prints the postal codes it found
+ * @param index: the spatial index to search
+ * @param query: 'nearest' or 'radius'
+ * @param lat: the latitude to search around
+ * @param lng: the longitude to search around
+ * @param amount: the number of postal codes to find for 'nearest' or the distance in kilometers for 'radius'
+ * @post: prints the postal codes nearest first, with their distances and the time the query took
+ * @return: returns true if the query was valid, otherwise false */
+bool runSpatialQuery (const SpatialIndex& index, const string& query, double lat, double lng, double amount);
+
+/** Displays the counters and stage times collected while reading the file
+ * @param statsOutput: 'table' to print them after the report, or the name of a file to write them to as JSON ('-' for the console)
+ * @post: does nothing if statsOutput is empty
+ * @return: returns false if the JSON file couldn't be written, otherwise true */
+bool displayStats (const string& statsOutput);
+
+// argv[1] = input file, argv[2] = file format, argv[3...] = options
 int main(int argc, char* argv[]) {
     map<string, vector<PostalCode> > stateMap; // Create a map to store PostalCode objects by state ID
 	PostalCodeBuffer* buff;
@@ -47,166 +147,746 @@ int main(int argc, char* argv[]) {
 	if (argc < 3) {
         cout << "Enter './[program name] [record file name]  [file format]'" << endl;
         cout << "For example, './myProgram zip_codes.csv -old'" << endl;
+        cout << "File formats: '-old' (CSV), '-csv' (CSV read in blocks), '-new' (DAT), '-mmap' (DAT read through a memory map) and '-block' (compressed DAT)" << endl;
+        cout << "Options:" << endl;
+        cout << "  -j [thread count]          Reads the file on several threads" << endl;
+        cout << "  --pipeline                 Reads, unpacks and stores the records on separate threads, with -j unpacking threads" << endl;
+        cout << "  --extremes                 Only keeps the farthest postal codes of each state while reading, using constant memory" << endl;
+        cout << "  --columnar                 Stores the postal codes by column instead of as objects" << endl;
+        cout << "  --string-stats             Shows how much memory interning the city, state and county names saved" << endl;
+        cout << "  --kernel [name]            Chooses the --columnar search kernel: 'avx512', 'avx2', 'scalar' or 'auto' (default)" << endl;
+        cout << "  --nearest [lat] [lng] [k]  Finds the k postal codes nearest to a coordinate" << endl;
+        cout << "  --radius [lat] [lng] [km]  Finds the postal codes within a distance of a coordinate" << endl;
+        cout << "  --spatial                  Reads 'nearest [lat] [lng] [k]' and 'radius [lat] [lng] [km]' queries from the console, one per line" << endl;
+        cout << "  --stats                    Shows the bytes and records read and the time spent in each stage of reading" << endl;
+        cout << "  --stats-json [file name]   Writes the --stats counters and times to a file as JSON ('-' for the console)" << endl;
+        cout << "Options for '-new', '-mmap' and '-block' files:" << endl;
+        cout << "  --index [index file name]  Uses a different index file than the one named in the header" << endl;
+        cout << "  --build-index              Builds the zip code index" << endl;
+        cout << "  --find [zip code]          Finds a single zip code using the index" << endl;
+        cout << "  --record [record number]   Reads a single record of a fixed-length file, starting at 0" << endl;
+        cout << "  --verify                   Checks the file's checksums on the -j threads, or scans it for damaged records if it has none" << endl;
+        cout << "  --btree [B+-tree file name] Uses a different B+-tree file than 'btree_' and the DAT file name" << endl;
+        cout << "  --build-btree              Builds the zip code B+-tree" << endl;
+        cout << "  --range [low] [high]       Finds the zip codes from low to high using the B+-tree" << endl;
+        cout << "  --bitmap [index file name] Uses a different bitmap index file than 'bitmap_' and the DAT file name" << endl;
+        cout << "  --build-bitmap             Builds the state and county bitmap indexes" << endl;
+        cout << "  --state [states]           Only shows the states in a comma separated list (ex: WI,MN), using the bitmap indexes" << endl;
+        cout << "  --county [counties]        Only shows the counties in a comma separated list, using the bitmap indexes" << endl;
         return 1;
     }
 
 	// Places the CLI arguments into variables
 	string filename = argv[1];
 	string fileFormat = argv[2];
-	
+	string indexFilename = "";
+	bool build = false;
+	string btreeFilename = "";
+	bool buildTree = false;
+	int rangeLow = -1;
+	int rangeHigh = -1;
+	string bitmapFilename = "";
+	bool buildBitmap = false;
+	vector<string> stateFilter;
+	vector<string> countyFilter;
+	int findZip = -1;
+	long long recordNumber = -1;
+	int threads = 1;
+	bool streaming = false;
+	bool pipeline = false;
+	bool columnar = false;
+	bool stringStats = false;
+	bool verify = false;
+	string spatialQuery = ""; // 'nearest', 'radius' or 'console'
+	string statsOutput = ""; // 'table' or the name of the JSON file
+	double spatialArgs[3] = {0, 0, 0};
+
+	for (int i = 3; i < argc; ++i) {
+		string option = argv[i];
+
+		if (option == "--index" and i + 1 < argc)
+			indexFilename = argv[++i];
+		else if (option == "--extremes")
+			streaming = true;
+		else if (option == "--pipeline")
+			pipeline = true;
+		else if (option == "--columnar")
+			columnar = true;
+		else if (option == "--string-stats")
+			stringStats = true;
+		else if (option == "--kernel" and i + 1 < argc) {
+			if (selectExtremesKernel (argv[++i]) == false) {
+				cerr << "The '" << argv[i] << "' kernel isn't supported on this computer" << endl;
+				return 1;
+			}
+		}
+		else if (option == "--build-index")
+			build = true;
+		else if (option == "--btree" and i + 1 < argc)
+			btreeFilename = argv[++i];
+		else if (option == "--build-btree")
+			buildTree = true;
+		else if (option == "--bitmap" and i + 1 < argc)
+			bitmapFilename = argv[++i];
+		else if (option == "--build-bitmap")
+			buildBitmap = true;
+		else if (option == "--state" and i + 1 < argc)
+			stateFilter = splitList (argv[++i]);
+		else if (option == "--county" and i + 1 < argc)
+			countyFilter = splitList (argv[++i]);
+		else if (option == "--range" and i + 2 < argc) {
+			if (readNumber (option, argv[++i], 0, 99999, rangeLow) == false or readNumber (option, argv[++i], 0, 99999, rangeHigh) == false)
+				return 1;
+		}
+		else if (option == "--find" and i + 1 < argc) {
+			if (readNumber (option, argv[++i], 0, 99999, findZip) == false)
+				return 1;
+		}
+		else if (option == "--record" and i + 1 < argc) {
+			if (readNumber (option, argv[++i], 0LL, LLONG_MAX, recordNumber) == false)
+				return 1;
+		}
+		else if (option == "-j" and i + 1 < argc) {
+			if (readNumber (option, argv[++i], 1, INT_MAX, threads) == false)
+				return 1;
+		}
+		else if ((option == "--nearest" or option == "--radius") and i + 3 < argc) {
+			spatialQuery = option.substr (2);
+			if (readNumber (option, argv[++i], -90.0, 90.0, spatialArgs[0]) == false or readNumber (option, argv[++i], -180.0, 180.0, spatialArgs[1]) == false)
+				return 1;
+
+			// k counts postal codes, so it has to be a whole number. The radius can be any distance
+			if (spatialQuery == "nearest") {
+				int k;
+				if (readNumber (option, argv[++i], 0, INT_MAX, k) == false)
+					return 1;
+				spatialArgs[2] = k;
+			}
+			else if (readNumber (option, argv[++i], 0.0, numeric_limits<double>::infinity (), spatialArgs[2]) == false)
+				return 1;
+		}
+		else if (option == "--spatial")
+			spatialQuery = "console";
+		else if (option == "--verify")
+			verify = true;
+		else if (option == "--stats")
+			statsOutput = "table";
+		else if (option == "--stats-json" and i + 1 < argc)
+			statsOutput = argv[++i];
+		else {
+			cerr << "Invalid option '" << option << "'" << endl;
+			return 1;
+		}
+	}
+
+	if (statsOutput != "" and IngestStats::enabled == false) {
+		cerr << "--stats needs the program to be compiled with -DPOSTAL_CODE_STATS" << endl;
+		return 1;
+	}
+
+	bool filtered = stateFilter.empty () == false or countyFilter.empty () == false;
+	if ((build or findZip != -1 or buildTree or rangeLow != -1 or buildBitmap or filtered) and fileFormat != "-new" and fileFormat != "-mmap" and fileFormat != "-block") {
+		cerr << "Indexes can only be used with '-new', '-mmap' and '-block' files" << endl;
+		return 1;
+	}
+
+	if (recordNumber != -1 and fileFormat != "-new" and fileFormat != "-mmap") {
+		cerr << "Records can only be read by number from '-new' and '-mmap' files" << endl;
+		return 1;
+	}
+
+	if (verify and fileFormat != "-new" and fileFormat != "-mmap" and fileFormat != "-block") {
+		cerr << "Only '-new', '-mmap' and '-block' files can be verified" << endl;
+		return 1;
+	}
+
 	// Creates the buffer object that will be used to read the records
     if (fileFormat == "-old") {
         buff = new PostalCodeBuffer (1000);
     }
+    else if (fileFormat == "-csv") {
+        buff = new CsvPostalCodeBuffer (1000);
+    }
     else if (fileFormat == "-new") {
         buff = new NewPostalCodeBuffer (1000);
     }
+    else if (fileFormat == "-mmap") {
+        buff = new MappedPostalCodeBuffer (filename);
+    }
+    else if (fileFormat == "-block") {
+        buff = new BlockPostalCodeBuffer (1000);
+    }
     else {
-        cerr << "Invalid file format (Valid arguments are '-old' and '-new')" << endl;
+        cerr << "Invalid file format (Valid arguments are '-old', '-csv', '-new', '-mmap' and '-block')" << endl;
         return 1;
     }
 
+	if (btreeFilename == "")
+		btreeFilename = companionFilename (filename, "btree_");
+	if (bitmapFilename == "")
+		bitmapFilename = companionFilename (filename, "bitmap_");
+
+	// Reads only the records in the chosen states and counties
+	if (buildBitmap or filtered) {
+		bool success = true;
+
+		if (buildBitmap)
+			success = buildBitmaps (filename.c_str (), bitmapFilename, dynamic_cast<NewPostalCodeBuffer*> (buff));
+		if (success and filtered) {
+			success = fillTableFiltered (stateMap, filename.c_str (), bitmapFilename, stateFilter, countyFilter, buff);
+			if (success) {
+				displayHeader ();
+				displayTable (stateMap);
+				success = displayStats (statsOutput);
+			}
+		}
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
+	// Uses the B+-tree instead of reading the whole file
+	if (buildTree or rangeLow != -1) {
+		bool success = true;
+
+		if (buildTree)
+			success = buildBTree (filename.c_str (), btreeFilename, dynamic_cast<NewPostalCodeBuffer*> (buff));
+		if (success and rangeLow != -1)
+			success = printRange (filename.c_str (), btreeFilename, rangeLow, rangeHigh, buff);
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
+	// Uses the index instead of reading the whole file
+	if (build or findZip != -1) {
+		bool success = true;
+
+		if (build)
+			success = buildIndex (filename.c_str (), indexFilename, dynamic_cast<NewPostalCodeBuffer*> (buff));
+		if (success and findZip != -1)
+			success = findPostalCode (filename.c_str (), indexFilename, findZip, buff);
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
+	// Checks the file instead of reading it
+	if (verify) {
+		bool success = verifyFile (filename.c_str (), threads, dynamic_cast<NewPostalCodeBuffer*> (buff));
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
+	// Jumps straight to a single record
+	if (recordNumber != -1) {
+		bool success = printRecord (filename.c_str (), recordNumber, dynamic_cast<NewPostalCodeBuffer*> (buff));
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
+	// Loads every postal code into a spatial index and answers location queries with it
+	if (spatialQuery != "") {
+		SpatialIndex index;
+		vector<PostalCode> postalCodes;
+		bool success = true;
+
+		if (pipeline)
+			fillTablePipeline (stateMap, filename.c_str (), buff, fileFormat, threads);
+		else if (threads > 1)
+			fillTableParallel (stateMap, filename.c_str (), threads, fileFormat);
+		else
+			fillTable (stateMap, filename.c_str (), buff, fileFormat);
+
+		for (auto it = stateMap.begin (); it != stateMap.end (); ++it)
+			postalCodes.insert (postalCodes.end (), make_move_iterator (it->second.begin ()), make_move_iterator (it->second.end ()));
+		stateMap.clear ();
+
+		auto start = chrono::steady_clock::now ();
+		int indexed = index.build (move (postalCodes));
+		double ms = chrono::duration<double, milli> (chrono::steady_clock::now () - start).count ();
+		cout << "Indexed " << indexed << " postal codes in " << fixed << setprecision (1) << ms << " ms" << defaultfloat << setprecision (6) << endl;
+
+		if (spatialQuery != "console")
+			success = runSpatialQuery (index, spatialQuery, spatialArgs[0], spatialArgs[1], spatialArgs[2]);
+		else {
+			string query;
+			double lat, lng, amount;
+
+			while (cin >> query >> lat >> lng >> amount) {
+				cout << endl;
+				runSpatialQuery (index, query, lat, lng, amount);
+			}
+		}
+		if (displayStats (statsOutput) == false)
+			success = false;
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
+	// Streams the file without filling the map
+	if (streaming) {
+		map<string, StateExtremes> extremesMap;
+
+		if (threads > 1 or pipeline)
+			cerr << "Reading on one thread since --extremes is already limited by the speed of the file" << endl;
+
+		fillExtremes (extremesMap, filename.c_str (), buff);
+		displayHeader ();
+		displayExtremes (extremesMap);
+		bool success = displayStats (statsOutput);
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
+	// Fills the columns and displays the records
+	if (columnar) {
+		PostalCodeColumns columns;
+
+		if (threads > 1 or pipeline)
+			cerr << "Reading on one thread since --columnar fills a single store" << endl;
+
+		fillColumns (columns, filename.c_str (), buff);
+		displayHeader ();
+		displayColumns (columns);
+		bool success = displayStats (statsOutput);
+
+		delete buff;
+		cout << endl << endl; // CentOS formatting
+
+		return success ? 0 : 1;
+	}
+
 	// Fills the map and displays the records
-	fillTable (stateMap, filename.c_str (), buff, fileFormat);
+	if (pipeline)
+		fillTablePipeline (stateMap, filename.c_str (), buff, fileFormat, threads);
+	else if (threads > 1)
+		fillTableParallel (stateMap, filename.c_str (), threads, fileFormat);
+	else
+		fillTable (stateMap, filename.c_str (), buff, fileFormat);
 	displayHeader ();
 	displayTable (stateMap);
+	if (stringStats) {
+		cout << endl;
+		displayStringMemory (stateMap);
+	}
+	bool success = displayStats (statsOutput);
 
+	delete buff;
 	cout << endl << endl; // CentOS formatting
 	
-	return 0;
+	return success ? 0 : 1;
 }
 
-// Unpacks the buffer's contents into a postal code object
-int unpackPostalCode (PostalCode& pc, PostalCodeBuffer* buff) {
-	int result = -1;
-	char temp[256];
-	
-	// Zip code
-	result = buff->unpack (temp);
-	pc.setZipCode (atoi (temp));
-	
-	// City
-	result = buff->unpack (temp);
-	pc.setCity (temp);
-	
-	// State
-	result = buff->unpack (temp);
-	pc.setState (temp);
-	
-	// County
-	result = buff->unpack (temp);
-	pc.setCounty (temp);
-	
-	// Lat
-	result = buff->unpack (temp);
-	pc.setLat (atof (temp));
-	
-	// Long
-	result = buff->unpack (temp);
-	pc.setLong (atof (temp));
-	
-	return result;
+bool buildIndex (const char* filename, const string& indexFilename, NewPostalCodeBuffer* buffer) {
+	PostalCodeIndex index;
+	int entries = index.build (filename, indexFilename, buffer);
+
+	if (entries == -1) {
+		cerr << "Error: could not build the index: " << index.getError () << endl;
+		return false;
+	}
+
+	cout << "Number of records indexed: " << entries << endl;
+
+	return true;
 }
 
-bool fillTable (map<string, vector<PostalCode> >& stateMap, const char* filename, PostalCodeBuffer* buffer, string fileFormat) {
-	// Open the CSV data file
-    ifstream infile(filename);
-    if (!infile.is_open()) {
-        cerr << "Error: could not open input file" << endl;
-        return false;
-    }
+bool findPostalCode (const char* filename, const string& indexFilename, int zipCode, PostalCodeBuffer* buffer) {
+	ifstream infile (filename, ios::binary);
+	PostalCodeHeader header;
+	PostalCodeIndex index;
 
-    // Skip past the header in the file
-    buffer->readHeader(infile, "", "");
-	
-	int records = 0;
-	int successes = 0;
-
-    // Read the file and store PostalCode objects in the map
-    while (buffer->read(infile) != -1) {
-        records += 1;
-		
-		// Create a new PostalCode object
-        PostalCode postalCode;
-
-        // Unpack the data from the buffer and set the attributes of the PostalCode object
-		int result = unpackPostalCode (postalCode, buffer);
-        string state = postalCode.getState ();
-		
-		if (result == -1) {
-            cout << "Invalid record: " << endl;
-			//postalCode.print ();
-			continue;
-        }
-		
-        // Add the PostalCode object to the appropriate state vector in the map
-        stateMap[state].push_back(postalCode);
-		
-		successes += 1;
-    }
-	
-	cout << "Number of records read: " << records << endl;
-	cout << "Number of valid records read: " << successes << endl;
+	// The header names the index file and describes its layout and the buffer learns the field encoding from it
+	if (!infile.is_open () or header.readHeader (infile) == -1 or buffer->readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1) {
+		cerr << "Error: could not read the header of the input file" << endl;
+		return false;
+	}
 
-	if (successes <= 0)
-		cout << "No records were read... Make sure you selected the correct file format and that the file isn't corrupt" << endl;
+	// The index named in the header is next to the DAT file
+	string name = indexFilename == "" ? PostalCodeIndex::locate (filename, header.getIndexFilename ()) : indexFilename;
+	if (index.setSchema (header.getIndexSchema ()) == false) {
+		cerr << "Error: the index schema '" << header.getIndexSchema () << "' isn't supported" << endl;
+		return false;
+	}
+	if (index.open (name) == false) {
+		cerr << "Error: could not open index file: " << index.getError () << ". Try running with --build-index first" << endl;
+		return false;
+	}
+
+	long long recaddr = index.find (zipCode);
+	if (recaddr == -1) {
+		cout << "Zip code " << zipCode << " was not found" << endl;
+		return false;
+	}
+
+	// Reads only the matching record
+	PostalCode postalCode;
+	if (buffer->dRead (infile, recaddr) == -1 or unpackPostalCode (postalCode, buffer) == -1) {
+		cerr << "Error: could not read the record at offset " << recaddr << endl;
+		return false;
+	}
+
+	postalCode.print ();
 
-    // Close the input file
-    infile.close();
-	
 	return true;
 }
 
-void displayHeader () {
-	// Print the table header
-    cout << left << setw(12) << "State ID";
-	cout << left << setw(15) << "Easternmost";
-	cout << left << setw(15) << "Westernmost";
-	cout << left << setw(15) << "Northernmost";
-	cout << left << setw(15) << "Southernmost";
-	cout << endl;
-	
-	return;
+bool buildBTree (const char* filename, const string& btreeFilename, NewPostalCodeBuffer* buffer) {
+	PostalCodeBTree tree;
+	long long entries = tree.build (filename, btreeFilename, buffer);
+
+	if (entries == -1) {
+		cerr << "Error: could not build the B+-tree" << endl;
+		return false;
+	}
+
+	cout << "Number of records in the B+-tree: " << entries << endl;
+	cout << "Height of the B+-tree: " << tree.getHeight () << endl;
+
+	return true;
 }
 
-void displayTable (const map<string, vector<PostalCode> >& stateMap) {
-	// Iterate over the stateMap and print the data for each state
-	// This will display the map in the correct order
-    for (auto it = stateMap.begin(); it != stateMap.end(); ++it) {
-        // Get the state ID and vector of PostalCode objects for this state
-        string stateId = it->first;
-        vector<PostalCode> postalCodes = it->second;
-
-        // Sort the PostalCode objects by latitude
-        sort(postalCodes.begin(), postalCodes.end(), [](const PostalCode& a, const PostalCode& b) {
-            if (a.getLat() == b.getLat()) {
-                return a.getZipCode() < b.getZipCode(); // Sort by zip code if latitude is the same
-            }
-            return a.getLat() > b.getLat(); // Sort by latitude
-        });
-
-        PostalCode northernmost = postalCodes.front();
-        PostalCode southernmost = postalCodes.back();
-
-		// Sort the PostalCode objects by longitude
-        sort(postalCodes.begin(), postalCodes.end(), [](const PostalCode& a, const PostalCode& b) {
-            if (a.getLong() == b.getLong()) {
-                return a.getZipCode() < b.getZipCode(); // Sort by zip code if longitude is the same
-            }
-            return a.getLong() < b.getLong(); // Sort by longitude
-        });
-
-        PostalCode easternmost = postalCodes.front();
-        PostalCode westernmost = postalCodes.back();
-
-        // Print the data for this state
-		cout << left << setw(12) << stateId;
-		cout << left << setw(15) << easternmost.getZipCode();
-		cout << left << setw(15) << westernmost.getZipCode();
-		cout << left << setw(15) << northernmost.getZipCode();
-		cout << left << setw(15) << southernmost.getZipCode();
-		cout << endl;
-    }
-	
-	return;
+bool printRange (const char* filename, const string& btreeFilename, int low, int high, PostalCodeBuffer* buffer) {
+	ifstream infile (filename, ios::binary);
+	PostalCodeHeader header;
+	PostalCodeBTree tree;
+	vector<pair<int, long long> > entries;
+
+	// The buffer learns the field encoding from the header
+	if (!infile.is_open () or header.readHeader (infile) == -1 or buffer->readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1) {
+		cerr << "Error: could not read the header of the input file" << endl;
+		return false;
+	}
+
+	if (tree.open (btreeFilename) == false) {
+		cerr << "Error: could not open B+-tree file '" << btreeFilename << "'. Try running with --build-btree first" << endl;
+		return false;
+	}
+
+	if (tree.range (low, high, entries) == -1) {
+		cerr << "Error: could not read the B+-tree" << endl;
+		return false;
+	}
+
+	// Reads only the matching records
+	for (size_t i = 0; i < entries.size (); ++i) {
+		PostalCode postalCode;
+
+		if (buffer->dRead (infile, entries[i].second) == -1 or unpackPostalCode (postalCode, buffer) == -1) {
+			cerr << "Error: could not read the record at offset " << entries[i].second << endl;
+			return false;
+		}
+
+		postalCode.print ();
+	}
+
+	cout << "Found " << entries.size () << " postal codes by reading " << tree.getPageReads () << " B+-tree pages" << endl;
+
+	return true;
+}
+
+bool buildBitmaps (const char* filename, const string& bitmapFilename, NewPostalCodeBuffer* buffer) {
+	BitmapIndex index;
+	long long records = index.build (filename, bitmapFilename, buffer);
+
+	if (records == -1) {
+		cerr << "Error: could not build the bitmap indexes" << endl;
+		return false;
+	}
+
+	cout << "Number of records in the bitmap indexes: " << records << endl;
+
+	return true;
+}
+
+bool fillTableFiltered (map<string, vector<PostalCode> >& stateMap, const char* filename, const string& bitmapFilename, const vector<string>& states, const vector<string>& counties, PostalCodeBuffer* buffer) {
+	ifstream infile (filename, ios::binary);
+	PostalCodeHeader header;
+	BitmapIndex index;
+
+	// The buffer learns the field encoding from the header
+	if (!infile.is_open () or header.readHeader (infile) == -1 or buffer->readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1) {
+		cerr << "Error: could not read the header of the input file" << endl;
+		return false;
+	}
+
+	if (index.open (bitmapFilename) == false) {
+		cerr << "Error: could not open bitmap index file '" << bitmapFilename << "'. Try running with --build-bitmap first" << endl;
+		return false;
+	}
+
+	// Any of the states and any of the counties
+	RoaringBitmap matches;
+	if (states.empty ())
+		matches = index.findCounties (counties);
+	else if (counties.empty ())
+		matches = index.findStates (states);
+	else
+		matches = index.findStates (states).intersection (index.findCounties (counties));
+
+	// The records are read in file order, since the record numbers are
+	vector<unsigned int> records = matches.toVector ();
+	for (size_t i = 0; i < records.size (); ++i) {
+		long long recaddr = index.getRecordAddress (records[i]);
+		PostalCode postalCode;
+
+		if (recaddr == -1 or buffer->dRead (infile, recaddr) == -1 or unpackPostalCode (postalCode, buffer) == -1) {
+			cerr << "Error: could not read record " << records[i] << endl;
+			return false;
+		}
+
+		stateMap[string (postalCode.getState ())].push_back (postalCode);
+	}
+
+	cout << "Number of records read: " << records.size () << " of " << index.size () << endl << endl;
+	STATS_COUNT (statsRecordsRead, records.size ());
+
+	return true;
+}
+
+string companionFilename (const string& filename, const string& prefix) {
+	size_t slash = filename.find_last_of ('/');
+	size_t nameStart = slash == string::npos ? 0 : slash + 1;
+
+	return filename.substr (0, nameStart) + prefix + filename.substr (nameStart);
+}
+
+bool readNumber (const string& option, const char* text, long long low, long long high, long long& value) {
+	long long number;
+
+	// atoll would read "abc" as 0 and "12abc" as 12, so the whole argument has to be the number
+	if (parseWhole (text, number) == false or number < low or number > high) {
+		cerr << "Invalid number '" << text << "' for " << option << ". Expected a whole number ";
+		if (high == LLONG_MAX or high == INT_MAX)
+			cerr << "of at least " << low << endl;
+		else
+			cerr << "from " << low << " to " << high << endl;
+		return false;
+	}
+
+	value = number;
+
+	return true;
+}
+
+bool readNumber (const string& option, const char* text, int low, int high, int& value) {
+	long long number;
+
+	if (readNumber (option, text, (long long)low, (long long)high, number) == false)
+		return false;
+
+	value = number;
+
+	return true;
+}
+
+bool readNumber (const string& option, const char* text, double low, double high, double& value) {
+	double number;
+
+	if (parseWhole (text, number) == false or number < low or number > high) {
+		cerr << "Invalid number '" << text << "' for " << option << ". Expected a number ";
+		if (isinf (high))
+			cerr << "of at least " << low << endl;
+		else
+			cerr << "from " << low << " to " << high << endl;
+		return false;
+	}
+
+	value = number;
+
+	return true;
+}
+
+vector<string> splitList (const string& list) {
+	vector<string> values;
+	size_t start = 0;
+
+	while (start <= list.size ()) {
+		size_t comma = list.find (',', start);
+		if (comma == string::npos)
+			comma = list.size ();
+
+		if (comma > start)
+			values.push_back (list.substr (start, comma - start));
+		start = comma + 1;
+	}
+
+	return values;
+}
+
+bool printRecord (const char* filename, long long recordNumber, NewPostalCodeBuffer* buffer) {
+	ifstream infile (filename, ios::binary);
+	PostalCodeHeader header;
+
+	// The buffer learns the record layout from the header
+	if (!infile.is_open () or header.readHeader (infile) == -1 or buffer->readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1) {
+		cerr << "Error: could not read the header of the input file" << endl;
+		return false;
+	}
+
+	if (buffer->isFixed () == false) {
+		cerr << "Error: records can only be read by number from fixed-length files" << endl;
+		return false;
+	}
+
+	PostalCode postalCode;
+	if (buffer->readRecord (infile, recordNumber) == -1 or unpackPostalCode (postalCode, buffer) == -1) {
+		cerr << "Error: could not read record " << recordNumber << endl;
+		return false;
+	}
+
+	postalCode.print ();
+
+	return true;
+}
+
+bool verifyFile (const char* filename, int threads, NewPostalCodeBuffer* buffer) {
+	ifstream infile (filename, ios::binary);
+	PostalCodeHeader header;
+	MappedFile file (filename);
+
+	// The buffer reads the checksums along with the header
+	if (!infile.is_open () or !file.isOpen () or header.readHeader (infile) == -1 or buffer->readHeader (infile, header.getIndexFilename (), header.getIndexSchema ()) == -1) {
+		cerr << "Error: could not read the header of the input file" << endl;
+		return false;
+	}
+
+	const ChecksumDirectory& checksums = buffer->getChecksums ();
+	auto start = chrono::steady_clock::now ();
+	int damaged = 0;
+	long long lost = 0;
+
+	if (checksums.getDataEnd () != -1) {
+		// Each thread checks a contiguous range of blocks
+		vector<char> valid (checksums.size (), 1);
+		vector<thread> workers;
+		for (int t = 0; t < threads; ++t) {
+			workers.push_back (thread ([&, t] () {
+				for (int b = checksums.size () * (long long)t / threads; b < checksums.size () * (long long)(t + 1) / threads; ++b)
+					valid[b] = checksums.verify (file.data (), b);
+			}));
+		}
+		for (int t = 0; t < threads; ++t)
+			workers[t].join ();
+
+		for (int b = 0; b < checksums.size (); ++b) {
+			if (valid[b] == false) {
+				cout << "Damaged block " << b << " at byte " << checksums.getEntry (b).offset << ": " << checksums.getEntry (b).records << " records" << endl;
+				damaged += 1;
+				lost += checksums.getEntry (b).records;
+			}
+		}
+
+		double ms = chrono::duration<double, milli> (chrono::steady_clock::now () - start).count ();
+		cout << "Number of blocks checked: " << checksums.size () << endl;
+		cout << "Number of damaged blocks: " << damaged << " (" << lost << " records)" << endl;
+		long long bytes = checksums.empty () ? 0 : checksums.getDataEnd () - checksums.getEntry (0).offset;
+		cout << "Checked " << bytes << " bytes in " << fixed << setprecision (2) << ms << " ms on " << threads
+			<< " threads with the " << getCrc32cKernel () << " CRC-32C kernel" << defaultfloat << setprecision (6) << endl;
+	}
+	else {
+		// Without checksums, damage can only be found by records that don't make sense
+		unsigned int headerSize;
+		int prefix = PostalCodeHeader::decodeHeaderLength (file.data (), file.size (), headerSize);
+		size_t position = prefix == -1 ? file.size () : prefix + headerSize;
+		size_t end;
+
+		MappedPostalCodeBuffer scanner (file.data (), position, file.size ());
+		scanner.setVersion (buffer->getVersion ());
+		scanner.setBinary (buffer->isBinary ());
+		scanner.setFixed (buffer->isFixed ());
+
+		long long records = 0;
+		while (position < file.size ()) {
+			if (scanner.isValidRecord (position, end)) {
+				records += 1;
+				position = end;
+				continue;
+			}
+
+			long long next = scanner.resync (position + 1);
+			end = next == -1 ? file.size () : next;
+			cout << "Damaged bytes " << position << " to " << end << endl;
+			damaged += 1;
+			lost += end - position;
+			position = end;
+		}
+
+		double ms = chrono::duration<double, milli> (chrono::steady_clock::now () - start).count ();
+		cout << "The file has no checksums, so its records were scanned instead" << endl;
+		cout << "Number of valid records: " << records << endl;
+		cout << "Number of damaged ranges: " << damaged << " (" << lost << " bytes)" << endl;
+		cout << "Scanned " << file.size () << " bytes in " << fixed << setprecision (2) << ms << " ms" << defaultfloat << setprecision (6) << endl;
+	}
+
+	return damaged == 0;
+}
+
+bool runSpatialQuery (const SpatialIndex& index, const string& query, double lat, double lng, double amount) {
+	vector<SpatialMatch> matches;
+
+	if (lat < -90 or lat > 90 or amount < 0 or (query != "nearest" and query != "radius") or (query == "nearest" and (amount != floor (amount) or amount > INT_MAX))) {
+		cerr << "Invalid query '" << query << " " << lat << " " << lng << " " << amount << "'" << endl;
+		return false;
+	}
+
+	auto start = chrono::steady_clock::now ();
+	if (query == "nearest")
+		matches = index.nearest (lat, lng, amount);
+	else
+		matches = index.withinRadius (lat, lng, amount);
+	double us = chrono::duration<double, micro> (chrono::steady_clock::now () - start).count ();
+
+	streamsize precision = cout.precision ();
+	cout << "Found " << matches.size () << " postal codes in " << fixed << setprecision (1) << us << " us" << defaultfloat << setprecision (precision) << endl;
+	for (size_t i = 0; i < matches.size (); ++i) {
+		cout << fixed << setprecision (2) << setw (10) << matches[i].distance << " km  " << defaultfloat << setprecision (precision);
+		index.getPostalCode (matches[i].index).print ();
+	}
+
+	return true;
 }
+
+bool displayStats (const string& statsOutput) {
+	if (statsOutput == "")
+		return true;
+
+	if (statsOutput == "table") {
+		cout << endl;
+		IngestStats::display (cout);
+	}
+	else if (statsOutput == "-") {
+		cout << endl;
+		IngestStats::writeJson (cout);
+	}
+	else {
+		ofstream outfile (statsOutput);
+		IngestStats::writeJson (outfile);
+
+		if (!outfile.good ()) {
+			cerr << "Error: could not write statistics file '" << statsOutput << "'" << endl;
+			return false;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
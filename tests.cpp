@@ -0,0 +1,217 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cmath>
+#include <thread>
+#include "StateTable.h"
+#include "NewPostalCodeBuffer.h"
+#include "MappedPostalCodeBuffer.h"
+#include "PostalCode.h"
+#include "StringPool.h"
+
+using namespace std;
+
+// Checks that the ways of reading a postal code file agree with each other
+// Every check is run on the files in 'Test Files', or in the directory given as the first argument
+// The program prints each check that fails and exits with 1 if any of them did
+
+int failures = 0; //!< The number of checks that failed
+int checks = 0; //!< The number of checks that were run
+
+/** Records the result of a check and prints it if it failed
+ * @param passed: true if the check passed
+ * @param name: what was checked
+ * @post: counts the check, and the failure if it failed */
+void check (bool passed, const string& name) {
+	checks += 1;
+
+	if (passed == false) {
+		failures += 1;
+		cout << "FAILED: " << name << endl;
+	}
+}
+
+/** Writes every postal code of a state map as text, in the order the map holds them
+ * @param stateMap: the postal codes to write
+ * @return: returns one line for each postal code */
+string describeTable (const map<string, vector<PostalCode> >& stateMap) {
+	stringstream ss;
+
+	for (auto it = stateMap.begin (); it != stateMap.end (); ++it)
+		for (const PostalCode& pc : it->second)
+			ss << it->first << ": " << pc.getZipCode () << ", " << pc.getCity () << ", " << pc.getState () << ", " << pc.getCounty () << ", " << pc.getLat () << ", " << pc.getLong () << endl;
+
+	return ss.str ();
+}
+
+/** Fills a state map with fillTable, or with fillTableParallel when threads is more than 1
+ * @param filename: the name of the file to read
+ * @param fileFormat: '-new' or '-mmap'
+ * @param threads: the number of threads to read the file with
+ * @param table: set to the postal codes that were read, written by describeTable
+ * @return: returns everything the read wrote to the console and to the error stream */
+string readTable (const string& filename, const string& fileFormat, int threads, string& table) {
+	map<string, vector<PostalCode> > stateMap;
+	stringstream output;
+	streambuf* coutBuffer = cout.rdbuf (output.rdbuf ());
+	streambuf* cerrBuffer = cerr.rdbuf (output.rdbuf ());
+
+	if (threads > 1)
+		fillTableParallel (stateMap, filename.c_str (), threads, fileFormat);
+	else if (fileFormat == "-mmap") {
+		MappedPostalCodeBuffer buffer (filename.c_str ());
+		fillTable (stateMap, filename.c_str (), &buffer, fileFormat);
+	}
+	else {
+		NewPostalCodeBuffer buffer;
+		fillTable (stateMap, filename.c_str (), &buffer, fileFormat);
+	}
+
+	cout.rdbuf (coutBuffer);
+	cerr.rdbuf (cerrBuffer);
+	table = describeTable (stateMap);
+
+	return output.str ();
+}
+
+/** Checks that reading a file on several threads gives the same output and postal codes as reading it on one
+ * @param filename: the name of the file to read
+ * @post: runs a check for each format and thread count */
+void testParallelMatchesSerial (const string& filename) {
+	const char* formats[] = {"-new", "-mmap"};
+
+	for (const char* fileFormat : formats) {
+		string serialTable;
+		string serialOutput = readTable (filename, fileFormat, 1, serialTable);
+
+		for (int threads = 2; threads <= 4; ++threads) {
+			string table;
+			string output = readTable (filename, fileFormat, threads, table);
+			string name = filename + " " + fileFormat + " -j " + to_string (threads);
+
+			check (output == serialOutput, name + " prints the same output as the serial reader");
+			check (table == serialTable, name + " reads the same postal codes as the serial reader");
+		}
+	}
+}
+
+/** Checks that a buffer's record unpacks into the postal code it was packed from
+ * @param buff: the buffer holding the record, which is used through the base class like the readers use it
+ * @param expected: the postal code the record was packed from
+ * @param name: the kind of record
+ * @post: runs a check on every field */
+void checkUnpackRecord (PostalCodeBuffer* buff, const PostalCode& expected, const string& name) {
+	string_view city, state, county;
+	int zipCode = 0;
+	double lat = 0, lng = 0;
+
+	check (buff->unpackRecord (zipCode, city, state, county, lat, lng) != -1, name + " record unpacks");
+	check (zipCode == expected.getZipCode (), name + " record unpacks the zip code");
+	check (city == expected.getCity () and state == expected.getState () and county == expected.getCounty (), name + " record unpacks the city, state and county");
+	check (abs (lat - expected.getLat ()) < 1e-6 and abs (lng - expected.getLong ()) < 1e-6, name + " record unpacks the coordinates");
+}
+
+/** Checks that unpackRecord gets all six fields of text, binary, fixed-length and CSV records
+ * @post: runs a check on every field of each kind of record */
+void testUnpackRecord () {
+	PostalCode expected;
+	expected.setZipCode (501);
+	expected.setCity ("Holtsville");
+	expected.setState ("NY");
+	expected.setCounty ("Suffolk");
+	expected.setLat (40.8154);
+	expected.setLong (-73.0451);
+
+	// Each DAT record is packed and written by one buffer, then read back by another with the same layout
+	const char* layouts[] = {"text", "binary", "fixed-length"};
+	for (int layout = 0; layout < 3; ++layout) {
+		NewPostalCodeBuffer writer, reader;
+		stringstream file;
+		writer.setBinary (layout > 0);
+		writer.setFixed (layout == 2);
+		reader.setBinary (layout > 0);
+		reader.setFixed (layout == 2);
+
+		packPostalCode (expected, &writer);
+		writer.write (file);
+		check (reader.read (file) == 0, string (layouts[layout]) + " record is read");
+		checkUnpackRecord (&reader, expected, layouts[layout]);
+	}
+
+	// The old buffer's records are CSV lines
+	PostalCodeBuffer csv;
+	stringstream file ("501,Holtsville,NY,Suffolk,40.8154,-73.0451\n");
+	check (csv.read (file) != -1, "CSV record is read");
+	checkUnpackRecord (&csv, expected, "CSV");
+}
+
+/** Checks that postal codes read their strings from the pool they were filled from, whichever pool is current
+ * @post: runs a check for each way the postal code is read */
+void testPostalCodePool () {
+	unique_ptr<StringPool> pool = PostalCode::createPool ();
+	StringPool* previous = StringPool::setCurrent (pool.get ());
+	PostalCode postalCode;
+	postalCode.setCity ("Holtsville");
+	postalCode.setState ("NY");
+	postalCode.setCounty ("Suffolk");
+	StringPool::setCurrent (previous);
+
+	check (postalCode.getCity () == "Holtsville" and postalCode.getState () == "NY", "postal code reads its own pool after the current pool changes");
+
+	string_view county;
+	thread reader ([&] () { county = postalCode.getCounty (); });
+	reader.join ();
+	check (county == "Suffolk", "postal code reads its own pool on another thread");
+
+	// After a merge the strings come from the global pool, so the thread's pool can be freed
+	vector<unsigned int> ids;
+	StringPool::global ().merge (*pool, ids);
+	postalCode.moveStrings (ids, StringPool::global ());
+	pool.reset ();
+	check (postalCode.getCity () == "Holtsville" and postalCode.getCounty () == "Suffolk", "postal code reads the global pool after moveStrings");
+}
+
+/** Checks that one thread can read a pool's strings while another adds them
+ * @post: runs a check on every string that was read */
+void testStringPoolConcurrency () {
+	const unsigned int strings = 200000;
+	StringPool pool;
+	bool matched = true;
+
+	// Every string is its own ID, so the reader can tell if it got the wrong view
+	thread writer ([&] () {
+		for (unsigned int i = 0; i < strings; ++i)
+			pool.intern (to_string (i));
+	});
+
+	for (size_t seen = 0; seen < strings; ) {
+		size_t count = pool.size ();
+
+		for (; seen < count; ++seen)
+			matched = matched and pool.get (seen) == to_string (seen);
+	}
+	writer.join ();
+
+	check (matched, "strings read while another thread interns them are complete");
+	check (pool.size () == strings, "every string interned by another thread is counted");
+}
+
+int main (int argc, char* argv[]) {
+	string directory = argc > 1 ? argv[1] : "Test Files";
+
+	// The damaged header has to be rejected by every reader, instead of being split and read with the wrong layout
+	testParallelMatchesSerial (directory + "/broke_postal_codes.dat");
+	testParallelMatchesSerial (directory + "/new_postal_codes.dat");
+	testParallelMatchesSerial (directory + "/new_postal_codes_random.dat");
+
+	testUnpackRecord ();
+	testPostalCodePool ();
+	testStringPoolConcurrency ();
+
+	cout << checks - failures << " of " << checks << " checks passed" << endl;
+
+	return failures == 0 ? 0 : 1;
+}